@@ -1,61 +1,62 @@
 #include "Auth.h"
 #include "config.h"  // Contains SUPABASE_HOST, SUPABASE_ANON_KEY
-#include <windows.h>
-#include <winhttp.h>
+#include "net/HttpClient.h"
+#include "net/Supabase.h"
+#include "util/json.hpp"
 #include <string>
 #include <sstream>
 
 // Supabase auth endpoint
-static const wchar_t* SUPABASE_PATH = L"/auth/v1/token?grant_type=password";
+static const char* SUPABASE_PATH = "/auth/v1/token?grant_type=password";
 
 // Static member für JWT Token
+std::mutex Auth::s_tokenMutex;
 std::string Auth::s_accessToken;
 
+// Helper: Base64url (ohne Padding) dekodieren, wie im JWT verwendet
+static bool DecodeBase64Url(const std::string& input, std::string& output) {
+    output.clear();
+    unsigned int buffer = 0;
+    int bits = 0;
+    for (char c : input) {
+        int value;
+        if (c >= 'A' && c <= 'Z') value = c - 'A';
+        else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+        else if (c >= '0' && c <= '9') value = c - '0' + 52;
+        else if (c == '-' || c == '+') value = 62;
+        else if (c == '_' || c == '/') value = 63;
+        else if (c == '=') break;
+        else return false;
+
+        buffer = (buffer << 6) | (unsigned int)value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            output += (char)((buffer >> bits) & 0xFF);
+        }
+    }
+    return true;
+}
+
 bool Auth::Login(const std::string& email, const std::string& password, std::string& userName, std::string* lastError) {
     // JSON-Body vorbereiten
     std::ostringstream oss;
     oss << "{\"email\":\"" << email << "\",\"password\":\"" << password << "\"}";
     std::string body = oss.str();
 
-    // WinHTTP Session
-    HINTERNET hSession = WinHttpOpen(L"DegixDAW-VST/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, NULL, NULL, 0);
-        if (!hSession) { if (lastError) *lastError = "WinHttpOpen fehlgeschlagen"; return false; }
-    HINTERNET hConnect = WinHttpConnect(hSession, SUPABASE_HOST, INTERNET_DEFAULT_HTTPS_PORT, 0);
-        if (!hConnect) { if (lastError) *lastError = "WinHttpConnect fehlgeschlagen"; WinHttpCloseHandle(hSession); return false; }
-    HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"POST", SUPABASE_PATH, NULL, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, WINHTTP_FLAG_SECURE);
-        if (!hRequest) { if (lastError) *lastError = "WinHttpOpenRequest fehlgeschlagen"; WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false; }
-
-    // Header setzen
-    std::wstring headers = L"Content-Type: application/json\r\napikey: ";
-    headers += std::wstring(SUPABASE_ANON_KEY, SUPABASE_ANON_KEY + strlen(SUPABASE_ANON_KEY));
-
-    BOOL bResults = WinHttpSendRequest(
-        hRequest,
-        headers.c_str(), (DWORD)headers.length(),
-        (LPVOID)body.c_str(), (DWORD)body.size(), (DWORD)body.size(), 0);
-        if (!bResults) {
-            if (lastError) *lastError = "WinHttpSendRequest fehlgeschlagen";
-            WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false;
-        }
-    bResults = WinHttpReceiveResponse(hRequest, NULL);
-        if (!bResults) {
-            if (lastError) *lastError = "WinHttpReceiveResponse fehlgeschlagen";
-            WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false;
-        }
+    // Request über den gemeinsamen HTTP-Client (Keep-Alive Verbindung)
+    net::HttpRequest request;
+    request.method = "POST";
+    request.url = net::SupabaseUrl(SUPABASE_PATH);
+    request.headers.push_back({ "Content-Type", "application/json" });
+    request.headers.push_back({ "apikey", SUPABASE_ANON_KEY });
+    request.body = body;
 
-    // Antwort lesen
-    DWORD dwSize = 0;
-    std::string response;
-    do {
-        DWORD dwDownloaded = 0;
-        if (!WinHttpQueryDataAvailable(hRequest, &dwSize)) break;
-        if (dwSize == 0) break;
-        std::string buf(dwSize, 0);
-        if (!WinHttpReadData(hRequest, &buf[0], dwSize, &dwDownloaded)) break;
-        response.append(buf, 0, dwDownloaded);
-    } while (dwSize > 0);
-
-    WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession);
+    net::HttpResponse httpResponse;
+    if (!net::HttpClient::Instance().Send(request, httpResponse, lastError)) {
+        return false;
+    }
+    const std::string& response = httpResponse.body;
 
     // Erfolg prüfen und access_token extrahieren
     size_t tokenPos = response.find("\"access_token\":\"");
@@ -63,7 +64,7 @@ bool Auth::Login(const std::string& email, const std::string& password, std::str
         tokenPos += 16; // Nach "access_token":" springen
         size_t tokenEnd = response.find("\"", tokenPos);
         if (tokenEnd != std::string::npos) {
-            s_accessToken = response.substr(tokenPos, tokenEnd - tokenPos);
+            SetAccessToken(response.substr(tokenPos, tokenEnd - tokenPos));
         }
         userName = email; // Optional: Usernamen extrahieren
         return true;
@@ -73,9 +74,33 @@ bool Auth::Login(const std::string& email, const std::string& password, std::str
 }
 
 void Auth::SetAccessToken(const std::string& token) {
+    std::lock_guard<std::mutex> lock(s_tokenMutex);
     s_accessToken = token;
 }
 
 std::string Auth::GetAccessToken() {
+    std::lock_guard<std::mutex> lock(s_tokenMutex);
     return s_accessToken;
 }
+
+std::string Auth::GetUserId() {
+    // JWT: header.payload.signature - Signatur prüft der Server, hier nur lesen.
+    // Auf einer Kopie dekodieren, damit ein paralleles SetAccessToken nicht stört.
+    std::string token = GetAccessToken();
+    size_t first = token.find('.');
+    if (first == std::string::npos) return "";
+    size_t second = token.find('.', first + 1);
+    if (second == std::string::npos) return "";
+
+    std::string payload;
+    if (!DecodeBase64Url(token.substr(first + 1, second - first - 1), payload)) return "";
+
+    try {
+        auto j = nlohmann::json::parse(payload);
+        if (j.contains("sub") && j["sub"].is_string()) {
+            return j["sub"].get<std::string>();
+        }
+    } catch (const std::exception&) {
+    }
+    return "";
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <mutex>
 #include <string>
 
 class Auth {
@@ -6,10 +7,14 @@ public:
     // lastError ist optional (nullptr erlaubt)
     static bool Login(const std::string& email, const std::string& password, std::string& userName, std::string* lastError = nullptr);
     
-    // JWT Token Management
+    // JWT Token Management (thread-safe: Worker-Pools lesen, der UI-Thread schreibt)
     static void SetAccessToken(const std::string& token);
     static std::string GetAccessToken();
+
+    // User-ID ("sub"-Claim) aus dem JWT, leer ohne gültigen Token
+    static std::string GetUserId();
     
 private:
-    static std::string s_accessToken;
+    static std::mutex s_tokenMutex;
+    static std::string s_accessToken;   // Geschützt durch s_tokenMutex
 };
@@ -1,17 +1,32 @@
 #include "FileBrowser.h"
+#include "ScaledJpeg.h"
+#include "WicSupport.h"
 #include "storagedata.h"
 #include "../auth/Auth.h"
+#include "../net/HttpClient.h"
+#include "../storage/DiskCache.h"
+#include "../storage/FileDownloader.h"
+#include "../storage/ListingSync.h"
+#include "../storage/PendingDownloads.h"
+#include "../storage/SignedUrlCache.h"
+#include "../util/ImageResample.h"
+#include "../util/ThreadPool.h"
 #include <commctrl.h>
+#include <commdlg.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_set>
 #include <vector>
 #include <string>
 #include <fstream>
 #include <algorithm>
-#include <winhttp.h>
 #include <gdiplus.h>
 #include <objbase.h>
 
 #pragma comment(lib, "gdiplus.lib")
-#pragma comment(lib, "winhttp.lib")
+#pragma comment(lib, "comdlg32.lib")
 
 using namespace Gdiplus;
 
@@ -43,10 +58,183 @@ static std::wstring Utf8ToUtf16(const std::string& utf8) {
     return L"[Konvertierungsfehler]";
 }
 
+// Worker -> UI: neue Seite oder Listing fertig (wParam = Generation)
+static const UINT WM_APP_FILES_LOADED = WM_APP + 1;
+// Worker -> Preview: Thumbnail oder Original geladen (wParam = Generation)
+static const UINT WM_APP_PREVIEW_LOADED = WM_APP + 2;
+// Worker -> Preview: ein Vorausladen ist fertig
+static const UINT WM_APP_PREFETCHED = WM_APP + 3;
+// Download-Worker -> UI: Fortschritt (wParam = Prozent) bzw. fertig
+static const UINT WM_APP_DOWNLOAD_PROGRESS = WM_APP + 4;
+static const UINT WM_APP_DOWNLOAD_DONE = WM_APP + 5;
+
+// Vorausladen: beim zügigen Blättern (kurze Verweildauer) weiter vorausschauen
+static const int PREFETCH_AHEAD = 2;
+static const int PREFETCH_AHEAD_FAST = 4;
+static const std::chrono::milliseconds FAST_BROWSE_DWELL(400);
+
+// Zustand eines Vorschau-Ladevorgangs; der Worker füllt, der UI-Thread übernimmt
+struct FileBrowser::PreviewJob {
+    std::string fullPath;
+    std::string thumbnailPath;                   // Leer: direkt das Original laden
+    std::string detailsId;                       // Gesetzt: erst die vollständige Zeile nachladen
+    std::atomic<bool> cancelled{false};          // Auswahl gewechselt: nichts mehr laden
+    std::mutex mutex;
+    std::shared_ptr<Gdiplus::Bitmap> thumbnail;  // Geschützt durch mutex
+    std::shared_ptr<Gdiplus::Bitmap> full;
+    storagedata::FileInfo details;
+    bool hasDetails = false;
+    bool done = false;
+    unsigned generation = 0;
+    HWND target = nullptr;
+    int panelWidth = 0;
+    int panelHeight = 0;
+
+    // Download im PreviewPool, Dekodieren im DecodePool; jeder Schritt prüft
+    // cancelled, eine abgelöste Auswahl dekodiert also nichts mehr
+    static void Start(const std::shared_ptr<PreviewJob>& job);
+    static void FetchDetails(const std::shared_ptr<PreviewJob>& job);
+    static void FetchFull(const std::shared_ptr<PreviewJob>& job);
+    void Publish(std::shared_ptr<Gdiplus::Bitmap> decodedThumbnail, std::shared_ptr<Gdiplus::Bitmap> decodedFull, bool finished);
+};
+
+// Vorausgeladene Nachbar-Vorschau. Nur ein noch wartendes Vorausladen wird bei
+// Auswahl des Bildes verworfen, ein laufendes wird übernommen (kein zweiter Download).
+// Schlanke Zeilen (ohne Storage-Pfad) lädt der Worker vorher vollständig nach.
+struct FileBrowser::PrefetchItem {
+    enum State { QUEUED, RUNNING, CANCELLED };
+    std::string id;
+    std::string path;                            // Leer: Details fehlen noch
+    size_t row = AttachmentIndex::NOT_FOUND;     // Zeile in index_ beim Einplanen (Hinweis für Find)
+    std::atomic<int> state{QUEUED};
+    std::mutex mutex;
+    std::shared_ptr<Gdiplus::Bitmap> image;      // Geschützt durch mutex
+    storagedata::FileInfo details;               // Nachgeladene Zeile (hasDetails)
+    bool hasDetails = false;
+    bool done = false;
+
+    void Finish(std::shared_ptr<Gdiplus::Bitmap> decoded, HWND target) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            image = decoded;
+            done = true;
+        }
+        PostMessage(target, WM_APP_PREFETCHED, 0, 0);
+    }
+};
+
+// "Speichern unter..." im Hintergrund; der Worker meldet nur Prozentsprünge
+struct FileBrowser::DownloadJob {
+    std::string fileId;
+    std::string storagePath;                     // Leer: Worker lädt erst die Details (-> details)
+    storagedata::FileInfo details;               // Nachgeladene Zeile für index_ (hasDetails)
+    bool hasDetails = false;
+    std::wstring target;
+    std::wstring savedTitle;                     // Titel des Hauptfensters vor dem Download
+    std::atomic<bool> cancelled{false};          // FileBrowser zerstört: Download abbrechen
+    std::atomic<int> percent{-1};
+    bool ok = false;                             // Gesetzt vor WM_APP_DOWNLOAD_DONE
+    std::string error;
+};
+
+// Worker für Vorschauen (nie zerstört, wie der Listing-Pool): zwei Threads,
+// damit ein langsamer abgelöster Download die neue Auswahl nicht blockiert
+static ThreadPool& PreviewPool() {
+    static ThreadPool* pool = new ThreadPool(2);
+    return *pool;
+}
+
+// Dekodieren getrennt von den Downloads: ein hängender Download hält keine
+// Dekodierung auf, und der UI-Thread dekodiert nie selbst
+static ThreadPool& DecodePool() {
+    static ThreadPool* pool = new ThreadPool(2);
+    return *pool;
+}
+
+// Große Downloads blockieren weder Vorschau noch Dekodierung
+static ThreadPool& DownloadPool() {
+    static ThreadPool* pool = new ThreadPool(1);
+    return *pool;
+}
+
+// Reicht das Bild für das Panel? (Einpassen würde nicht vergrößern)
+static bool CoversPanel(Gdiplus::Bitmap& image, int panelWidth, int panelHeight) {
+    return (int)image.GetWidth() >= panelWidth || (int)image.GetHeight() >= panelHeight;
+}
+
+void FileBrowser::PreviewJob::Start(const std::shared_ptr<PreviewJob>& job) {
+    PreviewPool().Submit([job]() {
+        if (!job->detailsId.empty()) {
+            FetchDetails(job);
+            return;
+        }
+        std::string data;
+        if (job->thumbnailPath.empty() || job->cancelled || !FetchAttachment(job->thumbnailPath, data)) {
+            FetchFull(job);
+            return;
+        }
+        DecodePool().Submit([job, data = std::move(data)]() {
+            if (job->cancelled) return;
+            std::shared_ptr<Gdiplus::Bitmap> thumbnail = DecodeImage(data);
+            bool enough = thumbnail && CoversPanel(*thumbnail, job->panelWidth, job->panelHeight);
+            if (thumbnail) job->Publish(thumbnail, nullptr, enough);
+            if (!enough) PreviewPool().Submit([job]() { FetchFull(job); });
+        });
+    });
+}
+
+// Schlanke Listing-Zeile (ohne Storage-Pfade): vollständige Zeile nachladen und
+// an den UI-Thread übergeben, der index_ aktualisiert und dann normal weiterlädt
+void FileBrowser::PreviewJob::FetchDetails(const std::shared_ptr<PreviewJob>& job) {
+    if (job->cancelled) return;
+    storagedata::FileInfo info;
+    info.id = job->detailsId;
+    std::string err;
+    bool ok = storagedata::FetchFileDetails(info, &err);
+    if (!ok) {
+        std::ofstream log("debug.log", std::ios::app);
+        log << "ERROR: FetchFileDetails failed: " << err << "\n";
+    }
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        if (ok) {
+            job->details = std::move(info);
+            job->hasDetails = true;
+        }
+        job->done = !ok;
+    }
+    PostMessage(job->target, WM_APP_PREVIEW_LOADED, (WPARAM)job->generation, 0);
+}
+
+// "Original" der Vorschau: in Panelgröße (Server oder lokal verkleinert)
+void FileBrowser::PreviewJob::FetchFull(const std::shared_ptr<PreviewJob>& job) {
+    if (job->cancelled) return;
+    std::string data;
+    if (!FetchPreview(job->fullPath, job->panelWidth, job->panelHeight, data)) {
+        job->Publish(nullptr, nullptr, true);
+        return;
+    }
+    DecodePool().Submit([job, data = std::move(data)]() {
+        if (job->cancelled) return;
+        job->Publish(nullptr, DecodeImage(data, job->panelWidth, job->panelHeight), true);
+    });
+}
+
+void FileBrowser::PreviewJob::Publish(std::shared_ptr<Gdiplus::Bitmap> decodedThumbnail,
+                                      std::shared_ptr<Gdiplus::Bitmap> decodedFull, bool finished) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (decodedThumbnail) thumbnail = decodedThumbnail;
+        if (decodedFull) full = decodedFull;
+        done = finished;
+    }
+    PostMessage(target, WM_APP_PREVIEW_LOADED, (WPARAM)generation, 0);
+}
+
 // GDI+ Initialization
 static ULONG_PTR gdiplusToken = 0;
 
-FileBrowser::FileBrowser() {
+FileBrowser::FileBrowser() : previewCache_(DEFAULT_PREVIEW_CACHE_BYTES) {
     // Initialize GDI+
     if (gdiplusToken == 0) {
         GdiplusStartupInput gdiplusStartupInput;
@@ -55,10 +243,14 @@ FileBrowser::FileBrowser() {
 }
 
 FileBrowser::~FileBrowser() {
-    if (currentImage_) {
-        delete currentImage_;
-        currentImage_ = nullptr;
-    }
+    if (download_) download_->cancelled = true;
+    ReleaseScaledPreview();
+    currentImage_.reset();
+    previewCache_.Clear();
+}
+
+void FileBrowser::SetPreviewCacheBudget(size_t bytes) {
+    previewCache_.SetBudget(bytes);
 }
 
 void FileBrowser::Show(HINSTANCE hInstance, HWND hParent) {
@@ -82,6 +274,13 @@ void FileBrowser::Show(HINSTANCE hInstance, HWND hParent) {
 }
 
 void FileBrowser::Hide() {
+    DiskCache::Instance().Flush();
+    if (download_) {
+        // Ohne Fenster kommt keine Fertigmeldung mehr an
+        download_->cancelled = true;
+        if (hwnd_) SetWindowTextW(GetAncestor(hwnd_, GA_ROOT), download_->savedTitle.c_str());
+        download_.reset();
+    }
     if (hwnd_ && IsWindow(hwnd_)) {
         DestroyWindow(hwnd_);
         hwnd_ = nullptr;
@@ -95,6 +294,7 @@ LRESULT CALLBACK FileBrowser::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LP
         FileBrowser* pThis = reinterpret_cast<FileBrowser*>(((CREATESTRUCT*)lParam)->lpCreateParams);
         if (pThis) {
             SetWindowLongPtr(hwnd, GWLP_USERDATA, (LONG_PTR)pThis);
+            pThis->hwnd_ = hwnd;  // Wird für PostMessage aus Worker-Threads gebraucht
             pThis->hTab_ = CreateWindowW(WC_TABCONTROLW, L"", WS_CHILD | WS_VISIBLE,
                 10, 10, 750, 30, hwnd, NULL, NULL, NULL);
             TCITEMW tie = { 0 };
@@ -105,6 +305,12 @@ LRESULT CALLBACK FileBrowser::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LP
             TabCtrl_InsertItem(pThis->hTab_, 1, &tie);
             tie.pszText = (LPWSTR)L"Bilder";
             TabCtrl_InsertItem(pThis->hTab_, 2, &tie);
+            tie.pszText = (LPWSTR)L"Audio";
+            TabCtrl_InsertItem(pThis->hTab_, 3, &tie);
+            tie.pszText = (LPWSTR)L"MIDI";
+            TabCtrl_InsertItem(pThis->hTab_, 4, &tie);
+            tie.pszText = (LPWSTR)L"Videos";
+            TabCtrl_InsertItem(pThis->hTab_, 5, &tie);
 
             // Listbox (links, schmaler für Split-View)
             pThis->hList_ = CreateWindowExW(0, L"LISTBOX", L"", WS_CHILD | WS_VISIBLE | WS_BORDER | LBS_NOTIFY | WS_VSCROLL | LBS_HASSTRINGS,
@@ -134,9 +340,10 @@ LRESULT CALLBACK FileBrowser::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LP
         if (pThis && LOWORD(wParam) == 1001 && HIWORD(wParam) == LBN_SELCHANGE) {
             // User hat eine Datei in der Liste ausgewählt
             int selIndex = (int)SendMessage(pThis->hList_, LB_GETCURSEL, 0, 0);
-            if (selIndex != LB_ERR && selIndex < (int)pThis->currentFiles_.size()) {
-                // Lade Bildvorschau direkt mit Index
+            if (selIndex != LB_ERR && selIndex < (int)pThis->visibleRows_.size()) {
+                // Lade Bildvorschau direkt mit Index, danach Nachbarn vorausladen
                 pThis->LoadImagePreview(selIndex);
+                pThis->SchedulePrefetch(selIndex);
             }
         }
         break;
@@ -150,6 +357,13 @@ LRESULT CALLBACK FileBrowser::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LP
         }
         break;
     }
+    case WM_APP_FILES_LOADED: {
+        FileBrowser* pThis = reinterpret_cast<FileBrowser*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+        if (pThis) {
+            pThis->OnListingProgress((unsigned)wParam);
+        }
+        return 0;
+    }
     case WM_KEYDOWN: {
         // Strg+C: Kopierfunktion für Listbox
         if (wParam == 'C' && (GetKeyState(VK_CONTROL) & 0x8000)) {
@@ -178,6 +392,16 @@ LRESULT CALLBACK FileBrowser::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LP
         }
         break;
     }
+    case WM_APP_DOWNLOAD_PROGRESS: {
+        FileBrowser* pThis = reinterpret_cast<FileBrowser*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+        if (pThis) pThis->OnDownloadProgress((int)wParam);
+        return 0;
+    }
+    case WM_APP_DOWNLOAD_DONE: {
+        FileBrowser* pThis = reinterpret_cast<FileBrowser*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+        if (pThis) pThis->OnDownloadFinished();
+        return 0;
+    }
     case WM_CONTEXTMENU: {
         // Rechtsklick-Kontextmenü
         FileBrowser* pThis = reinterpret_cast<FileBrowser*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
@@ -186,6 +410,7 @@ LRESULT CALLBACK FileBrowser::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LP
             AppendMenuW(hMenu, MF_STRING, 1, L"Kopieren");
             AppendMenuW(hMenu, MF_STRING, 2, L"Im Browser öffnen");
             AppendMenuW(hMenu, MF_STRING, 3, L"Thumbnail öffnen (nur Bilder)");
+            AppendMenuW(hMenu, MF_STRING, 4, L"Speichern unter...");
             POINT pt;
             pt.x = LOWORD(lParam);
             pt.y = HIWORD(lParam);
@@ -219,6 +444,9 @@ LRESULT CALLBACK FileBrowser::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LP
             } else if (cmd == 3) {
                 // Thumbnail öffnen
                 MessageBoxW(hwnd, L"Thumbnail-Funktion noch nicht implementiert", L"Info", MB_OK);
+            } else if (cmd == 4) {
+                int selIndex = (int)SendMessage(pThis->hList_, LB_GETCURSEL, 0, 0);
+                if (selIndex != LB_ERR) pThis->SaveAttachment(selIndex);
             }
             DestroyMenu(hMenu);
         }
@@ -236,7 +464,6 @@ void FileBrowser::PopulateList(int tabIndex) {
     log << "\n=== COMPILED ! PopulateList called, tabIndex=" << tabIndex << " ===\n";
 
     if (!hList_) return;
-    SendMessage(hList_, LB_RESETCONTENT, 0, 0);
 
     // Filter basierend auf Tab auswählen
     storagedata::FileFilter filter;
@@ -250,31 +477,136 @@ void FileBrowser::PopulateList(int tabIndex) {
         case 2: // Bilder
             filter = storagedata::FileFilter::IMAGES;
             break;
+        case 3: // Audio
+            filter = storagedata::FileFilter::AUDIO;
+            break;
+        case 4: // MIDI
+            filter = storagedata::FileFilter::MIDI;
+            break;
+        case 5: // Videos
+            filter = storagedata::FileFilter::VIDEO;
+            break;
         default:
             filter = storagedata::FileFilter::ALL;
             break;
     }
 
-    // Dateien mit detaillierten Infos laden
-    currentFiles_.clear();
-    std::string err;
-    if (storagedata::ListFilesDetailed(currentFiles_, filter, &err)) {
-        log << "ListFilesDetailed SUCCESS: Found " << currentFiles_.size() << " files\n";
-        if (currentFiles_.empty()) {
-            SendMessage(hList_, LB_ADDSTRING, 0, (LPARAM)L"Keine Dateien gefunden.");
-        } else {
-            // Alle Dateien mit DisplayName (inkl. Größe) anzeigen
-            for (const auto& fileInfo : currentFiles_) {
-                log << "  File: " << fileInfo.fileName << " (" << fileInfo.fileType << ")\n";
-                log << "    StoragePath: " << fileInfo.storagePath << "\n";
-                std::wstring displayName = Utf8ToUtf16(fileInfo.GetDisplayName());
-                SendMessage(hList_, LB_ADDSTRING, 0, (LPARAM)displayName.c_str());
+    // Tabs sind nur Facetten des Gesamt-Listings: lokal filtern, kein Request pro Tab
+    currentQuery_ = AttachmentIndex::FromFilter(filter);
+    std::vector<storagedata::FileInfo> cached;
+    if (index_.IsEmpty() && !listing_ && ListingSync::Instance().GetCached(storagedata::FileFilter::ALL, cached)) {
+        index_.Build(std::move(cached), Auth::GetUserId());
+        log << "Cached listing: " << index_.Size() << " files\n";
+    }
+    RenderList("");
+
+    // Läuft bereits ein Sync, liefert er auch für diesen Tab
+    if (listing_) return;
+
+    // Delta-Sync: nach dem ersten Laden nur noch neue Zeilen seit dem Watermark.
+    // Ein vollständiges Laden kommt seitenweise und baut den Index von vorn auf.
+    if (!ListingSync::Instance().IsLoaded(storagedata::FileFilter::ALL)) index_.Clear();
+    unsigned generation = ++listGeneration_;
+    HWND hwndTarget = hwnd_;
+    listing_ = ListingSync::Instance().SyncAsync(storagedata::FileFilter::ALL, [hwndTarget, generation]() {
+        PostMessage(hwndTarget, WM_APP_FILES_LOADED, (WPARAM)generation, 0);
+    }, true);
+}
+
+// Baut die Listbox für currentQuery_ aus dem Index auf (Auswahl über die ID erhalten)
+void FileBrowser::RenderList(const std::string& selectedId) {
+    SendMessage(hList_, WM_SETREDRAW, FALSE, 0);
+    SendMessage(hList_, LB_RESETCONTENT, 0, 0);
+    index_.Select(currentQuery_, visibleRows_);
+    listPlaceholder_ = false;
+
+    if (visibleRows_.empty()) {
+        // Leer: entweder noch beim ersten Laden oder wirklich keine Treffer
+        SendMessage(hList_, LB_ADDSTRING, 0, (LPARAM)(listing_ || index_.IsEmpty() ? L"Lade Dateien..." : L"Keine Dateien gefunden."));
+        listPlaceholder_ = true;
+    } else {
+        SendMessage(hList_, LB_INITSTORAGE, (WPARAM)visibleRows_.size(), (LPARAM)(visibleRows_.size() * 64));
+        for (size_t row : visibleRows_) {
+            storagedata::FileInfo fileInfo = index_.Get(row);
+            std::wstring displayName = Utf8ToUtf16(fileInfo.GetDisplayName());
+            int index = (int)SendMessage(hList_, LB_ADDSTRING, 0, (LPARAM)displayName.c_str());
+            if (!selectedId.empty() && fileInfo.id == selectedId) {
+                SendMessage(hList_, LB_SETCURSEL, (WPARAM)index, 0);
+            }
+        }
+    }
+    SendMessage(hList_, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(hList_, NULL, TRUE);
+}
+
+// Übernimmt neu eingetroffene Seiten des Listings (läuft auf dem UI-Thread)
+void FileBrowser::OnListingProgress(unsigned generation) {
+    std::ofstream log("debug.log", std::ios::app);
+
+    // Nachricht eines abgelösten Syncs ignorieren
+    if (generation != listGeneration_ || !listing_) {
+        return;
+    }
+    if (!hList_) return;
+
+    // Erst Status lesen, dann Seiten holen: ist done gesetzt, sind alle Seiten eingereiht
+    bool done = listing_->IsDone();
+    for (auto& page : listing_->TakePages()) {
+        log << "Listing page: " << page.files.size() << " files"
+            << (page.delta ? " (delta, " + std::to_string(page.removed.size()) + " removed)" : "") << "\n";
+
+        // Delta: Änderungen in den bestehenden Index einmischen
+        if (page.delta) {
+            std::string selectedId;
+            int selIndex = (int)SendMessage(hList_, LB_GETCURSEL, 0, 0);
+            if (!listPlaceholder_ && selIndex != LB_ERR && selIndex < (int)visibleRows_.size()) {
+                selectedId = index_.Id(visibleRows_[selIndex]);
             }
+            index_.ApplyDelta(page.files, page.removed);
+            RenderList(selectedId);
+            continue;
+        }
+
+        // Erstes Laden: ältere Seite anhängen, nur die Treffer des Tabs anzeigen
+        size_t firstRow = index_.Size();
+        if (firstRow == 0) index_.Build(std::vector<storagedata::FileInfo>(), Auth::GetUserId());  // Setzt die User-ID
+        index_.Append(page.files);
+
+        std::vector<size_t> rows;
+        index_.Select(currentQuery_, rows, firstRow);
+        if (rows.empty()) continue;
+        if (listPlaceholder_) {
+            SendMessage(hList_, LB_RESETCONTENT, 0, 0);
+            listPlaceholder_ = false;
+        }
+        for (size_t row : rows) {
+            std::wstring displayName = Utf8ToUtf16(index_.Get(row).GetDisplayName());
+            SendMessage(hList_, LB_ADDSTRING, 0, (LPARAM)displayName.c_str());
+            visibleRows_.push_back(row);
+        }
+    }
+
+    if (!done) return;
+
+    bool success = listing_->Succeeded();
+    std::string error = listing_->Error();
+    listing_.reset();
+
+    if (success) {
+        log << "ListFilesPaged SUCCESS: Found " << index_.Size() << " files, " << visibleRows_.size() << " im Tab\n";
+        log << "AttachmentIndex: " << index_.GetMemoryUsage().Total() / 1024 << " KB\n";
+        if (visibleRows_.empty()) {
+            SendMessage(hList_, LB_RESETCONTENT, 0, 0);
+            SendMessage(hList_, LB_ADDSTRING, 0, (LPARAM)L"Keine Dateien gefunden.");
+            listPlaceholder_ = true;
         }
     } else {
-        log << "ListFilesDetailed FAILED: " << err << "\n";
-        std::wstring werr = Utf8ToUtf16(err);
+        // Fehlermeldung hinter bereits geladenen Einträgen anzeigen
+        log << "ListFilesPaged FAILED: " << error << "\n";
+        if (listPlaceholder_) SendMessage(hList_, LB_RESETCONTENT, 0, 0);
+        std::wstring werr = Utf8ToUtf16(error);
         SendMessage(hList_, LB_ADDSTRING, 0, (LPARAM)werr.c_str());
+        listPlaceholder_ = true;
     }
 }
 
@@ -283,38 +615,35 @@ LRESULT CALLBACK FileBrowser::PreviewProc(HWND hwnd, UINT uMsg, WPARAM wParam, L
     FileBrowser* pThis = reinterpret_cast<FileBrowser*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
 
     switch (uMsg) {
+    case WM_APP_PREVIEW_LOADED:
+        if (pThis) pThis->OnPreviewLoaded((unsigned)wParam);
+        return 0;
+    case WM_APP_PREFETCHED:
+        if (pThis) pThis->OnPrefetched();
+        return 0;
+    case WM_ERASEBKGND:
+        // Der Blit deckt das ganze Panel ab; Löschen vorher würde nur flackern
+        if (pThis && pThis->currentImage_) return 1;
+        break;
     case WM_PAINT: {
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
 
-        if (pThis && pThis->currentImage_) {
-            // Zeichne Bild
-            Graphics graphics(hdc);
-            graphics.SetInterpolationMode(InterpolationModeHighQualityBicubic);
-
-            RECT rect;
-            GetClientRect(hwnd, &rect);
-            int panelWidth = rect.right - rect.left;
-            int panelHeight = rect.bottom - rect.top;
-
-            UINT imgWidth = pThis->currentImage_->GetWidth();
-            UINT imgHeight = pThis->currentImage_->GetHeight();
-
-            // Berechne Skalierung (fit to window, keep aspect ratio)
-            float scaleX = (float)panelWidth / imgWidth;
-            float scaleY = (float)panelHeight / imgHeight;
-            float scale = (scaleX < scaleY) ? scaleX : scaleY;
-
-            int drawWidth = (int)(imgWidth * scale);
-            int drawHeight = (int)(imgHeight * scale);
-            int offsetX = (panelWidth - drawWidth) / 2;
-            int offsetY = (panelHeight - drawHeight) / 2;
-
-            graphics.DrawImage(pThis->currentImage_, offsetX, offsetY, drawWidth, drawHeight);
+        RECT rect;
+        GetClientRect(hwnd, &rect);
+        int panelWidth = rect.right - rect.left;
+        int panelHeight = rect.bottom - rect.top;
+
+        if (pThis && pThis->currentImage_ && pThis->UpdateScaledPreview(panelWidth, panelHeight)) {
+            // Bereits eingepasstes Bild: nur kopieren, kein Skalieren pro Paint
+            HDC memoryDc = CreateCompatibleDC(hdc);
+            HGDIOBJ previous = SelectObject(memoryDc, pThis->scaledPreview_);
+            BitBlt(hdc, 0, 0, panelWidth, panelHeight, memoryDc, 0, 0, SRCCOPY);
+            SelectObject(memoryDc, previous);
+            DeleteDC(memoryDc);
         } else {
             // Zeige Platzhalter-Text
-            RECT rect;
-            GetClientRect(hwnd, &rect);
+            FillRect(hdc, &rect, GetSysColorBrush(COLOR_WINDOW));
             SetTextColor(hdc, RGB(128, 128, 128));
             SetBkMode(hdc, TRANSPARENT);
             DrawTextW(hdc, L"Wähle ein Bild aus der Liste", -1, &rect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
@@ -327,244 +656,239 @@ LRESULT CALLBACK FileBrowser::PreviewProc(HWND hwnd, UINT uMsg, WPARAM wParam, L
     return DefWindowProc(hwnd, uMsg, wParam, lParam);
 }
 
-// Generiere Signed URL für Storage-Pfad via Supabase Storage API
-std::string FileBrowser::GenerateSignedUrl(const std::string& storagePath) {
-    std::ofstream log("debug.log", std::ios::app);
-    log << "\n=== GenerateSignedUrl called ===\n";
-    log << "StoragePath: " << storagePath << "\n";
+bool FileBrowser::UpdateScaledPreview(int panelWidth, int panelHeight) {
+    if (scaledPreview_ && scaledSource_ == currentImage_ && scaledWidth_ == panelWidth && scaledHeight_ == panelHeight) {
+        return true;
+    }
+    ReleaseScaledPreview();
+    if (!currentImage_ || panelWidth <= 0 || panelHeight <= 0) return false;
+
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = panelWidth;
+    info.bmiHeader.biHeight = -panelHeight;  // Top-down
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+    void* bits = nullptr;
+    HBITMAP dib = CreateDIBSection(NULL, &info, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!dib || !bits) {
+        std::ofstream log("debug.log", std::ios::app);
+        log << "ERROR: CreateDIBSection " << panelWidth << "x" << panelHeight << " fehlgeschlagen\n";
+        if (dib) DeleteObject(dib);
+        return false;
+    }
 
-    // Hole JWT Token aus Auth
-    std::string jwt = Auth::GetAccessToken();
-    if (jwt.empty()) {
-        log << "ERROR: No JWT token!\n";
-        return "";
+    // Fensterhintergrund, darauf das eingepasste Bild (zentriert)
+    DWORD background = GetSysColor(COLOR_WINDOW);
+    uint8_t red = GetRValue(background), green = GetGValue(background), blue = GetBValue(background);
+    uint8_t* pixels = (uint8_t*)bits;
+    ptrdiff_t stride = (ptrdiff_t)panelWidth * 4;
+    for (size_t i = 0; i < (size_t)panelWidth * panelHeight; ++i) {
+        pixels[i * 4] = blue;
+        pixels[i * 4 + 1] = green;
+        pixels[i * 4 + 2] = red;
+        pixels[i * 4 + 3] = 255;
     }
-    log << "JWT Token found (length=" << jwt.length() << ")\n";
 
-    // Supabase Storage API Endpoint - POST mit JSON Body
-    std::string apiPath = "/storage/v1/object/sign/chat-attachments/" + storagePath;
-    log << "API Path: " << apiPath << "\n";
+    Gdiplus::Bitmap& image = *currentImage_;
+    int imageWidth = (int)image.GetWidth();
+    int imageHeight = (int)image.GetHeight();
+    int drawWidth, drawHeight;
+    ImageResample::FitSize(imageWidth, imageHeight, panelWidth, panelHeight, drawWidth, drawHeight);
+    uint8_t* target = pixels + ((panelHeight - drawHeight) / 2) * stride + ((panelWidth - drawWidth) / 2) * 4;
+
+    Gdiplus::Rect source(0, 0, imageWidth, imageHeight);
+    Gdiplus::BitmapData data;
+    if (image.LockBits(&source, Gdiplus::ImageLockModeRead, PixelFormat32bppPARGB, &data) == Gdiplus::Ok) {
+        ImageResample::Resize((const uint8_t*)data.Scan0, imageWidth, imageHeight, data.Stride,
+                              target, drawWidth, drawHeight, stride);
+        image.UnlockBits(&data);
+        ImageResample::CompositeOver(target, drawWidth, drawHeight, stride, red, green, blue);
+    } else {
+        std::ofstream log("debug.log", std::ios::app);
+        log << "ERROR: LockBits für die Vorschau fehlgeschlagen\n";
+    }
 
-    HINTERNET hSession = WinHttpOpen(L"DegixDAW/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
-    if (!hSession) return "";
+    scaledPreview_ = dib;
+    scaledSource_ = currentImage_;
+    scaledWidth_ = panelWidth;
+    scaledHeight_ = panelHeight;
+    return true;
+}
 
-    HINTERNET hConnect = WinHttpConnect(hSession, L"xcdzugnjzrkngzmtzeip.supabase.co", INTERNET_DEFAULT_HTTPS_PORT, 0);
-    if (!hConnect) {
-        WinHttpCloseHandle(hSession);
-        return "";
+void FileBrowser::ReleaseScaledPreview() {
+    if (scaledPreview_) {
+        DeleteObject(scaledPreview_);
+        scaledPreview_ = nullptr;
     }
+    scaledSource_.reset();
+    scaledWidth_ = scaledHeight_ = 0;
+}
+
+// Generiere Signed URL für Storage-Pfad via Supabase Storage API
+std::string FileBrowser::GenerateSignedUrl(const std::string& storagePath) {
+    std::ofstream log("debug.log", std::ios::app);
+    log << "\n=== GenerateSignedUrl called ===\n";
+    log << "StoragePath: " << storagePath << "\n";
 
-    std::wstring wApiPath = Utf8ToUtf16(apiPath);
-    HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"POST", wApiPath.c_str(), NULL, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, WINHTTP_FLAG_SECURE);
-    if (!hRequest) {
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
+    // Über den SignedUrlCache (beim Listing bereits per Batch befüllt)
+    std::string signedUrl;
+    std::string err;
+    if (!storagedata::GetSignedUrl(storagePath, signedUrl, &err)) {
+        log << "ERROR: " << err << "\n";
         return "";
     }
 
-    // JSON Body mit expiresIn
-    std::string jsonBody = "{\"expiresIn\":3600}";
-    DWORD jsonBodyLen = (DWORD)jsonBody.length();
+    SignedUrlCache::Stats stats = SignedUrlCache::Instance().GetStats();
+    log << "SignedUrlCache: hits=" << stats.hits << " misses=" << stats.misses << " entries=" << stats.entries << "\n";
+    log << "SUCCESS: Got signed URL (length=" << signedUrl.length() << ")\n";
+    return signedUrl;
+}
 
-    // Headers setzen
-    std::string authHeader = "Authorization: Bearer " + jwt;
-    std::wstring wAuthHeader = Utf8ToUtf16(authHeader);
-    WinHttpAddRequestHeaders(hRequest, wAuthHeader.c_str(), -1, WINHTTP_ADDREQ_FLAG_ADD);
-    WinHttpAddRequestHeaders(hRequest, L"Content-Type: application/json", -1, WINHTTP_ADDREQ_FLAG_ADD);
+// GET über den gemeinsamen HTTP-Client; nur vollständige 200 gelten, der Inhalt landet unter cacheKey im Disk-Cache
+static bool DownloadToCache(const std::string& url, const std::string& cacheKey, std::string& outData, int* outStatus = nullptr) {
+    std::ofstream log("debug.log", std::ios::app);
+    log << "Download: " << url.substr(0, 100) << "...\n";
 
-    log << "Sending POST request with body: " << jsonBody << "\n";
+    // Body direkt in outData (auf Content-Length vorreserviert); Cache und
+    // Decoder lesen anschließend aus demselben Speicher
+    net::StringSink sink(outData);
+    net::HttpRequest request;
+    request.url = url;
+    request.sink = &sink;
 
-    // Request senden mit JSON Body
-    if (!WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0, (LPVOID)jsonBody.c_str(), jsonBodyLen, jsonBodyLen, 0)) {
-        log << "ERROR: WinHttpSendRequest failed\n";
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        return "";
+    net::HttpResponse response;
+    std::string err;
+    if (outStatus) *outStatus = 0;
+    if (!net::HttpClient::Instance().Send(request, response, &err)) {
+        log << "ERROR: " << err << "\n";
+        outData.clear();
+        return false;
     }
-
-    if (!WinHttpReceiveResponse(hRequest, NULL)) {
-        log << "ERROR: WinHttpReceiveResponse failed\n";
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        return "";
+    log << "HTTP Status: " << response.status << "\n";
+    if (outStatus) *outStatus = response.status;
+    if (response.status != 200) {
+        log << "ERROR: " << outData.substr(0, 200) << "\n";
+        outData.clear();
+        return false;
     }
 
-    // HTTP Status prüfen
-    DWORD statusCode = 0;
-    DWORD statusSize = sizeof(statusCode);
-    WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, NULL, &statusCode, &statusSize, NULL);
-    log << "HTTP Status: " << statusCode << "\n";
+    log << "Downloaded " << outData.size() << " bytes\n";
 
-    // Response lesen
-    std::string response;
-    DWORD bytesAvailable = 0;
-    while (WinHttpQueryDataAvailable(hRequest, &bytesAvailable) && bytesAvailable > 0) {
-        std::vector<char> buffer(bytesAvailable + 1, 0);
-        DWORD bytesRead = 0;
-        if (WinHttpReadData(hRequest, buffer.data(), bytesAvailable, &bytesRead)) {
-            response.append(buffer.data(), bytesRead);
-        }
+    // Unterwegs abgerissener Body: weder cachen (die MD5 im Cache stammt sonst aus den
+    // abgeschnittenen Bytes und jeder spätere Treffer gälte als gültig) noch dekodieren
+    std::string contentLength = response.GetHeader("Content-Length");
+    if (!contentLength.empty() && std::strtoull(contentLength.c_str(), nullptr, 10) != outData.size()) {
+        log << "ERROR: unvollständig, " << outData.size() << " von " << contentLength << " Bytes\n";
+        outData.clear();
+        return false;
     }
 
-    WinHttpCloseHandle(hRequest);
-    WinHttpCloseHandle(hConnect);
-    WinHttpCloseHandle(hSession);
-
-    log << "Response: " << response << "\n";
-
-    // Parse JSON Response (Simple string search for "signedURL")
-    size_t pos = response.find("\"signedURL\":\"");
-    if (pos != std::string::npos) {
-        size_t start = pos + 13; // Length of "signedURL":""
-        size_t end = response.find("\"", start);
-        if (end != std::string::npos) {
-            std::string signedUrl = response.substr(start, end - start);
-
-            // Supabase gibt relativen Pfad zurück - mache es zu voller URL
-            if (signedUrl[0] == '/') {
-                signedUrl = "https://xcdzugnjzrkngzmtzeip.supabase.co/storage/v1" + signedUrl;
-                log << "Converted relative path to full URL\n";
-            }
-
-            log << "SUCCESS: Got signed URL (length=" << signedUrl.length() << ")\n";
-            return signedUrl;
-        }
+    // Nur vollständige 200-Antworten cachen
+    if (!outData.empty() && !DiskCache::Instance().Put(cacheKey, outData, &err)) {
+        log << "DiskCache: " << err << "\n";
     }
-
-    log << "ERROR: Could not parse signedURL from response\n";
-    return "";
+    return true;
 }
 
-// Lade Bild von URL mit WinHTTP
-Gdiplus::Image* FileBrowser::DownloadImage(const std::string& url) {
+// Lade Attachment: aus dem Disk-Cache, sonst signieren + herunterladen
+bool FileBrowser::FetchAttachment(const std::string& storagePath, std::string& outData) {
     std::ofstream log("debug.log", std::ios::app);
-    log << "\n=== DownloadImage called ===\n";
-    log << "URL: " << url << "\n";
+    log << "\n=== FetchAttachment called ===\n";
 
-    // Parse URL (Format: https://host/path)
-    size_t hostStart = url.find("://");
-    if (hostStart == std::string::npos) {
-        log << "ERROR: No '://' found in URL\n";
-        return nullptr;
+    if (DiskCache::Instance().Get(storagePath, outData)) {
+        log << "DiskCache hit: " << outData.size() << " bytes\n";
+        return true;
     }
-    hostStart += 3;
 
-    size_t pathStart = url.find("/", hostStart);
-    if (pathStart == std::string::npos) {
-        log << "ERROR: No path separator found\n";
-        return nullptr;
+    std::string signedUrl = GenerateSignedUrl(storagePath);
+    if (signedUrl.empty()) {
+        log << "ERROR: Failed to generate signed URL\n";
+        return false;
     }
+    return DownloadToCache(signedUrl, storagePath, outData);
+}
 
-    std::string host = url.substr(hostStart, pathStart - hostStart);
-    std::string path = url.substr(pathStart);
-
-    log << "Host: " << host << "\n";
-    log << "Path: " << path.substr(0, 80) << "...\n";
-
-    std::wstring wHost = Utf8ToUtf16(host);
-    std::wstring wPath = Utf8ToUtf16(path);
+// Bildtransformation ist ein Projekt-Feature; einmal abgelehnt, wird sie in
+// dieser Sitzung nicht mehr versucht
+static std::atomic<bool> renderUnavailable{false};
 
-    HINTERNET hSession = WinHttpOpen(L"DegixDAW/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
-    if (!hSession) {
-        log << "ERROR: WinHttpOpen failed\n";
-        return nullptr;
-    }
+// Lade Vorschau in Panelgröße: serverseitig verkleinert (/render/image), sonst
+// das Original (Aufrufer skaliert lokal). Lokale Daten gehen vor Netzwerk.
+bool FileBrowser::FetchPreview(const std::string& storagePath, int width, int height, std::string& outData) {
+    std::ofstream log("debug.log", std::ios::app);
+    log << "\n=== FetchPreview called (" << width << "x" << height << ") ===\n";
 
-    HINTERNET hConnect = WinHttpConnect(hSession, wHost.c_str(), INTERNET_DEFAULT_HTTPS_PORT, 0);
-    if (!hConnect) {
-        log << "ERROR: WinHttpConnect failed\n";
-        WinHttpCloseHandle(hSession);
-        return nullptr;
-    }
+    storagedata::ImageTransform transform;
+    transform.width = width;
+    transform.height = height;
+    transform.quality = PREVIEW_QUALITY;
+    std::string variantKey = storagePath + "#" + transform.Key();
 
-    HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"GET", wPath.c_str(), NULL, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, WINHTTP_FLAG_SECURE);
-    if (!hRequest) {
-        log << "ERROR: WinHttpOpenRequest failed\n";
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        return nullptr;
+    if (DiskCache::Instance().Get(variantKey, outData)) {
+        log << "DiskCache hit (Variante): " << outData.size() << " bytes\n";
+        return true;
     }
-
-    if (!WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0)) {
-        log << "ERROR: WinHttpSendRequest failed\n";
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        return nullptr;
+    if (DiskCache::Instance().Contains(storagePath) || width <= 0 || height <= 0 || renderUnavailable) {
+        return FetchAttachment(storagePath, outData);
     }
 
-    if (!WinHttpReceiveResponse(hRequest, NULL)) {
-        log << "ERROR: WinHttpReceiveResponse failed\n";
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        return nullptr;
+    std::string renderUrl, err;
+    int status = 0;
+    if (storagedata::GetSignedRenderUrl(storagePath, transform, renderUrl, &err) &&
+        DownloadToCache(renderUrl, variantKey, outData, &status)) {
+        return true;
     }
 
-    // HTTP Status prüfen
-    DWORD statusCode = 0;
-    DWORD statusSize = sizeof(statusCode);
-    WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, NULL, &statusCode, &statusSize, NULL);
-    log << "HTTP Status: " << statusCode << "\n";
-
-    // Lade Bild-Daten in Memory
-    std::vector<BYTE> imageData;
-    DWORD bytesAvailable = 0;
-    while (WinHttpQueryDataAvailable(hRequest, &bytesAvailable) && bytesAvailable > 0) {
-        size_t currentSize = imageData.size();
-        imageData.resize(currentSize + bytesAvailable);
-        DWORD bytesRead = 0;
-        if (!WinHttpReadData(hRequest, &imageData[currentSize], bytesAvailable, &bytesRead)) {
-            log << "ERROR: WinHttpReadData failed\n";
-            break;
-        }
+    // Nur wenn der Render-Endpoint selbst fehlt (403: Feature nicht freigeschaltet,
+    // 501): für die Sitzung abschalten. Andere Fehler (Objekt gelöscht, Format nicht
+    // unterstützt, Signier- und Netzwerkfehler) betreffen nur diesen Pfad.
+    if (!err.empty()) log << "ERROR: " << err << "\n";
+    if (status == 403 || status == 501) {
+        log << "Bildtransformation nicht verfügbar (HTTP " << status << "), lade Originale\n";
+        renderUnavailable = true;
+    } else if (status != 0) {
+        log << "Render abgelehnt (HTTP " << status << "), lade Original für diesen Pfad\n";
     }
+    return FetchAttachment(storagePath, outData);
+}
 
-    log << "Downloaded " << imageData.size() << " bytes\n";
-
-    WinHttpCloseHandle(hRequest);
-    WinHttpCloseHandle(hConnect);
-    WinHttpCloseHandle(hSession);
-
+// Dekodiere Bilddaten mit GDI+ (optional in eine Box maxWidth x maxHeight eingepasst)
+std::shared_ptr<Gdiplus::Bitmap> FileBrowser::DecodeImage(const std::string& imageData, int maxWidth, int maxHeight) {
+    std::ofstream log("debug.log", std::ios::app);
     if (imageData.empty()) {
         log << "ERROR: No image data received\n";
         return nullptr;
     }
 
-    // Erstelle GDI+ Image aus Memory Buffer
-    log << "Creating GDI+ Image from buffer...\n";
-    HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, imageData.size());
-    if (!hMem) {
-        log << "ERROR: GlobalAlloc failed\n";
-        return nullptr;
-    }
-
-    void* pMem = GlobalLock(hMem);
-    if (!pMem) {
-        log << "ERROR: GlobalLock failed\n";
-        GlobalFree(hMem);
-        return nullptr;
+    // Große JPEGs direkt verkleinert dekodieren (Bruchteil von Zeit und Speicher)
+    if (maxWidth > 0 && maxHeight > 0 && ScaledJpeg::IsJpeg(imageData)) {
+        std::string err;
+        std::shared_ptr<Gdiplus::Bitmap> scaled = ScaledJpeg::Decode(imageData, maxWidth, maxHeight, &err);
+        if (scaled) {
+            log << "SUCCESS: JPEG skaliert dekodiert: " << scaled->GetWidth() << "x" << scaled->GetHeight() << "\n";
+            return scaled;
+        }
+        log << "JPEG skaliert: " << err << ", dekodiere vollständig\n";
     }
 
-    memcpy(pMem, imageData.data(), imageData.size());
-    GlobalUnlock(hMem);
-
-    IStream* pStream = nullptr;
-    HRESULT hr = CreateStreamOnHGlobal(hMem, TRUE, &pStream);
-    if (hr != S_OK) {
-        log << "ERROR: CreateStreamOnHGlobal failed (HRESULT=" << hr << ")\n";
-        GlobalFree(hMem);
+    // GDI+ liest direkt aus imageData (IWICStream über dem String, keine Kopie);
+    // imageData lebt länger als image, das unten wieder freigegeben wird
+    IWICImagingFactory* factory = WicSupport::CreateFactory();
+    IWICStream* stream = WicSupport::CreateMemoryStream(factory, imageData.data(), imageData.size());
+    if (factory) factory->Release();
+    if (!stream) {
+        log << "ERROR: WIC-Stream konnte nicht angelegt werden\n";
         return nullptr;
     }
 
     log << "Creating Image from stream...\n";
-    Gdiplus::Image* image = Gdiplus::Image::FromStream(pStream);
-    pStream->Release();
+    Gdiplus::Bitmap* image = Gdiplus::Bitmap::FromStream(stream);
+    stream->Release();
 
     if (!image) {
-        log << "ERROR: Image::FromStream returned nullptr\n";
+        log << "ERROR: Bitmap::FromStream returned nullptr\n";
         return nullptr;
     }
 
@@ -575,8 +899,50 @@ Gdiplus::Image* FileBrowser::DownloadImage(const std::string& url) {
         return nullptr;
     }
 
-    log << "SUCCESS: GDI+ Image created! Size: " << image->GetWidth() << "x" << image->GetHeight() << "\n";
-    return image;
+    // Vollständig in ein PARGB-Bitmap dekodieren: zeichnet am schnellsten und
+    // hält weder Stream noch komprimierte Daten fest. Größere Bilder dabei
+    // einmalig auf die Box verkleinern (Fallback ohne Server-Transformation).
+    UINT sourceWidth = image->GetWidth();
+    UINT sourceHeight = image->GetHeight();
+    UINT width = sourceWidth;
+    UINT height = sourceHeight;
+    if (maxWidth > 0 && maxHeight > 0 && width > 0 && height > 0 && (width > (UINT)maxWidth || height > (UINT)maxHeight)) {
+        double scale = std::min((double)maxWidth / width, (double)maxHeight / height);
+        log << "Downscale " << width << "x" << height;
+        width = std::max(1u, (UINT)(width * scale + 0.5));
+        height = std::max(1u, (UINT)(height * scale + 0.5));
+        log << " -> " << width << "x" << height << "\n";
+    }
+    std::shared_ptr<Gdiplus::Bitmap> bitmap = std::make_shared<Gdiplus::Bitmap>((INT)width, (INT)height, PixelFormat32bppPARGB);
+    if (bitmap->GetLastStatus() != Gdiplus::Ok) {
+        log << "ERROR: Bitmap " << width << "x" << height << " konnte nicht angelegt werden\n";
+        delete image;
+        return nullptr;
+    }
+    Gdiplus::Rect sourceRect(0, 0, (INT)sourceWidth, (INT)sourceHeight);
+    Gdiplus::Rect targetRect(0, 0, (INT)width, (INT)height);
+    Gdiplus::BitmapData source, target;
+    if (image->LockBits(&sourceRect, Gdiplus::ImageLockModeRead, PixelFormat32bppPARGB, &source) != Gdiplus::Ok) {
+        log << "ERROR: LockBits (Quelle) fehlgeschlagen\n";
+        delete image;
+        return nullptr;
+    }
+    if (bitmap->LockBits(&targetRect, Gdiplus::ImageLockModeWrite, PixelFormat32bppPARGB, &target) != Gdiplus::Ok) {
+        log << "ERROR: LockBits (Ziel) fehlgeschlagen\n";
+        image->UnlockBits(&source);
+        delete image;
+        return nullptr;
+    }
+    // Gleiche Größe: nur kopieren, sonst Lanczos (einmalig pro Bild)
+    ImageResample::Resize((const uint8_t*)source.Scan0, (int)sourceWidth, (int)sourceHeight, source.Stride,
+                          (uint8_t*)target.Scan0, (int)width, (int)height, target.Stride,
+                          ImageResample::Filter::Lanczos3);
+    bitmap->UnlockBits(&target);
+    image->UnlockBits(&source);
+    delete image;
+
+    log << "SUCCESS: GDI+ Image decoded! Size: " << width << "x" << height << "\n";
+    return bitmap;
 }
 
 // Lade Bildvorschau anhand des FileInfo Index
@@ -584,23 +950,25 @@ void FileBrowser::LoadImagePreview(int fileIndex) {
     std::ofstream log("debug.log", std::ios::app);
     log << "\n=== LoadImagePreview called, fileIndex=" << fileIndex << " ===\n";
 
-    // Altes Bild löschen
-    if (currentImage_) {
-        delete currentImage_;
-        currentImage_ = nullptr;
+    // Altes Bild freigeben (bleibt ggf. im previewCache_), laufendes Laden verwerfen
+    currentImage_.reset();
+    awaitedPrefetch_.clear();
+    ++previewGeneration_;
+    if (preview_) {
+        preview_->cancelled = true;
+        preview_.reset();
     }
 
     // Index validieren
-    if (fileIndex < 0 || fileIndex >= (int)currentFiles_.size()) {
-        log << "ERROR: Invalid index! currentFiles_.size()=" << currentFiles_.size() << "\n";
+    if (fileIndex < 0 || fileIndex >= (int)visibleRows_.size()) {
+        log << "ERROR: Invalid index! visibleRows_.size()=" << visibleRows_.size() << "\n";
         InvalidateRect(hPreview_, NULL, TRUE);
         return;
     }
 
-    const storagedata::FileInfo& fileInfo = currentFiles_[fileIndex];
+    storagedata::FileInfo fileInfo = index_.Get(visibleRows_[fileIndex]);
     log << "File: " << fileInfo.fileName << "\n";
     log << "Type: " << fileInfo.fileType << "\n";
-    log << "StoragePath: " << fileInfo.storagePath << "\n";
 
     // Nur Bilder laden
     if (!fileInfo.IsImage()) {
@@ -609,25 +977,423 @@ void FileBrowser::LoadImagePreview(int fileIndex) {
         return;
     }
 
-    // Signed URL generieren
-    log << "Generating signed URL...\n";
-    std::string signedUrl = GenerateSignedUrl(fileInfo.storagePath);
-    if (signedUrl.empty()) {
-        log << "ERROR: Failed to generate signed URL\n";
+    // Wird das Bild gerade vorausgeladen (ggf. samt Details), dessen Ergebnis übernehmen
+    if (TakeOverPrefetch(fileInfo)) return;
+
+    // Schlanke Listing-Zeile: vollständige Zeile im Worker nachladen,
+    // weiter geht es in OnPreviewLoaded (der UI-Thread wartet nie auf das Netz)
+    if (!fileInfo.HasDetails()) {
+        StartDetailsPreview(fileInfo.id);
+        return;
+    }
+    StartPreview(fileInfo);
+}
+
+// Vollständige Zeile im Worker nachladen, danach lädt OnPreviewLoaded die Vorschau
+void FileBrowser::StartDetailsPreview(const std::string& id) {
+    std::ofstream log("debug.log", std::ios::app);
+    auto job = std::make_shared<PreviewJob>();
+    job->detailsId = id;
+    job->generation = previewGeneration_;
+    job->target = hPreview_;
+    preview_ = job;
+    log << "Lade Details async...\n";
+    PreviewJob::Start(job);
+    InvalidateRect(hPreview_, NULL, TRUE);
+}
+
+// Ersetzt die schlanke Zeile in index_ (über die ID: der Index kann sich seit
+// der Auswahl geändert haben)
+void FileBrowser::ApplyDetails(const storagedata::FileInfo& info, size_t hintRow) {
+    size_t row = index_.Find(info.id, hintRow);
+    if (row != AttachmentIndex::NOT_FOUND) index_.Update(row, info);
+}
+
+// Ein laufendes Vorausladen übernehmen (true: OnPrefetched zeigt das Bild an);
+// ein noch wartendes verwerfen, dann lädt die Auswahl normal (vor allen Prefetches)
+bool FileBrowser::TakeOverPrefetch(const storagedata::FileInfo& fileInfo) {
+    auto pending = prefetching_.find(fileInfo.id);
+    if (pending == prefetching_.end()) return false;
+    int queued = PrefetchItem::QUEUED;
+    if (pending->second->state.compare_exchange_strong(queued, PrefetchItem::CANCELLED)) {
+        prefetching_.erase(pending);
+        return false;
+    }
+    std::ofstream log("debug.log", std::ios::app);
+    log << "Übernehme laufendes Vorausladen\n";
+    awaitedPrefetch_ = fileInfo.id;
+    if (!fileInfo.thumbnailPath.empty()) previewCache_.Get(fileInfo.thumbnailPath, currentImage_);
+    InvalidateRect(hPreview_, NULL, TRUE);
+    return true;
+}
+
+// Vorschau für eine Zeile mit Storage-Pfaden: Cache nutzen, sonst Thumbnail
+// bzw. Original im Hintergrund laden
+void FileBrowser::StartPreview(const storagedata::FileInfo& fileInfo) {
+    std::ofstream log("debug.log", std::ios::app);
+    log << "StoragePath: " << fileInfo.storagePath << "\n";
+
+    // Kürzlich angesehene Bilder liegen schon dekodiert vor
+    if (previewCache_.Get(fileInfo.storagePath, currentImage_)) {
+        log << "Preview cache hit (" << previewCache_.Size() << " Bilder, " << (previewCache_.Cost() / 1024) << " KB)\n";
         InvalidateRect(hPreview_, NULL, TRUE);
         return;
     }
-    log << "Signed URL: " << signedUrl.substr(0, 100) << "...\n";
 
-    // Bild herunterladen
-    log << "Downloading image...\n";
-    currentImage_ = DownloadImage(signedUrl);
-    if (currentImage_) {
-        log << "SUCCESS: Image downloaded and loaded!\n";
-    } else {
-        log << "ERROR: Failed to download/load image\n";
+    // Thumbnail zuerst (klein, schnell sichtbar). Das Original nur, wenn das
+    // Thumbnail fürs Panel zu klein ist oder das Original schon auf der Platte liegt.
+    RECT panel;
+    GetClientRect(hPreview_, &panel);
+    int panelWidth = panel.right - panel.left;
+    int panelHeight = panel.bottom - panel.top;
+
+    auto job = std::make_shared<PreviewJob>();
+    job->fullPath = fileInfo.storagePath;
+    const std::string& thumbnailPath = fileInfo.thumbnailPath;
+    if (!thumbnailPath.empty() && thumbnailPath != fileInfo.storagePath && !DiskCache::Instance().Contains(fileInfo.storagePath)) {
+        if (previewCache_.Get(thumbnailPath, currentImage_)) {
+            log << "Thumbnail aus dem Preview-Cache\n";
+            if (CoversPanel(*currentImage_, panelWidth, panelHeight)) {
+                InvalidateRect(hPreview_, NULL, TRUE);
+                return;
+            }
+        } else {
+            job->thumbnailPath = thumbnailPath;
+        }
+    }
+
+    log << "Fetching image async (thumbnail: " << (job->thumbnailPath.empty() ? "nein" : "ja") << ")...\n";
+    job->generation = previewGeneration_;
+    job->target = hPreview_;
+    job->panelWidth = panelWidth;
+    job->panelHeight = panelHeight;
+    preview_ = job;
+    PreviewJob::Start(job);
+
+    // Preview neu zeichnen (ggf. Thumbnail aus dem Cache)
+    InvalidateRect(hPreview_, NULL, TRUE);
+}
+
+void FileBrowser::OnPreviewLoaded(unsigned generation) {
+    if (generation != previewGeneration_ || !preview_) return;
+
+    std::shared_ptr<Gdiplus::Bitmap> thumbnail, full;
+    storagedata::FileInfo details;
+    bool hasDetails;
+    bool done;
+    {
+        std::lock_guard<std::mutex> lock(preview_->mutex);
+        thumbnail = std::move(preview_->thumbnail);
+        full = std::move(preview_->full);
+        hasDetails = preview_->hasDetails;
+        if (hasDetails) details = std::move(preview_->details);
+        done = preview_->done;
+    }
+
+    // Details sind da: Zeile übernehmen und das Bild wie gewohnt laden
+    if (hasDetails) {
+        preview_.reset();
+        ApplyDetails(details);
+        StartPreview(details);
+        return;
     }
 
-    // Preview neu zeichnen
+    std::ofstream log("debug.log", std::ios::app);
+    if (thumbnail) {
+        previewCache_.Put(preview_->thumbnailPath, thumbnail, (size_t)thumbnail->GetWidth() * thumbnail->GetHeight() * 4);
+        // Thumbnail nie über ein schon angezeigtes Original legen
+        if (!currentImage_ || currentImage_->GetWidth() < thumbnail->GetWidth()) currentImage_ = thumbnail;
+        log << "Preview: Thumbnail " << thumbnail->GetWidth() << "x" << thumbnail->GetHeight() << "\n";
+    }
+    if (full) {
+        previewCache_.Put(preview_->fullPath, full, (size_t)full->GetWidth() * full->GetHeight() * 4);
+        currentImage_ = full;
+        log << "Preview: Original " << full->GetWidth() << "x" << full->GetHeight() << "\n";
+    }
+    if (done) {
+        if (!currentImage_) log << "ERROR: Failed to download/load image\n";
+        preview_.reset();
+    }
     InvalidateRect(hPreview_, NULL, TRUE);
 }
+
+// Lädt die nächsten Bilder in Blätterrichtung (signierte URL, Bytes in den
+// DiskCache, dekodiert in Panelgröße) mit niedriger Priorität vor. Nach einem
+// Sprung beide direkten Nachbarn; nicht mehr benötigte Vorausladungen verwerfen.
+void FileBrowser::SchedulePrefetch(int fileIndex) {
+    auto now = std::chrono::steady_clock::now();
+    int step = fileIndex - lastSelection_;
+    bool fast = lastSelection_ >= 0 && now - lastSelectionTime_ < FAST_BROWSE_DWELL;
+    lastSelection_ = fileIndex;
+    lastSelectionTime_ = now;
+
+    std::vector<int> targets;
+    if (step == 1 || step == -1) {
+        int ahead = fast ? PREFETCH_AHEAD_FAST : PREFETCH_AHEAD;
+        for (int i = 1; i <= ahead; ++i) targets.push_back(fileIndex + step * i);
+    } else {
+        targets.push_back(fileIndex + 1);
+        targets.push_back(fileIndex - 1);
+    }
+
+    // Gewünschte Nachbarn nach Zeilen-ID; schon dekodierte Bilder überspringen
+    std::vector<std::shared_ptr<PrefetchItem>> items;
+    std::unordered_set<std::string> wanted;
+    for (int target : targets) {
+        if (target < 0 || target >= (int)visibleRows_.size()) continue;
+        size_t row = visibleRows_[target];
+        storagedata::FileInfo info = index_.Get(row);
+        if (!info.IsImage() || (info.HasDetails() && previewCache_.Contains(info.storagePath))) continue;
+        if (!wanted.insert(info.id).second || prefetching_.count(info.id)) continue;
+        auto item = std::make_shared<PrefetchItem>();
+        item->id = info.id;
+        item->path = info.storagePath;
+        item->row = row;
+        items.push_back(item);
+    }
+
+    for (auto it = prefetching_.begin(); it != prefetching_.end();) {
+        if (wanted.count(it->first) || it->first == awaitedPrefetch_) {
+            ++it;
+            continue;
+        }
+        it->second->state = PrefetchItem::CANCELLED;
+        it = prefetching_.erase(it);
+    }
+
+    RECT panel;
+    GetClientRect(hPreview_, &panel);
+    int panelWidth = panel.right - panel.left;
+    int panelHeight = panel.bottom - panel.top;
+    HWND hwndTarget = hPreview_;
+
+    // Herunterladen (signierte URL, DiskCache) und in Panelgröße dekodieren
+    auto run = [hwndTarget, panelWidth, panelHeight](const std::shared_ptr<PrefetchItem>& item, const std::string& path) {
+        int queued = PrefetchItem::QUEUED;
+        if (!item->state.compare_exchange_strong(queued, PrefetchItem::RUNNING)) return;
+
+        std::string data;
+        if (!FetchPreview(path, panelWidth, panelHeight, data) || item->state == PrefetchItem::CANCELLED) {
+            item->Finish(nullptr, hwndTarget);
+            return;
+        }
+        DecodePool().Submit([item, hwndTarget, panelWidth, panelHeight, data = std::move(data)]() {
+            std::shared_ptr<Gdiplus::Bitmap> image;
+            if (item->state != PrefetchItem::CANCELLED) image = DecodeImage(data, panelWidth, panelHeight);
+            item->Finish(image, hwndTarget);
+        }, ThreadPool::Priority::LOW);
+    };
+
+    std::vector<std::shared_ptr<PrefetchItem>> slim;
+    for (const auto& item : items) {
+        prefetching_[item->id] = item;
+        if (item->path.empty()) {
+            slim.push_back(item);
+            continue;
+        }
+        PreviewPool().Submit([run, item]() { run(item, item->path); }, ThreadPool::Priority::LOW);
+    }
+    if (slim.empty()) return;
+
+    // Schlanke Zeilen: Details aller Nachbarn mit einem Request (id=in.(...)),
+    // Pfade per Batch signieren, dann wie oben laden
+    PreviewPool().Submit([run, slim, hwndTarget]() {
+        std::vector<std::string> ids;
+        for (const auto& item : slim) {
+            if (item->state == PrefetchItem::QUEUED) ids.push_back(item->id);
+        }
+        std::vector<storagedata::FileInfo> rows;
+        std::string err;
+        if (!ids.empty() && !storagedata::FetchFilesByIds(ids, rows, &err)) {
+            std::ofstream log("debug.log", std::ios::app);
+            log << "ERROR: Prefetch-Details fehlgeschlagen: " << err << "\n";
+            rows.clear();
+        }
+        storagedata::PrefetchSignedUrls(storagedata::SignablePaths(rows));
+
+        for (const auto& item : slim) {
+            auto found = std::find_if(rows.begin(), rows.end(), [&](const storagedata::FileInfo& info) { return info.id == item->id; });
+            if (found == rows.end() || !found->HasDetails()) {
+                item->Finish(nullptr, hwndTarget);
+                continue;
+            }
+            std::string path = found->storagePath;
+            {
+                std::lock_guard<std::mutex> lock(item->mutex);
+                item->details = std::move(*found);
+                item->hasDetails = true;
+            }
+            run(item, path);
+        }
+    }, ThreadPool::Priority::LOW);
+}
+
+void FileBrowser::OnPrefetched() {
+    std::ofstream log("debug.log", std::ios::app);
+    for (auto it = prefetching_.begin(); it != prefetching_.end();) {
+        PrefetchItem& item = *it->second;
+        std::shared_ptr<Gdiplus::Bitmap> image;
+        storagedata::FileInfo details;
+        bool hasDetails;
+        {
+            std::lock_guard<std::mutex> lock(item.mutex);
+            if (!item.done) {
+                ++it;
+                continue;
+            }
+            image = std::move(item.image);
+            hasDetails = item.hasDetails;
+            if (hasDetails) details = std::move(item.details);
+        }
+
+        // Im Worker nachgeladene Details in den Index übernehmen
+        std::string path = item.path;
+        if (hasDetails) {
+            path = details.storagePath;
+            ApplyDetails(details, item.row);
+        }
+        if (image) {
+            previewCache_.Put(path, image, (size_t)image->GetWidth() * image->GetHeight() * 4);
+            log << "Prefetch: " << path << " " << image->GetWidth() << "x" << image->GetHeight() << "\n";
+        } else {
+            log << "Prefetch fehlgeschlagen: " << item.id << "\n";
+        }
+        if (item.id == awaitedPrefetch_) {
+            awaitedPrefetch_.clear();
+            if (image) {
+                currentImage_ = image;
+                InvalidateRect(hPreview_, NULL, TRUE);
+            } else {
+                // Übernommenes Vorausladen gescheitert: die Auswahl normal laden
+                log << "Übernommenes Vorausladen fehlgeschlagen, lade normal\n";
+                size_t row = hasDetails ? AttachmentIndex::NOT_FOUND : index_.Find(item.id, item.row);
+                if (!hasDetails && row != AttachmentIndex::NOT_FOUND) details = index_.Get(row);
+                if (details.HasDetails()) StartPreview(details);
+                else StartDetailsPreview(item.id);
+            }
+        }
+        it = prefetching_.erase(it);
+    }
+}
+
+// "Speichern unter...": Ziel wählen, Download läuft im DownloadPool direkt in die Datei
+void FileBrowser::SaveAttachment(int fileIndex) {
+    std::ofstream log("debug.log", std::ios::app);
+    log << "\n=== SaveAttachment called, fileIndex=" << fileIndex << " ===\n";
+
+    if (download_) {
+        MessageBoxW(hwnd_, L"Es läuft bereits ein Download", L"Info", MB_OK);
+        return;
+    }
+    if (fileIndex < 0 || fileIndex >= (int)visibleRows_.size()) return;
+
+    // Schlanke Zeile: die Details lädt der Download-Worker nach
+    storagedata::FileInfo fileInfo = index_.Get(visibleRows_[fileIndex]);
+
+    // Unterbrochener Download dieser Datei (auch aus einer früheren Sitzung):
+    // fortsetzen geht nur ins selbe Ziel. "Nein" verwirft den Teil-Download, sonst
+    // setzte FileDownloader bei erneuter Wahl dieses Ziels trotzdem fort.
+    std::filesystem::path pending;
+    bool resume = false;
+    if (PendingDownloads::Instance().Find(fileInfo.id, pending)) {
+        std::wstring question = L"Der Download nach\n" + pending.wstring() + L"\nwurde unterbrochen. Dort fortsetzen?";
+        int answer = MessageBoxW(hwnd_, question.c_str(), L"Download", MB_YESNOCANCEL | MB_ICONQUESTION);
+        if (answer == IDCANCEL) return;
+        resume = answer == IDYES;
+        if (!resume) {
+            log << "Teil-Download verworfen\n";
+            FileDownloader::DiscardPartial(pending);
+            PendingDownloads::Instance().Remove(fileInfo.id);
+        }
+    }
+
+    std::wstring target;
+    if (resume) {
+        target = pending.wstring();
+    } else {
+        // Pfadpuffer in voller Länge (lange Pfade), Dateiname als Vorschlag
+        std::vector<WCHAR> fileName(32768, 0);
+        std::wstring suggested = Utf8ToUtf16(fileInfo.fileName);
+        if (suggested.size() < fileName.size()) std::copy(suggested.begin(), suggested.end(), fileName.begin());
+
+        OPENFILENAMEW ofn = {};
+        ofn.lStructSize = sizeof(ofn);
+        ofn.hwndOwner = hwnd_;
+        ofn.lpstrFile = fileName.data();
+        ofn.nMaxFile = (DWORD)fileName.size();
+        ofn.lpstrFilter = L"Alle Dateien\0*.*\0";
+        ofn.Flags = OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST | OFN_NOCHANGEDIR;
+        if (!GetSaveFileNameW(&ofn)) return;
+        target = fileName.data();
+    }
+
+    auto job = std::make_shared<DownloadJob>();
+    job->fileId = fileInfo.id;
+    job->storagePath = fileInfo.storagePath;
+    job->target = target;
+    HWND root = GetAncestor(hwnd_, GA_ROOT);
+    WCHAR title[256] = {};
+    GetWindowTextW(root, title, 256);
+    job->savedTitle = title;
+    download_ = job;
+    log << "Download nach Datei: " << fileInfo.id << " (" << fileInfo.fileSize << " bytes)\n";
+
+    HWND hwndTarget = hwnd_;
+    DownloadPool().Submit([job, hwndTarget]() {
+        if (job->storagePath.empty()) {
+            storagedata::FileInfo info;
+            info.id = job->fileId;
+            if (!storagedata::FetchFileDetails(info, &job->error)) {
+                job->error = "Dateidetails laden fehlgeschlagen: " + job->error;
+                PostMessage(hwndTarget, WM_APP_DOWNLOAD_DONE, 0, 0);
+                return;
+            }
+            job->storagePath = info.storagePath;
+            job->details = std::move(info);
+            job->hasDetails = true;
+        }
+        std::string signedUrl = GenerateSignedUrl(job->storagePath);
+        if (signedUrl.empty()) {
+            job->error = "Signierte URL konnte nicht erzeugt werden";
+        } else {
+            FileDownloader::Options options;
+            options.onProgress = [job, hwndTarget](uint64_t received, int64_t total) {
+                if (total > 0) {
+                    int percent = (int)(received * 100 / (uint64_t)total);
+                    if (job->percent.exchange(percent) != percent) {
+                        PostMessage(hwndTarget, WM_APP_DOWNLOAD_PROGRESS, (WPARAM)percent, 0);
+                    }
+                }
+                return !job->cancelled;
+            };
+            // Bis zum Erfolg vorgemerkt: nach Abbruch oder Neustart bietet SaveAttachment das Fortsetzen an
+            std::filesystem::path target(job->target);
+            PendingDownloads::Instance().Add(job->fileId, target);
+            job->ok = FileDownloader::Download(signedUrl, target, options, &job->error);
+            if (job->ok) PendingDownloads::Instance().Remove(job->fileId);
+        }
+        PostMessage(hwndTarget, WM_APP_DOWNLOAD_DONE, 0, 0);
+    });
+}
+
+void FileBrowser::OnDownloadProgress(int percent) {
+    if (!download_) return;
+    std::wstring title = download_->savedTitle + L" - Download " + std::to_wstring(percent) + L" %";
+    SetWindowTextW(GetAncestor(hwnd_, GA_ROOT), title.c_str());
+}
+
+void FileBrowser::OnDownloadFinished() {
+    if (!download_) return;
+    std::shared_ptr<DownloadJob> job = std::move(download_);
+    SetWindowTextW(GetAncestor(hwnd_, GA_ROOT), job->savedTitle.c_str());
+    if (job->hasDetails) ApplyDetails(job->details);
+
+    std::ofstream log("debug.log", std::ios::app);
+    if (job->ok) {
+        log << "Download fertig: " << job->storagePath << "\n";
+        MessageBoxW(hwnd_, (L"Gespeichert: " + job->target).c_str(), L"Download", MB_OK);
+    } else {
+        log << "ERROR: Download fehlgeschlagen: " << job->error << "\n";
+        MessageBoxW(hwnd_, Utf8ToUtf16("Download fehlgeschlagen: " + job->error).c_str(), L"Fehler", MB_OK | MB_ICONERROR);
+    }
+}
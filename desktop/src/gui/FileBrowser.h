@@ -1,9 +1,14 @@
 #pragma once
 #include <windows.h>
 #include <gdiplus.h>
+#include <chrono>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "../storagedata.h"
+#include "../storage/AttachmentIndex.h"
+#include "../util/LruCache.h"
 
 class FileBrowser {
 public:
@@ -11,6 +16,12 @@ public:
     ~FileBrowser();
     void Show(HINSTANCE hInstance, HWND hParent);
     void Hide();
+
+    // Speicherbudget für dekodierte Vorschaubilder (Standard 128 MB)
+    static const size_t DEFAULT_PREVIEW_CACHE_BYTES = 128 * 1024 * 1024;
+    // JPEG/WebP-Qualität der serverseitig verkleinerten Vorschau
+    static const int PREVIEW_QUALITY = 75;
+    void SetPreviewCacheBudget(size_t bytes);
 private:
     static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
     static LRESULT CALLBACK PreviewProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
@@ -18,10 +29,50 @@ private:
     HWND hTab_ = nullptr;
     HWND hList_ = nullptr;
     HWND hPreview_ = nullptr;
-    Gdiplus::Image* currentImage_ = nullptr;
-    std::vector<storagedata::FileInfo> currentFiles_;  // Cache der aktuellen Dateien
-    void PopulateList(int tabIndex);
-    void LoadImagePreview(int fileIndex);  // Lade Preview anhand Index in currentFiles_
-    std::string GenerateSignedUrl(const std::string& storagePath);  // Generiere Supabase signed URL
-    Gdiplus::Image* DownloadImage(const std::string& url);  // Lade Bild via WinHTTP
+    std::shared_ptr<Gdiplus::Bitmap> currentImage_;
+    // currentImage_ eingepasst auf Panelgröße und Hintergrund; WM_PAINT blittet nur
+    HBITMAP scaledPreview_ = nullptr;
+    std::shared_ptr<Gdiplus::Bitmap> scaledSource_;     // Bild, aus dem scaledPreview_ entstand
+    int scaledWidth_ = 0;
+    int scaledHeight_ = 0;
+    bool UpdateScaledPreview(int panelWidth, int panelHeight);  // Nur bei neuem Bild/neuer Panelgröße
+    void ReleaseScaledPreview();
+    LruCache<std::string, std::shared_ptr<Gdiplus::Bitmap>> previewCache_;  // Storage-Pfad -> dekodiertes Bild
+    AttachmentIndex index_;                             // Alle Dateien (ein Listing für alle Tabs)
+    AttachmentIndex::Query currentQuery_;               // Facetten des aktiven Tabs
+    std::vector<size_t> visibleRows_;                   // Listbox-Eintrag -> Zeile in index_
+    std::shared_ptr<storagedata::ListingStream> listing_;  // Laufender Sync des Gesamt-Listings
+    unsigned listGeneration_ = 0;                       // Verwirft Ergebnisse abgelöster Syncs
+    bool listPlaceholder_ = false;                      // "Lade Dateien..." wird noch angezeigt
+    void PopulateList(int tabIndex);                    // Tab lokal filtern, Sync asynchron starten
+    void RenderList(const std::string& selectedId);     // Listbox aus index_ neu aufbauen
+    void OnListingProgress(unsigned generation);        // UI-Thread: neue Seiten übernehmen
+    struct PreviewJob;                                  // Laufendes Laden der Vorschau (Worker -> UI)
+    std::shared_ptr<PreviewJob> preview_;
+    unsigned previewGeneration_ = 0;                    // Verwirft Ergebnisse abgelöster Vorschauen
+    void LoadImagePreview(int fileIndex);  // Lade Preview anhand Index in visibleRows_
+    void StartPreview(const storagedata::FileInfo& fileInfo);  // Details bekannt: Cache prüfen, sonst laden
+    void StartDetailsPreview(const std::string& id);  // Schlanke Zeile: erst Details im Worker laden
+    void ApplyDetails(const storagedata::FileInfo& info, size_t hintRow = AttachmentIndex::NOT_FOUND);  // Im Worker nachgeladene Zeile in index_
+    void OnPreviewLoaded(unsigned generation);          // UI-Thread: Thumbnail bzw. Original anzeigen
+    // Vorausladen der Nachbarn in Blätterrichtung (niedrige Priorität)
+    struct PrefetchItem;
+    std::unordered_map<std::string, std::shared_ptr<PrefetchItem>> prefetching_;  // Zeilen-ID -> Vorausladen
+    std::string awaitedPrefetch_;                       // Auswahl übernimmt dieses laufende Vorausladen (Zeilen-ID)
+    bool TakeOverPrefetch(const storagedata::FileInfo& fileInfo);  // Läuft es schon? Dann darauf warten
+    int lastSelection_ = -1;
+    std::chrono::steady_clock::time_point lastSelectionTime_;
+    void SchedulePrefetch(int fileIndex);               // Nach jeder Auswahl: Richtung/Verweildauer auswerten
+    void OnPrefetched();                                // UI-Thread: fertige Bilder in previewCache_
+    // "Speichern unter...": Attachment direkt auf die Platte (nie komplett im Speicher)
+    struct DownloadJob;
+    std::shared_ptr<DownloadJob> download_;             // Laufender Download (höchstens einer)
+    void SaveAttachment(int fileIndex);
+    void OnDownloadProgress(int percent);               // UI-Thread: Fortschritt im Fenstertitel
+    void OnDownloadFinished();                          // UI-Thread: Titel zurücksetzen, Ergebnis melden
+    // Thread-safe (laufen auch im Vorschau-Worker)
+    static std::string GenerateSignedUrl(const std::string& storagePath);  // Generiere Supabase signed URL
+    static bool FetchAttachment(const std::string& storagePath, std::string& outData);  // Disk-Cache, sonst Download
+    static bool FetchPreview(const std::string& storagePath, int width, int height, std::string& outData);  // In Panelgröße
+    static std::shared_ptr<Gdiplus::Bitmap> DecodeImage(const std::string& imageData, int maxWidth = 0, int maxHeight = 0);
 };
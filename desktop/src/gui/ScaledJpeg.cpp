@@ -0,0 +1,119 @@
+#include "ScaledJpeg.h"
+#include "WicSupport.h"
+#include "../util/ImageResample.h"
+#include <vector>
+
+namespace ScaledJpeg {
+
+// Gibt das Interface am Ende des Blocks frei
+template <typename T>
+struct ComRef {
+    T* p = nullptr;
+    ComRef() = default;
+    ComRef(const ComRef&) = delete;
+    ComRef& operator=(const ComRef&) = delete;
+    ~ComRef() { if (p) p->Release(); }
+    T* operator->() const { return p; }
+};
+
+bool IsJpeg(const std::string& data) {
+    return data.size() > 3 && (unsigned char)data[0] == 0xFF && (unsigned char)data[1] == 0xD8 &&
+           (unsigned char)data[2] == 0xFF;
+}
+
+std::shared_ptr<Gdiplus::Bitmap> Decode(const std::string& data, int boxWidth, int boxHeight, std::string* lastError) {
+    if (!IsJpeg(data) || boxWidth <= 0 || boxHeight <= 0) {
+        if (lastError) *lastError = "Kein JPEG";
+        return nullptr;
+    }
+
+    ComRef<IWICImagingFactory> factory;
+    ComRef<IWICStream> stream;
+    ComRef<IWICBitmapDecoder> decoder;
+    ComRef<IWICBitmapFrameDecode> frame;
+    GUID container;
+    if (!(factory.p = WicSupport::CreateFactory()) ||
+        !(stream.p = WicSupport::CreateMemoryStream(factory.p, data.data(), data.size())) ||
+        FAILED(factory->CreateDecoderFromStream(stream.p, NULL, WICDecodeMetadataCacheOnDemand, &decoder.p)) ||
+        FAILED(decoder->GetContainerFormat(&container)) || container != GUID_ContainerFormatJpeg ||
+        FAILED(decoder->GetFrame(0, &frame.p))) {
+        if (lastError) *lastError = "WIC-Decoder nicht verfügbar";
+        return nullptr;
+    }
+
+    UINT width = 0, height = 0;
+    if (FAILED(frame->GetSize(&width, &height)) || width == 0 || height == 0) {
+        if (lastError) *lastError = "Ungültige Bildgröße";
+        return nullptr;
+    }
+    UINT denominator = (UINT)ImageResample::ScaleDenominator((int)width, (int)height, boxWidth, boxHeight);
+    if (denominator == 1) {
+        if (lastError) *lastError = "Keine Verkleinerung möglich";
+        return nullptr;
+    }
+
+    ComRef<IWICBitmapSourceTransform> transform;
+    if (FAILED(frame->QueryInterface(IID_IWICBitmapSourceTransform, (void**)&transform.p))) {
+        if (lastError) *lastError = "Decoder skaliert nicht";
+        return nullptr;
+    }
+
+    // Der Decoder rundet auf die nächste Größe, die er im DCT-Bereich erzeugen kann
+    UINT scaledWidth = (width + denominator - 1) / denominator;
+    UINT scaledHeight = (height + denominator - 1) / denominator;
+    WICPixelFormatGUID format = GUID_WICPixelFormat24bppBGR;
+    if (FAILED(transform->GetClosestSize(&scaledWidth, &scaledHeight)) || scaledWidth == 0 || scaledHeight == 0 ||
+        FAILED(transform->GetClosestPixelFormat(&format))) {
+        if (lastError) *lastError = "Skalierte Größe nicht verfügbar";
+        return nullptr;
+    }
+    UINT bytesPerPixel;
+    if (format == GUID_WICPixelFormat24bppBGR) bytesPerPixel = 3;
+    else if (format == GUID_WICPixelFormat8bppGray) bytesPerPixel = 1;
+    else if (format == GUID_WICPixelFormat32bppBGR) bytesPerPixel = 4;
+    else {
+        if (lastError) *lastError = "Pixelformat nicht unterstützt";
+        return nullptr;
+    }
+
+    UINT stride = (scaledWidth * bytesPerPixel + 3) & ~3u;
+    std::vector<BYTE> decoded((size_t)stride * scaledHeight);
+    if (FAILED(transform->CopyPixels(NULL, scaledWidth, scaledHeight, &format, WICBitmapTransformRotate0,
+                                     stride, (UINT)decoded.size(), decoded.data()))) {
+        if (lastError) *lastError = "Skaliertes Dekodieren fehlgeschlagen";
+        return nullptr;
+    }
+
+    // JPEG ist deckend: BGR/Grau -> BGRA mit Alpha 255 (= vormultipliziert)
+    std::vector<uint8_t> pixels((size_t)scaledWidth * scaledHeight * 4);
+    for (UINT y = 0; y < scaledHeight; ++y) {
+        const BYTE* in = &decoded[(size_t)y * stride];
+        uint8_t* out = &pixels[(size_t)y * scaledWidth * 4];
+        for (UINT x = 0; x < scaledWidth; ++x, in += bytesPerPixel, out += 4) {
+            out[0] = in[0];
+            out[1] = bytesPerPixel == 1 ? in[0] : in[1];
+            out[2] = bytesPerPixel == 1 ? in[0] : in[2];
+            out[3] = 255;
+        }
+    }
+    decoded.clear();
+    decoded.shrink_to_fit();
+
+    int targetWidth, targetHeight;
+    ImageResample::FitSize((int)scaledWidth, (int)scaledHeight, boxWidth, boxHeight, targetWidth, targetHeight);
+    auto bitmap = std::make_shared<Gdiplus::Bitmap>(targetWidth, targetHeight, PixelFormat32bppPARGB);
+    Gdiplus::Rect rect(0, 0, targetWidth, targetHeight);
+    Gdiplus::BitmapData target;
+    if (bitmap->GetLastStatus() != Gdiplus::Ok ||
+        bitmap->LockBits(&rect, Gdiplus::ImageLockModeWrite, PixelFormat32bppPARGB, &target) != Gdiplus::Ok) {
+        if (lastError) *lastError = "Bitmap anlegen fehlgeschlagen";
+        return nullptr;
+    }
+    ImageResample::Resize(pixels.data(), (int)scaledWidth, (int)scaledHeight, (ptrdiff_t)scaledWidth * 4,
+                          (uint8_t*)target.Scan0, targetWidth, targetHeight, target.Stride,
+                          ImageResample::Filter::Lanczos3);
+    bitmap->UnlockBits(&target);
+    return bitmap;
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <windows.h>
+#include <gdiplus.h>
+#include <memory>
+#include <string>
+
+// JPEGs direkt verkleinert dekodieren: der WIC-JPEG-Decoder skaliert über
+// IWICBitmapSourceTransform im DCT-Bereich auf 1/2, 1/4 oder 1/8, ohne jemals
+// alle Pixel des Originals zu erzeugen. Gewählt wird die kleinste Stufe, die
+// die Box noch füllt; der Rest wird mit ImageResample eingepasst.
+// Thread-safe (initialisiert COM pro Thread bei Bedarf, siehe WicSupport).
+namespace ScaledJpeg {
+    bool IsJpeg(const std::string& data);  // SOI-Marker FF D8 FF
+
+    // nullptr, wenn kein JPEG, keine Verkleinerung möglich (Stufe 1/1) oder
+    // WIC das Format nicht liefert (z.B. CMYK) -> normaler GDI+-Pfad
+    std::shared_ptr<Gdiplus::Bitmap> Decode(const std::string& data, int boxWidth, int boxHeight,
+                                            std::string* lastError = nullptr);
+}
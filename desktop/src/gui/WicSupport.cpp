@@ -0,0 +1,33 @@
+#include "WicSupport.h"
+
+#pragma comment(lib, "windowscodecs.lib")
+
+namespace WicSupport {
+
+bool EnsureCom() {
+    thread_local HRESULT result = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+    return SUCCEEDED(result) || result == RPC_E_CHANGED_MODE;
+}
+
+IWICImagingFactory* CreateFactory() {
+    if (!EnsureCom()) return nullptr;
+    IWICImagingFactory* factory = nullptr;
+    if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, IID_IWICImagingFactory, (void**)&factory))) {
+        return nullptr;
+    }
+    return factory;
+}
+
+IWICStream* CreateMemoryStream(IWICImagingFactory* factory, const void* data, size_t size) {
+    if (!factory || size > 0xFFFFFFFFu) return nullptr;
+    IWICStream* stream = nullptr;
+    if (FAILED(factory->CreateStream(&stream))) return nullptr;
+    // WIC liest nur; der Parameter ist lediglich nicht const deklariert
+    if (FAILED(stream->InitializeFromMemory((BYTE*)data, (DWORD)size))) {
+        stream->Release();
+        return nullptr;
+    }
+    return stream;
+}
+
+}
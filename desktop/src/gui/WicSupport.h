@@ -0,0 +1,20 @@
+#pragma once
+#include <windows.h>
+#include <objbase.h>
+#include <wincodec.h>
+#include <cstddef>
+
+// Gemeinsame Helfer für WIC (Windows Imaging Component) in den Decode-Workern
+namespace WicSupport {
+    // COM für den aufrufenden Thread (einmalig pro Thread, nie wieder freigegeben:
+    // die Worker leben so lange wie der Prozess). Ein Thread mit anderem
+    // Apartment (UI-Thread: STA) kann WIC trotzdem nutzen.
+    bool EnsureCom();
+
+    // Neue Factory (AddRef'd) oder nullptr
+    IWICImagingFactory* CreateFactory();
+
+    // IStream über vorhandenen Speicher ohne Kopie (auch für GDI+ FromStream).
+    // Der Speicher muss den Stream und alles, was daraus liest, überleben.
+    IWICStream* CreateMemoryStream(IWICImagingFactory* factory, const void* data, size_t size);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace net {
+    struct HttpResponse;
+
+    // Ziel eines Antwort-Bodys. Die Backends lesen über Prepare/Commit direkt in
+    // den Speicher der Senke (kein Zwischenpuffer, keine spätere Kopie). Begin
+    // kommt genau einmal vor den Daten und nennt Content-Length, damit die Senke
+    // ihr Ziel vorab in voller Größe anlegen kann.
+    // Eine Senke gehört zu genau einem Request (nicht thread-safe).
+    class BodySink {
+    public:
+        virtual ~BodySink() = default;
+
+        // status/headers der Antwort sind gesetzt; expectedSize = Content-Length,
+        // -1 wenn unbekannt (chunked/bis Verbindungsende). false bricht ab.
+        virtual bool Begin(const HttpResponse& response, int64_t expectedSize) {
+            (void)response;
+            (void)expectedSize;
+            return true;
+        }
+
+        // Speicher am Ziel für size Bytes; die Senke darf size verkleinern (nie
+        // auf 0, z.B. bis zum Ende ihres Puffers). nullptr bricht ab. Danach folgt
+        // Commit mit der tatsächlich geschriebenen Menge (oder Abbruch).
+        virtual char* Prepare(size_t& size) = 0;
+        virtual bool Commit(size_t size) = 0;
+
+        // Für Backends mit eigenem Empfangspuffer: eine Kopie
+        bool Write(const char* data, size_t size) {
+            while (size > 0) {
+                size_t chunk = size;
+                char* target = Prepare(chunk);
+                if (!target || chunk == 0) return false;
+                memcpy(target, data, chunk);
+                if (!Commit(chunk)) return false;
+                data += chunk;
+                size -= chunk;
+            }
+            return true;
+        }
+    };
+
+    // Sammelt den Body in einem String, vorab auf Content-Length reserviert.
+    // Der String ist danach direkt nutzbar (z.B. per std::move weitergeben).
+    class StringSink : public BodySink {
+    public:
+        explicit StringSink(std::string& target) : target_(target) {}
+
+        bool Begin(const HttpResponse&, int64_t expectedSize) override {
+            target_.clear();
+            // Obergrenze: eine falsche Längenangabe soll keinen Riesenblock anlegen
+            if (expectedSize > 0 && expectedSize <= MAX_RESERVE) target_.reserve((size_t)expectedSize);
+            return true;
+        }
+
+        char* Prepare(size_t& size) override {
+            committed_ = target_.size();
+            target_.resize(committed_ + size);
+            return &target_[0] + committed_;
+        }
+
+        bool Commit(size_t size) override {
+            target_.resize(committed_ + size);
+            return true;
+        }
+
+    private:
+        static const int64_t MAX_RESERVE = 1024LL * 1024 * 1024;
+        std::string& target_;
+        size_t committed_ = 0;
+    };
+
+    // Übergibt den Body stückweise an eine Funktion (HttpRequest::onBody)
+    class CallbackSink : public BodySink {
+    public:
+        explicit CallbackSink(std::function<bool(const char* data, size_t size)> callback)
+            : callback_(std::move(callback)) {}
+
+        char* Prepare(size_t& size) override {
+            if (scratch_.size() < size) scratch_.resize(size);
+            return scratch_.data();
+        }
+
+        bool Commit(size_t size) override {
+            return size == 0 || callback_(scratch_.data(), size);
+        }
+
+    private:
+        std::function<bool(const char* data, size_t size)> callback_;
+        std::vector<char> scratch_;
+    };
+}
@@ -0,0 +1,135 @@
+#include "FileSink.h"
+#include <algorithm>
+#include "HttpClient.h"
+#include "../util/OutputFile.h"
+
+namespace net {
+    FileSink::FileSink(OutputFile& file, uint64_t offset, Options options)
+        : file_(file), offset_(offset), options_(std::move(options)), position_(offset) {
+        options_.bufferSize = std::max<size_t>(options_.bufferSize, 4096);
+        options_.bufferCount = std::max<size_t>(options_.bufferCount, 2);
+        buffers_.resize(options_.bufferCount);
+        for (auto& buffer : buffers_) buffer.data.reset(new char[options_.bufferSize]);
+        buffers_[0].offset = offset_;
+        writer_ = std::thread([this] { WriterLoop(); });
+    }
+
+    FileSink::~FileSink() {
+        // Ohne Finish: Abbruch, bereits übergebene Puffer schreibt der Thread noch
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        queuedChanged_.notify_all();
+        if (writer_.joinable()) writer_.join();
+    }
+
+    bool FileSink::Begin(const HttpResponse& response, int64_t expectedSize) {
+        if (!response.IsSuccess()) {
+            // Fehlerseite des Servers gehört nicht in die Datei
+            discard_ = true;
+            return true;
+        }
+        expectedSize_ = expectedSize;
+        if (options_.preallocate && expectedSize > 0) {
+            std::string error;
+            if (!file_.Preallocate(offset_ + (uint64_t)expectedSize, &error)) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                failed_ = true;
+                error_ = error;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    char* FileSink::Prepare(size_t& size) {
+        if (discard_) {
+            size = std::min(size, sizeof(discardBuffer_));
+            return discardBuffer_;
+        }
+        // Commit gibt volle Puffer sofort ab: im aktuellen ist immer Platz
+        Buffer& buffer = buffers_[fill_];
+        size = std::min(size, options_.bufferSize - buffer.used);
+        return buffer.data.get() + buffer.used;
+    }
+
+    bool FileSink::Commit(size_t size) {
+        if (discard_) return true;
+        Buffer& buffer = buffers_[fill_];
+        buffer.used += size;
+        position_ += size;
+        if (buffer.used < options_.bufferSize) return true;
+
+        if (!Submit()) return false;
+        if (options_.onProgress && !options_.onProgress(position_, expectedSize_ < 0 ? -1 : (int64_t)offset_ + expectedSize_)) {
+            cancelled_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool FileSink::Submit() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (buffers_[fill_].used == 0) return !failed_;
+        ++queued_;
+        queuedChanged_.notify_all();
+
+        // Nächster Puffer ist frei, sobald weniger als alle beim Schreib-Thread liegen
+        fill_ = (fill_ + 1) % buffers_.size();
+        queuedChanged_.wait(lock, [this] { return queued_ < buffers_.size() || failed_; });
+        buffers_[fill_].used = 0;
+        buffers_[fill_].offset = position_;
+        return !failed_;
+    }
+
+    void FileSink::WriterLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            queuedChanged_.wait(lock, [this] { return queued_ > 0 || stop_; });
+            if (queued_ == 0) break;
+
+            Buffer& buffer = buffers_[write_];
+            bool skip = failed_;
+            lock.unlock();
+            std::string error;
+            bool ok = skip || file_.WriteAt(buffer.offset, buffer.data.get(), buffer.used, &error);
+            if (ok && !skip && options_.onWritten) options_.onWritten(buffer.offset + buffer.used);
+            lock.lock();
+
+            if (!ok) {
+                failed_ = true;
+                error_ = error;
+            }
+            write_ = (write_ + 1) % buffers_.size();
+            --queued_;
+            queuedChanged_.notify_all();
+        }
+    }
+
+    bool FileSink::Failed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return failed_;
+    }
+
+    bool FileSink::Finish(std::string* lastError) {
+        if (writer_.joinable()) {
+            if (!discard_) Submit();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            queuedChanged_.notify_all();
+            writer_.join();
+
+            if (!failed_ && !discard_ && options_.onProgress) {
+                options_.onProgress(position_, expectedSize_ < 0 ? -1 : (int64_t)offset_ + expectedSize_);
+            }
+        }
+        if (failed_) {
+            if (lastError) *lastError = error_;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BodySink.h"
+
+class OutputFile;
+
+namespace net {
+    // Schreibt den Antwort-Body ab einem Offset in eine Datei. Speicherbedarf
+    // fest: ein Ring aus bufferCount Puffern; das Backend liest direkt in den
+    // aktuellen Puffer, ein Schreib-Thread bringt volle Puffer auf die Platte.
+    // Sind alle Puffer unterwegs (Platte langsamer als Netz), wartet der Empfang.
+    // Nur Antworten mit 2xx werden geschrieben, andere Bodys verworfen.
+    class FileSink : public BodySink {
+    public:
+        // received/total inkl. Startoffset; total = -1 wenn unbekannt.
+        // false bricht den Empfang ab.
+        using ProgressCallback = std::function<bool(uint64_t received, int64_t total)>;
+
+        struct Options {
+            size_t bufferSize = 256 * 1024;
+            size_t bufferCount = 4;
+            bool preallocate = true;        // Datei vorab auf Content-Length vergrößern
+            ProgressCallback onProgress;    // Je vollem Puffer und am Ende
+            // Schreib-Thread: alles bis Dateioffset end ist geschrieben (noch
+            // ohne fsync); z.B. für Checkpoints fortsetzbarer Downloads
+            std::function<void(uint64_t end)> onWritten;
+        };
+
+        FileSink(OutputFile& file, uint64_t offset, Options options);
+        ~FileSink() override;
+        FileSink(const FileSink&) = delete;
+        FileSink& operator=(const FileSink&) = delete;
+
+        bool Begin(const HttpResponse& response, int64_t expectedSize) override;
+        char* Prepare(size_t& size) override;
+        bool Commit(size_t size) override;
+
+        // Nach Send: Rest schreiben und auf den Schreib-Thread warten.
+        // false bei Schreibfehler (Text in lastError).
+        bool Finish(std::string* lastError = nullptr);
+
+        uint64_t Offset() const { return offset_; }
+        uint64_t Written() const { return position_ - offset_; }   // Empfangene Bytes dieses Requests
+        int64_t ExpectedSize() const { return expectedSize_; }
+        bool Cancelled() const { return cancelled_; }
+
+    private:
+        struct Buffer {
+            std::unique_ptr<char[]> data;
+            size_t used = 0;
+            uint64_t offset = 0;    // Dateioffset des ersten Bytes
+        };
+
+        bool Submit();              // Aktuellen Puffer an den Schreib-Thread
+        void WriterLoop();
+        bool Failed();
+
+        OutputFile& file_;
+        const uint64_t offset_;
+        Options options_;
+        uint64_t position_;         // Nächster Dateioffset (empfangen)
+        int64_t expectedSize_ = -1;
+        bool discard_ = false;      // Fehlerstatus: Body nicht schreiben
+        bool cancelled_ = false;
+        char discardBuffer_[4096];
+
+        std::vector<Buffer> buffers_;
+        size_t fill_ = 0;           // Puffer, den das Backend gerade füllt
+        size_t write_ = 0;          // Nächster Puffer für den Schreib-Thread
+        size_t queued_ = 0;         // Volle Puffer ab write_
+        bool stop_ = false;
+        bool failed_ = false;
+        std::string error_;
+        std::mutex mutex_;
+        std::condition_variable queuedChanged_;
+        std::thread writer_;
+    };
+}
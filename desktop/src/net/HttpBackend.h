@@ -0,0 +1,72 @@
+#pragma once
+#include "HttpClient.h"
+#include <atomic>
+#include <memory>
+
+// Interne Schnittstelle zwischen HttpClient und den Plattform-Backends
+namespace net {
+    class HttpBackend {
+    public:
+        virtual ~HttpBackend() = default;
+
+        virtual bool Send(const Url& url, const HttpRequest& request, HttpResponse& response, std::string* lastError) = 0;
+        virtual void SetMaxIdlePerHost(size_t count) = 0;
+        virtual void SetMaxConnectionsPerHost(size_t count) = 0;
+        virtual void SetTimeouts(const HttpTimeouts& timeouts) = 0;
+        virtual void CloseIdleConnections() = 0;
+
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> connectionsOpened{0};
+        std::atomic<uint64_t> connectionsReused{0};
+    };
+
+    // Ziel des Antwort-Bodys: request.sink, sonst request.onBody, sonst response.body
+    class BodyTarget {
+    public:
+        BodyTarget(const HttpRequest& request, HttpResponse& response)
+            : response_(response), stringSink_(response.body), callbackSink_(request.onBody),
+              sink_(request.sink ? *request.sink : request.onBody ? (BodySink&)callbackSink_ : (BodySink&)stringSink_) {}
+
+        // Einmal nach den Headern (expectedSize = Content-Length oder -1)
+        bool Begin(int64_t expectedSize) { return Check(sink_.Begin(response_, expectedSize)); }
+
+        // Direkt in den Speicher der Senke lesen
+        char* Prepare(size_t& size) {
+            char* target = sink_.Prepare(size);
+            if (!target || size == 0) {
+                aborted_ = true;
+                return nullptr;
+            }
+            return target;
+        }
+        bool Commit(size_t size) { return Check(sink_.Commit(size)); }
+        bool Write(const char* data, size_t size) { return Check(sink_.Write(data, size)); }
+
+        bool Aborted() const { return aborted_; }
+
+    private:
+        bool Check(bool ok) {
+            if (!ok) aborted_ = true;
+            return ok;
+        }
+
+        HttpResponse& response_;
+        StringSink stringSink_;
+        CallbackSink callbackSink_;
+        BodySink& sink_;
+        bool aborted_ = false;
+    };
+
+    // Voreinstellungen beider Backends. Gleichzeitige Verbindungen: bis zu 6
+    // Download-Segmente (FileDownloader::Options::maxSegments) + Vorschau (2) +
+    // Dekodieren (2) + Listing/Sync/Signieren, ohne dass einer auf den anderen wartet.
+    const size_t DEFAULT_MAX_IDLE_PER_HOST = 4;
+    const size_t DEFAULT_MAX_CONNECTIONS_PER_HOST = 16;
+
+    // Implementiert in WinHttpBackend.cpp (_WIN32) bzw. SocketBackend.cpp
+    std::unique_ptr<HttpBackend> CreatePlatformBackend();
+
+    // Gemeinsame Helfer für die Backends
+    bool EqualsIgnoreCase(const std::string& a, const std::string& b);
+    void ParseHeaderLines(const std::string& raw, std::vector<HttpHeader>& out);
+}
@@ -0,0 +1,130 @@
+#include "HttpClient.h"
+#include "HttpBackend.h"
+#include <cctype>
+#include <cstdlib>
+
+namespace net {
+    bool EqualsIgnoreCase(const std::string& a, const std::string& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) return false;
+        }
+        return true;
+    }
+
+    // Zerlegt "Name: Value\r\n..." Zeilen (Statuszeile ohne ':' wird übersprungen)
+    void ParseHeaderLines(const std::string& raw, std::vector<HttpHeader>& out) {
+        size_t pos = 0;
+        while (pos < raw.size()) {
+            size_t end = raw.find("\r\n", pos);
+            if (end == std::string::npos) end = raw.size();
+            std::string line = raw.substr(pos, end - pos);
+            pos = end + 2;
+
+            size_t colon = line.find(':');
+            if (colon == std::string::npos || colon == 0) continue;
+
+            size_t valueStart = colon + 1;
+            while (valueStart < line.size() && (line[valueStart] == ' ' || line[valueStart] == '\t')) ++valueStart;
+            size_t valueEnd = line.size();
+            while (valueEnd > valueStart && (line[valueEnd - 1] == ' ' || line[valueEnd - 1] == '\t')) --valueEnd;
+
+            out.push_back({ line.substr(0, colon), line.substr(valueStart, valueEnd - valueStart) });
+        }
+    }
+
+    std::string Url::HostKey() const {
+        return (secure ? "https://" : "http://") + host + ":" + std::to_string(port);
+    }
+
+    bool Url::Parse(const std::string& url, Url& out) {
+        size_t schemeEnd = url.find("://");
+        if (schemeEnd == std::string::npos) return false;
+
+        std::string scheme = url.substr(0, schemeEnd);
+        if (EqualsIgnoreCase(scheme, "https")) {
+            out.secure = true;
+            out.port = 443;
+        } else if (EqualsIgnoreCase(scheme, "http")) {
+            out.secure = false;
+            out.port = 80;
+        } else {
+            return false;
+        }
+
+        size_t hostStart = schemeEnd + 3;
+        size_t pathStart = url.find_first_of("/?", hostStart);
+        std::string authority = url.substr(hostStart, pathStart == std::string::npos ? std::string::npos : pathStart - hostStart);
+        if (authority.empty()) return false;
+
+        size_t colon = authority.rfind(':');
+        if (colon != std::string::npos) {
+            int port = std::atoi(authority.c_str() + colon + 1);
+            if (port <= 0 || port > 65535) return false;
+            out.port = (uint16_t)port;
+            authority.resize(colon);
+        }
+        out.host = authority;
+
+        if (pathStart == std::string::npos) {
+            out.path = "/";
+        } else if (url[pathStart] == '?') {
+            out.path = "/" + url.substr(pathStart);
+        } else {
+            out.path = url.substr(pathStart);
+        }
+        return true;
+    }
+
+    std::string HttpResponse::GetHeader(const std::string& name) const {
+        for (const auto& header : headers) {
+            if (EqualsIgnoreCase(header.name, name)) return header.value;
+        }
+        return "";
+    }
+
+    HttpClient::HttpClient() : backend_(CreatePlatformBackend()) {}
+
+    HttpClient::~HttpClient() = default;
+
+    HttpClient& HttpClient::Instance() {
+        // Nie zerstört: Worker-Threads können beim Beenden noch Requests senden
+        static HttpClient* instance = new HttpClient();
+        return *instance;
+    }
+
+    bool HttpClient::Send(const HttpRequest& request, HttpResponse& response, std::string* lastError) {
+        response = HttpResponse();
+
+        Url url;
+        if (!Url::Parse(request.url, url)) {
+            if (lastError) *lastError = "Ungültige URL: " + request.url;
+            return false;
+        }
+        return backend_->Send(url, request, response, lastError);
+    }
+
+    void HttpClient::SetMaxIdlePerHost(size_t count) {
+        backend_->SetMaxIdlePerHost(count);
+    }
+
+    void HttpClient::SetMaxConnectionsPerHost(size_t count) {
+        backend_->SetMaxConnectionsPerHost(count);
+    }
+
+    void HttpClient::SetTimeouts(const HttpTimeouts& timeouts) {
+        backend_->SetTimeouts(timeouts);
+    }
+
+    void HttpClient::CloseIdleConnections() {
+        backend_->CloseIdleConnections();
+    }
+
+    HttpClient::Stats HttpClient::GetStats() const {
+        Stats stats;
+        stats.requests = backend_->requests.load();
+        stats.connectionsOpened = backend_->connectionsOpened.load();
+        stats.connectionsReused = backend_->connectionsReused.load();
+        return stats;
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BodySink.h"
+
+namespace net {
+    // Einzelner HTTP-Header (Name ist case-insensitive)
+    struct HttpHeader {
+        std::string name;
+        std::string value;
+    };
+
+    // Zerlegte URL (https://host[:port]/path?query)
+    struct Url {
+        std::string host;
+        uint16_t port = 443;
+        bool secure = true;
+        std::string path = "/";
+
+        // Schlüssel für den Connection-Pool
+        std::string HostKey() const;
+
+        static bool Parse(const std::string& url, Url& out);
+    };
+
+    struct HttpRequest {
+        std::string method = "GET";
+        std::string url;                    // Vollständige URL inkl. Query
+        std::vector<HttpHeader> headers;
+        std::string body;                   // Leer = kein Body
+
+        // Optional: Antwort-Body stückweise beim Empfang übergeben statt in response.body
+        // zu sammeln. status/headers der Antwort sind beim ersten Aufruf schon gesetzt;
+        // false bricht den Empfang ab (Send liefert dann false).
+        std::function<bool(const char* data, size_t size)> onBody;
+
+        // Optional: Antwort-Body direkt in diese Senke (Vorrang vor onBody und
+        // response.body). Muss bis zum Ende von Send leben.
+        BodySink* sink = nullptr;
+
+        // Nur HTTP/1.1: parallele Requests (z.B. Range-Stücke eines Downloads)
+        // laufen so über eigene TCP-Verbindungen statt gemultiplext über eine
+        // HTTP/2-Verbindung. Das Socket-Backend spricht ohnehin nur HTTP/1.1.
+        bool http1 = false;
+    };
+
+    struct HttpResponse {
+        int status = 0;
+        std::vector<HttpHeader> headers;
+        std::string body;
+
+        // Liefert den ersten Header mit passendem Namen (case-insensitive), sonst ""
+        std::string GetHeader(const std::string& name) const;
+
+        bool IsSuccess() const { return status >= 200 && status < 300; }
+    };
+
+    class HttpBackend;
+
+    // Timeouts der Verbindungen in Millisekunden (0 = unbegrenzt)
+    struct HttpTimeouts {
+        int connect = 15000;        // Namensauflösung + Verbindungsaufbau
+        int send = 30000;
+        int receive = 30000;        // Warten auf die nächsten Antwort-Bytes
+    };
+
+    // Prozessweiter HTTP-Client mit Keep-Alive Connection-Pool pro Host.
+    // Windows: WinHTTP (eine Session, Connect-Handles pro Host werden wiederverwendet).
+    // Sonst: eigenes Socket-Backend (nur http://), z.B. gegen einen lokalen Testserver.
+    // Alle Methoden sind thread-safe.
+    class HttpClient {
+    public:
+        struct Stats {
+            uint64_t requests = 0;             // Gesendete Requests
+            uint64_t connectionsOpened = 0;    // Neu aufgebaute Verbindungen
+            uint64_t connectionsReused = 0;    // Requests auf einer Pool-Verbindung
+        };
+
+        HttpClient();
+        ~HttpClient();
+        HttpClient(const HttpClient&) = delete;
+        HttpClient& operator=(const HttpClient&) = delete;
+
+        // Gemeinsame Instanz für storagedata, Auth und FileBrowser
+        static HttpClient& Instance();
+
+        // Sendet den Request und liest die komplette Antwort.
+        // false nur bei Transportfehlern; HTTP-Fehlerstatus stehen in response.status.
+        bool Send(const HttpRequest& request, HttpResponse& response, std::string* lastError = nullptr);
+
+        // Maximale Anzahl Idle-Verbindungen pro Host, die für spätere Requests
+        // offen bleiben (Default: 4). Nur Socket-Backend: WinHTTP hält Idle-
+        // Verbindungen selbst und bietet dafür keine Obergrenze.
+        void SetMaxIdlePerHost(size_t count);
+
+        // Maximale Anzahl gleichzeitig genutzter Verbindungen pro Host (Default: 16).
+        // Weitere Requests warten, bis eine Verbindung frei wird.
+        void SetMaxConnectionsPerHost(size_t count);
+
+        // Gilt für danach geöffnete Verbindungen bzw. Requests
+        void SetTimeouts(const HttpTimeouts& timeouts);
+
+        // Schließt alle ungenutzten Verbindungen
+        void CloseIdleConnections();
+
+        Stats GetStats() const;
+
+    private:
+        std::unique_ptr<HttpBackend> backend_;
+    };
+}
@@ -0,0 +1,397 @@
+#ifndef _WIN32
+#include "HttpBackend.h"
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Portables Socket-Backend (HTTP/1.1, nur http://) mit Keep-Alive Pool pro Host
+// und Obergrenze gleichzeitiger Verbindungen.
+// Dient zum Testen/Benchmarken der Wiederverwendung gegen einen lokalen Server.
+namespace net {
+    namespace {
+        const size_t DIRECT_READ_SIZE = 65536;     // Body-Stücke, die direkt in die Senke gehen
+
+        // Gepufferter Leser über einem Socket
+        class SocketReader {
+        public:
+            explicit SocketReader(int fd) : fd_(fd) {}
+
+            // Liest bis "\r\n\r\n" (exklusive) in out
+            bool ReadHead(std::string& out) {
+                while (true) {
+                    size_t end = buffer_.find("\r\n\r\n", pos_);
+                    if (end != std::string::npos) {
+                        out = buffer_.substr(pos_, end - pos_);
+                        pos_ = end + 4;
+                        return true;
+                    }
+                    if (!Fill()) return false;
+                }
+            }
+
+            bool ReadLine(std::string& out) {
+                while (true) {
+                    size_t end = buffer_.find("\r\n", pos_);
+                    if (end != std::string::npos) {
+                        out = buffer_.substr(pos_, end - pos_);
+                        pos_ = end + 2;
+                        return true;
+                    }
+                    if (!Fill()) return false;
+                }
+            }
+
+            bool ReadExact(size_t count, BodyTarget& out) {
+                while (count > 0) {
+                    if (pos_ < buffer_.size()) {
+                        size_t take = std::min(count, buffer_.size() - pos_);
+                        if (!out.Write(buffer_.data() + pos_, take)) return false;
+                        pos_ += take;
+                        count -= take;
+                        continue;
+                    }
+                    // Puffer leer: direkt in die Senke empfangen (nie über den Body hinaus)
+                    size_t want = std::min(count, DIRECT_READ_SIZE);
+                    char* target = out.Prepare(want);
+                    if (!target) return false;
+                    ssize_t n = Receive(target, want);
+                    if (n <= 0 || !out.Commit((size_t)n)) return false;
+                    count -= (size_t)n;
+                }
+                return true;
+            }
+
+            bool ReadUntilClose(BodyTarget& out) {
+                do {
+                    if (pos_ < buffer_.size() && !out.Write(buffer_.data() + pos_, buffer_.size() - pos_)) return false;
+                    pos_ = buffer_.size();
+                } while (Fill());
+                return true;
+            }
+
+            size_t BytesReceived() const { return received_; }
+            bool HasLeftover() const { return pos_ < buffer_.size(); }
+
+        private:
+            bool Fill() {
+                if (pos_ > 0 && pos_ == buffer_.size()) {
+                    buffer_.clear();
+                    pos_ = 0;
+                }
+                char chunk[16384];
+                ssize_t n = Receive(chunk, sizeof(chunk));
+                if (n <= 0) return false;
+                buffer_.append(chunk, (size_t)n);
+                return true;
+            }
+
+            ssize_t Receive(char* target, size_t size) {
+                ssize_t n;
+                do {
+                    n = recv(fd_, target, size, 0);
+                } while (n < 0 && errno == EINTR);
+                if (n > 0) received_ += (size_t)n;
+                return n;
+            }
+
+            int fd_;
+            std::string buffer_;
+            size_t pos_ = 0;
+            size_t received_ = 0;
+        };
+
+        bool SendAll(int fd, const std::string& data) {
+            size_t sent = 0;
+            while (sent < data.size()) {
+                ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                sent += (size_t)n;
+            }
+            return true;
+        }
+
+        bool ContainsToken(const std::string& value, const char* token) {
+            std::string lower;
+            for (char c : value) lower += (char)std::tolower((unsigned char)c);
+            return lower.find(token) != std::string::npos;
+        }
+
+        void SetSocketTimeout(int fd, int option, int milliseconds) {
+            timeval timeout = {};
+            timeout.tv_sec = milliseconds / 1000;
+            timeout.tv_usec = (milliseconds % 1000) * 1000;
+            setsockopt(fd, SOL_SOCKET, option, &timeout, sizeof(timeout));
+        }
+
+        // Verbindungsaufbau mit Timeout (nicht blockierend + poll), danach wieder blockierend
+        bool ConnectWithTimeout(int fd, const sockaddr* address, socklen_t length, int milliseconds) {
+            int flags = fcntl(fd, F_GETFL, 0);
+            if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) return false;
+            int result = connect(fd, address, length);
+            if (result != 0 && errno == EINPROGRESS) {
+                pollfd pending = {};
+                pending.fd = fd;
+                pending.events = POLLOUT;
+                do {
+                    result = poll(&pending, 1, milliseconds > 0 ? milliseconds : -1);
+                } while (result < 0 && errno == EINTR);
+                int error = 0;
+                socklen_t errorLength = sizeof(error);
+                if (result != 1 || getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &errorLength) != 0 || error != 0) return false;
+                result = 0;
+            }
+            return result == 0 && fcntl(fd, F_SETFL, flags) == 0;
+        }
+    }
+
+    class SocketBackend : public HttpBackend {
+    public:
+        ~SocketBackend() override {
+            CloseIdleConnections();
+        }
+
+        bool Send(const Url& url, const HttpRequest& request, HttpResponse& response, std::string* lastError) override {
+            if (url.secure) {
+                if (lastError) *lastError = "HTTPS wird vom Socket-Backend nicht unterstützt";
+                return false;
+            }
+
+            std::string wire = BuildRequest(url, request);
+            requests++;
+
+            // Eine Pool-Verbindung kann serverseitig bereits geschlossen sein:
+            // dann einmal mit frischer Verbindung wiederholen.
+            std::string key = url.HostKey();
+            for (int attempt = 0; attempt < 2; ++attempt) {
+                bool reused = false;
+                int fd = Acquire(url, attempt == 0, reused, lastError);
+                if (fd < 0) return false;
+
+                SocketReader reader(fd);
+                bool keepAlive = false;
+                response = HttpResponse();
+                BodyTarget body(request, response);
+                if (SendAll(fd, wire) && ReadResponse(reader, request, response, body, keepAlive)) {
+                    if (reused) connectionsReused++;
+                    Release(key, fd, keepAlive && !reader.HasLeftover());
+                    return true;
+                }
+
+                Release(key, fd, false);
+                if (body.Aborted()) {
+                    if (lastError) *lastError = "Empfang abgebrochen";
+                    return false;
+                }
+                if (!reused || reader.BytesReceived() > 0) break;
+            }
+
+            if (lastError) *lastError = "HTTP-Übertragung fehlgeschlagen";
+            return false;
+        }
+
+        void SetMaxIdlePerHost(size_t count) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            maxIdlePerHost_ = count;
+        }
+
+        void SetMaxConnectionsPerHost(size_t count) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            maxConnectionsPerHost_ = std::max<size_t>(count, 1);
+            slotFreed_.notify_all();
+        }
+
+        void SetTimeouts(const HttpTimeouts& timeouts) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            timeouts_ = timeouts;
+        }
+
+        void CloseIdleConnections() override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& entry : idle_) {
+                for (int fd : entry.second) close(fd);
+            }
+            idle_.clear();
+        }
+
+    private:
+        static std::string BuildRequest(const Url& url, const HttpRequest& request) {
+            std::string wire = request.method + " " + url.path + " HTTP/1.1\r\n";
+            wire += "Host: " + url.host;
+            if (url.port != 80) wire += ":" + std::to_string(url.port);
+            wire += "\r\n";
+            for (const auto& header : request.headers) {
+                wire += header.name + ": " + header.value + "\r\n";
+            }
+            if (!request.body.empty() || request.method == "POST" || request.method == "PUT" || request.method == "PATCH") {
+                wire += "Content-Length: " + std::to_string(request.body.size()) + "\r\n";
+            }
+            wire += "\r\n";
+            wire += request.body;
+            return wire;
+        }
+
+        static bool ReadResponse(SocketReader& reader, const HttpRequest& request, HttpResponse& response, BodyTarget& body, bool& keepAlive) {
+            std::string head;
+            if (!reader.ReadHead(head)) return false;
+
+            size_t lineEnd = head.find("\r\n");
+            std::string statusLine = head.substr(0, lineEnd);
+            size_t space = statusLine.find(' ');
+            if (statusLine.compare(0, 5, "HTTP/") != 0 || space == std::string::npos) return false;
+            response.status = std::atoi(statusLine.c_str() + space + 1);
+            if (lineEnd != std::string::npos) ParseHeaderLines(head.substr(lineEnd + 2), response.headers);
+
+            bool http10 = statusLine.compare(0, 8, "HTTP/1.0") == 0;
+            std::string connection = response.GetHeader("Connection");
+            keepAlive = http10 ? ContainsToken(connection, "keep-alive") : !ContainsToken(connection, "close");
+
+            bool noBody = request.method == "HEAD" || response.status == 204 || response.status == 304 ||
+                (response.status >= 100 && response.status < 200);
+            if (noBody) return body.Begin(0);
+
+            if (ContainsToken(response.GetHeader("Transfer-Encoding"), "chunked")) {
+                if (!body.Begin(-1)) return false;
+                while (true) {
+                    std::string sizeLine;
+                    if (!reader.ReadLine(sizeLine)) return false;
+                    size_t chunkSize = std::strtoul(sizeLine.c_str(), nullptr, 16);
+                    if (chunkSize == 0) {
+                        // Trailer bis zur Leerzeile überspringen
+                        std::string trailer;
+                        do {
+                            if (!reader.ReadLine(trailer)) return false;
+                        } while (!trailer.empty());
+                        return true;
+                    }
+                    if (!reader.ReadExact(chunkSize, body)) return false;
+                    std::string crlf;
+                    if (!reader.ReadLine(crlf)) return false;
+                }
+            }
+
+            std::string contentLength = response.GetHeader("Content-Length");
+            if (!contentLength.empty()) {
+                size_t length = (size_t)std::strtoull(contentLength.c_str(), nullptr, 10);
+                return body.Begin((int64_t)length) && reader.ReadExact(length, body);
+            }
+
+            // Ohne Länge endet der Body mit dem Verbindungsende
+            keepAlive = false;
+            return body.Begin(-1) && reader.ReadUntilClose(body);
+        }
+
+        // Wartet auf einen freien Platz unter maxConnectionsPerHost_ (Idle-Verbindungen
+        // zählen nicht) und liefert eine Pool- oder neue Verbindung; jede gelieferte
+        // Verbindung geht über Release zurück
+        int Acquire(const Url& url, bool allowReuse, bool& reused, std::string* lastError) {
+            std::string key = url.HostKey();
+            HttpTimeouts timeouts;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                slotFreed_.wait(lock, [&] { return active_[key] < maxConnectionsPerHost_; });
+                ++active_[key];
+                timeouts = timeouts_;
+                auto it = idle_.find(key);
+                if (allowReuse && it != idle_.end() && !it->second.empty()) {
+                    int fd = it->second.back();
+                    it->second.pop_back();
+                    reused = true;
+                    return fd;
+                }
+            }
+            reused = false;
+
+            int fd = Connect(url, timeouts, lastError);
+            if (fd < 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --active_[key];
+                slotFreed_.notify_one();
+                return -1;
+            }
+            connectionsOpened++;
+            return fd;
+        }
+
+        static int Connect(const Url& url, const HttpTimeouts& timeouts, std::string* lastError) {
+            addrinfo hints = {};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* result = nullptr;
+            std::string port = std::to_string(url.port);
+            if (getaddrinfo(url.host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+                if (lastError) *lastError = "DNS-Auflösung fehlgeschlagen: " + url.host;
+                return -1;
+            }
+
+            int fd = -1;
+            for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+                fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+                if (fd < 0) continue;
+                if (ConnectWithTimeout(fd, ai->ai_addr, ai->ai_addrlen, timeouts.connect)) break;
+                close(fd);
+                fd = -1;
+            }
+            freeaddrinfo(result);
+
+            if (fd < 0) {
+                if (lastError) *lastError = "Verbindung fehlgeschlagen: " + url.HostKey();
+                return -1;
+            }
+
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+            SetSocketTimeout(fd, SO_RCVTIMEO, timeouts.receive);
+            SetSocketTimeout(fd, SO_SNDTIMEO, timeouts.send);
+            return fd;
+        }
+
+        void Release(const std::string& key, int fd, bool keepAlive) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --active_[key];
+            slotFreed_.notify_one();
+            if (keepAlive) {
+                auto& pool = idle_[key];
+                if (pool.size() < maxIdlePerHost_) {
+                    pool.push_back(fd);
+                    return;
+                }
+            }
+            close(fd);
+        }
+
+        std::mutex mutex_;
+        std::condition_variable slotFreed_;
+        size_t maxIdlePerHost_ = DEFAULT_MAX_IDLE_PER_HOST;
+        size_t maxConnectionsPerHost_ = DEFAULT_MAX_CONNECTIONS_PER_HOST;
+        HttpTimeouts timeouts_;
+        std::map<std::string, std::vector<int>> idle_;
+        std::map<std::string, size_t> active_;      // Ausgegebene Verbindungen pro Host
+    };
+
+    std::unique_ptr<HttpBackend> CreatePlatformBackend() {
+        return std::unique_ptr<HttpBackend>(new SocketBackend());
+    }
+}
+#endif
@@ -0,0 +1,16 @@
+#include "Supabase.h"
+#include "config.h"  // Contains SUPABASE_HOST, SUPABASE_ANON_KEY
+#include <cwchar>
+
+namespace net {
+    std::string SupabaseUrl(const std::string& path) {
+        // SUPABASE_HOST ist reines ASCII
+        std::string host(SUPABASE_HOST, SUPABASE_HOST + wcslen(SUPABASE_HOST));
+        return "https://" + host + path;
+    }
+
+    void AddSupabaseHeaders(HttpRequest& request, const std::string& bearerToken) {
+        request.headers.push_back({ "apikey", SUPABASE_ANON_KEY });
+        request.headers.push_back({ "Authorization", "Bearer " + (bearerToken.empty() ? std::string(SUPABASE_ANON_KEY) : bearerToken) });
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "HttpClient.h"
+#include <string>
+
+// Gemeinsame Helfer für Requests gegen die Supabase-API
+namespace net {
+    // "https://" + SUPABASE_HOST + path
+    std::string SupabaseUrl(const std::string& path);
+
+    // Setzt apikey + Authorization (Bearer) Header.
+    // Leerer bearerToken => ANON_KEY wird verwendet.
+    void AddSupabaseHeaders(HttpRequest& request, const std::string& bearerToken);
+}
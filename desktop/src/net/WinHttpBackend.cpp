@@ -0,0 +1,217 @@
+#ifdef _WIN32
+#include "HttpBackend.h"
+#include "../util/StringUtil.h"
+#include <windows.h>
+#include <winhttp.h>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#pragma comment(lib, "winhttp.lib")
+
+// WinHTTP hält die TCP/TLS-Verbindungen einer Session selbst im Keep-Alive-Pool.
+// Entscheidend ist daher, Session und Connect-Handles NICHT pro Request neu zu öffnen.
+// Zwei Sessions: die normale mit HTTP/2, eine zweite nur mit HTTP/1.1 für
+// HttpRequest::http1 (parallele Range-Stücke brauchen eigene TCP-Verbindungen).
+namespace net {
+    class WinHttpBackend : public HttpBackend {
+    public:
+        WinHttpBackend() {
+            session_ = OpenSession(true);
+            http1Session_ = OpenSession(false);
+        }
+
+        ~WinHttpBackend() override {
+            CloseIdleConnections();
+            if (session_) WinHttpCloseHandle(session_);
+            if (http1Session_) WinHttpCloseHandle(http1Session_);
+        }
+
+        bool Send(const Url& url, const HttpRequest& request, HttpResponse& response, std::string* lastError) override {
+            HINTERNET session = request.http1 ? http1Session_ : session_;
+            if (!session) { if (lastError) *lastError = "WinHttpOpen fehlgeschlagen"; return false; }
+
+            bool reused = false;
+            HINTERNET hConnect = GetConnection(session, url, reused);
+            if (!hConnect) { if (lastError) *lastError = "WinHttpConnect fehlgeschlagen"; return false; }
+
+            std::wstring wMethod = StringUtil::Utf8ToUtf16(request.method);
+            std::wstring wPath = StringUtil::Utf8ToUtf16(url.path);
+            HINTERNET hRequest = WinHttpOpenRequest(hConnect, wMethod.c_str(), wPath.c_str(), NULL, WINHTTP_NO_REFERER,
+                WINHTTP_DEFAULT_ACCEPT_TYPES, url.secure ? WINHTTP_FLAG_SECURE : 0);
+            if (!hRequest) { if (lastError) *lastError = "WinHttpOpenRequest fehlgeschlagen"; return false; }
+
+            std::wstring headers;
+            for (const auto& header : request.headers) {
+                headers += StringUtil::Utf8ToUtf16(header.name + ": " + header.value);
+                headers += L"\r\n";
+            }
+
+            requests++;
+            if (reused) connectionsReused++;
+
+            LPVOID body = request.body.empty() ? WINHTTP_NO_REQUEST_DATA : (LPVOID)request.body.data();
+            DWORD bodyLen = (DWORD)request.body.size();
+            BOOL ok = WinHttpSendRequest(hRequest, headers.empty() ? WINHTTP_NO_ADDITIONAL_HEADERS : headers.c_str(),
+                (DWORD)headers.length(), body, bodyLen, bodyLen, 0);
+            if (!ok) {
+                if (lastError) *lastError = "WinHttpSendRequest fehlgeschlagen";
+                WinHttpCloseHandle(hRequest);
+                return false;
+            }
+            if (!WinHttpReceiveResponse(hRequest, NULL)) {
+                if (lastError) *lastError = "WinHttpReceiveResponse fehlgeschlagen";
+                WinHttpCloseHandle(hRequest);
+                return false;
+            }
+
+            DWORD statusCode = 0;
+            DWORD statusSize = sizeof(statusCode);
+            WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, NULL, &statusCode, &statusSize, NULL);
+            response.status = (int)statusCode;
+            ReadHeaders(hRequest, response);
+
+            BodyTarget body(request, response);
+            std::string contentLength = response.GetHeader("Content-Length");
+            if (!body.Begin(contentLength.empty() ? -1 : (int64_t)std::strtoll(contentLength.c_str(), nullptr, 10))) {
+                if (lastError) *lastError = "Empfang abgebrochen";
+                WinHttpCloseHandle(hRequest);
+                return false;
+            }
+            for (;;) {
+                // Nur ein erfolgreicher Aufruf mit 0 Bytes ist das Ende des Bodys;
+                // ein Fehler (Verbindung abgerissen, Timeout) darf nicht als Ende durchgehen
+                DWORD bytesAvailable = 0;
+                if (!WinHttpQueryDataAvailable(hRequest, &bytesAvailable)) {
+                    DWORD error = GetLastError();
+                    if (lastError) *lastError = "WinHttpQueryDataAvailable fehlgeschlagen (Fehler " + std::to_string(error) + ")";
+                    WinHttpCloseHandle(hRequest);
+                    return false;
+                }
+                if (bytesAvailable == 0) break;
+                // Direkt in den Speicher der Senke lesen (ggf. weniger als verfügbar)
+                size_t size = bytesAvailable;
+                char* target = body.Prepare(size);
+                DWORD bytesRead = 0;
+                if (target && !WinHttpReadData(hRequest, target, (DWORD)size, &bytesRead)) {
+                    if (lastError) *lastError = "WinHttpReadData fehlgeschlagen";
+                    WinHttpCloseHandle(hRequest);
+                    return false;
+                }
+                if (!target || !body.Commit(bytesRead)) {
+                    // Verbindung mit ungelesenem Rest wird von WinHTTP verworfen
+                    if (lastError) *lastError = "Empfang abgebrochen";
+                    WinHttpCloseHandle(hRequest);
+                    return false;
+                }
+            }
+
+            // Nur der Request-Handle wird geschlossen, die Verbindung bleibt im Pool
+            WinHttpCloseHandle(hRequest);
+            return true;
+        }
+
+        // WinHTTP hält Idle-Verbindungen der Session selbst und bietet dafür
+        // keine Obergrenze (nur das Limit gleichzeitiger Verbindungen, s.u.)
+        void SetMaxIdlePerHost(size_t) override {}
+
+        // WINHTTP_OPTION_MAX_CONNS_PER_SERVER begrenzt gleichzeitige Verbindungen:
+        // weitere Requests warten in WinHTTP auf eine freie
+        // Gilt je Session (die HTTP/1.1-Session hat ein eigenes Limit)
+        void SetMaxConnectionsPerHost(size_t count) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            maxConnectionsPerHost_ = count;
+            for (HINTERNET session : { session_, http1Session_ }) {
+                if (session) ApplyMaxConnections(session, count);
+            }
+        }
+
+        void SetTimeouts(const HttpTimeouts& timeouts) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            timeouts_ = timeouts;
+            for (HINTERNET session : { session_, http1Session_ }) {
+                if (session) ApplyTimeouts(session, timeouts);
+            }
+        }
+
+        void CloseIdleConnections() override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& entry : connections_) {
+                WinHttpCloseHandle(entry.second);
+            }
+            connections_.clear();
+        }
+
+    private:
+        HINTERNET OpenSession(bool http2) {
+            HINTERNET session = WinHttpOpen(L"DegixDAW/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+            if (!session) return nullptr;
+            ApplyMaxConnections(session, maxConnectionsPerHost_);
+            ApplyTimeouts(session, timeouts_);
+#ifdef WINHTTP_PROTOCOL_FLAG_HTTP2
+            if (http2) {
+                DWORD protocols = WINHTTP_PROTOCOL_FLAG_HTTP2;
+                WinHttpSetOption(session, WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &protocols, sizeof(protocols));
+            }
+#else
+            (void)http2;
+#endif
+            return session;
+        }
+
+        static void ApplyMaxConnections(HINTERNET session, size_t count) {
+            DWORD maxConnections = count > 0 ? (DWORD)count : 1;
+            WinHttpSetOption(session, WINHTTP_OPTION_MAX_CONNS_PER_SERVER, &maxConnections, sizeof(maxConnections));
+            WinHttpSetOption(session, WINHTTP_OPTION_MAX_CONNS_PER_1_0_SERVER, &maxConnections, sizeof(maxConnections));
+        }
+
+        // Ohne Receive-Timeout hängt ein Worker bei einer stehenden Verbindung beliebig lange
+        static void ApplyTimeouts(HINTERNET session, const HttpTimeouts& timeouts) {
+            WinHttpSetTimeouts(session, timeouts.connect, timeouts.connect, timeouts.send, timeouts.receive);
+        }
+
+        // Connect-Handles pro Session und Host
+        HINTERNET GetConnection(HINTERNET session, const Url& url, bool& reused) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::string key = (session == http1Session_ ? "http1|" : "") + url.HostKey();
+            auto it = connections_.find(key);
+            if (it != connections_.end()) {
+                reused = true;
+                return it->second;
+            }
+
+            std::wstring wHost = StringUtil::Utf8ToUtf16(url.host);
+            HINTERNET hConnect = WinHttpConnect(session, wHost.c_str(), url.port, 0);
+            if (hConnect) {
+                connections_[key] = hConnect;
+                connectionsOpened++;
+            }
+            reused = false;
+            return hConnect;
+        }
+
+        static void ReadHeaders(HINTERNET hRequest, HttpResponse& response) {
+            DWORD size = 0;
+            WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_RAW_HEADERS_CRLF, WINHTTP_HEADER_NAME_BY_INDEX, WINHTTP_NO_OUTPUT_BUFFER, &size, WINHTTP_NO_HEADER_INDEX);
+            if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || size == 0) return;
+
+            std::wstring raw(size / sizeof(wchar_t), L'\0');
+            if (!WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_RAW_HEADERS_CRLF, WINHTTP_HEADER_NAME_BY_INDEX, &raw[0], &size, WINHTTP_NO_HEADER_INDEX)) return;
+            raw.resize(size / sizeof(wchar_t));
+            ParseHeaderLines(StringUtil::Utf16ToUtf8(raw), response.headers);
+        }
+
+        HINTERNET session_ = nullptr;           // HTTP/2 erlaubt
+        HINTERNET http1Session_ = nullptr;      // Nur HTTP/1.1 (HttpRequest::http1)
+        std::mutex mutex_;                      // Schützt connections_ und die Einstellungen
+        size_t maxConnectionsPerHost_ = DEFAULT_MAX_CONNECTIONS_PER_HOST;
+        HttpTimeouts timeouts_;
+        std::map<std::string, HINTERNET> connections_;
+    };
+
+    std::unique_ptr<HttpBackend> CreatePlatformBackend() {
+        return std::unique_ptr<HttpBackend>(new WinHttpBackend());
+    }
+}
+#endif
@@ -0,0 +1,216 @@
+#include "AttachmentIndex.h"
+#include <algorithm>
+#include <ctime>
+
+// AUDIO umfasst MIDI (wie file_type=like.audio* auf dem Server)
+static bool CategoryMatches(AttachmentIndex::Category wanted, AttachmentIndex::Category actual) {
+    return actual == wanted || (wanted == AttachmentIndex::Category::AUDIO && actual == AttachmentIndex::Category::MIDI);
+}
+
+AttachmentIndex::Query AttachmentIndex::FromFilter(storagedata::FileFilter filter) {
+    Query query;
+    switch (filter) {
+        case storagedata::FileFilter::RECEIVED: query.origin = Origin::RECEIVED; break;
+        case storagedata::FileFilter::IMAGES:   query.category = Category::IMAGE; break;
+        case storagedata::FileFilter::AUDIO:    query.category = Category::AUDIO; break;
+        case storagedata::FileFilter::MIDI:     query.category = Category::MIDI; break;
+        case storagedata::FileFilter::VIDEO:    query.category = Category::VIDEO; break;
+        case storagedata::FileFilter::ALL:
+        default:
+            break;
+    }
+    return query;
+}
+
+AttachmentIndex::Category AttachmentIndex::CategoryAt(size_t row) const {
+    switch (files_.Category(row)) {
+        case MimeCategory::IMAGE: return Category::IMAGE;
+        case MimeCategory::AUDIO: return Category::AUDIO;
+        case MimeCategory::MIDI:  return Category::MIDI;
+        case MimeCategory::VIDEO: return Category::VIDEO;
+        default:                  return Category::ANY;
+    }
+}
+
+void AttachmentIndex::Build(std::vector<storagedata::FileInfo> files, const std::string& userId) {
+    Clear();
+    userId_ = userId;
+    files_.Reserve(files.size());
+    origin_.reserve(files.size());
+    for (const auto& info : files) {
+        files_.Add(info);
+        Insert(files_.Size() - 1);
+    }
+}
+
+void AttachmentIndex::Append(std::vector<storagedata::FileInfo>& files) {
+    for (const auto& info : files) {
+        files_.Add(info);
+        Insert(files_.Size() - 1);
+    }
+}
+
+void AttachmentIndex::Clear() {
+    userId_.clear();
+    files_.Clear();
+    origin_.clear();
+    for (auto& rows : byCategory_) rows.clear();
+    for (auto& rows : byOrigin_) rows.clear();
+}
+
+// Ohne sender_id (oder ohne eigene User-ID) ist die Herkunft unbekannt
+AttachmentIndex::Origin AttachmentIndex::OriginOf(size_t row) const {
+    const std::string& senderId = files_.SenderId(row);
+    if (senderId.empty() || userId_.empty()) return Origin::ANY;
+    return senderId == userId_ ? Origin::SENT : Origin::RECEIVED;
+}
+
+void AttachmentIndex::Insert(size_t row) {
+    Category category = CategoryAt(row);
+    if (category != Category::ANY) byCategory_[(size_t)category].push_back((uint32_t)row);
+    if (category == Category::MIDI) byCategory_[(size_t)Category::AUDIO].push_back((uint32_t)row);
+
+    Origin origin = OriginOf(row);
+    if (origin != Origin::ANY) byOrigin_[(size_t)origin].push_back((uint32_t)row);
+    origin_.push_back((uint8_t)origin);
+}
+
+void AttachmentIndex::Reindex() {
+    for (auto& rows : byCategory_) rows.clear();
+    for (auto& rows : byOrigin_) rows.clear();
+    for (size_t row = 0; row < files_.Size(); ++row) {
+        Category category = CategoryAt(row);
+        if (category != Category::ANY) byCategory_[(size_t)category].push_back((uint32_t)row);
+        if (category == Category::MIDI) byCategory_[(size_t)Category::AUDIO].push_back((uint32_t)row);
+        if ((Origin)origin_[row] != Origin::ANY) byOrigin_[origin_[row]].push_back((uint32_t)row);
+    }
+}
+
+void AttachmentIndex::ApplyDelta(const std::vector<storagedata::FileInfo>& added, const std::vector<std::string>& removed) {
+    if (added.empty() && removed.empty()) return;
+
+    // Ein Durchlauf über die binären IDs findet Gelöschte und zu ersetzende Zeilen
+    IdSet drop;
+    for (const auto& id : removed) drop.Insert(id);
+    for (const auto& info : added) drop.Insert(info.id);
+    std::vector<size_t> dropRows;
+    for (size_t row = 0; row < files_.Size(); ++row) {
+        Uuid uuid;
+        if (files_.IdUuid(row, uuid) ? drop.Contains(uuid) : drop.Contains(files_.Id(row))) dropRows.push_back(row);
+    }
+    if (!dropRows.empty()) {
+        files_.Erase(dropRows);
+        size_t next = 0, kept = 0;
+        for (size_t row = 0; row < origin_.size(); ++row) {
+            if (next < dropRows.size() && dropRows[next] == row) {
+                ++next;
+                continue;
+            }
+            origin_[kept++] = origin_[row];
+        }
+        origin_.resize(kept);
+    }
+
+    std::vector<size_t> insertedRows;
+    files_.Merge(added, &insertedRows);
+    if (!insertedRows.empty()) {
+        std::vector<uint8_t> origin;
+        origin.reserve(files_.Size());
+        size_t next = 0, old = 0;
+        for (size_t row = 0; row < files_.Size(); ++row) {
+            if (next < insertedRows.size() && insertedRows[next] == row) {
+                origin.push_back((uint8_t)OriginOf(row));
+                ++next;
+            } else {
+                origin.push_back(origin_[old++]);
+            }
+        }
+        origin_ = std::move(origin);
+    }
+    Reindex();
+}
+
+// Beginn des lokalen Kalendertags vor daysBack Tagen in UTC-Mikrosekunden.
+// "Heute" endet für den Nutzer um lokale Mitternacht, nicht um 00:00 UTC;
+// mktime rechnet die Sommerzeit des jeweiligen Tages ein.
+static int64_t LocalDayStartMicros(int daysBack) {
+    std::time_t now = std::time(nullptr);
+    std::tm local = {};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    local.tm_mday -= daysBack;
+    local.tm_hour = 0;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    local.tm_isdst = -1;
+    return (int64_t)std::mktime(&local) * 1000000;
+}
+
+size_t AttachmentIndex::PeriodEnd(Period period) const {
+    if (period == Period::ANY) return files_.Size();
+
+    int daysBack = 0;
+    if (period == Period::LAST_7_DAYS) daysBack = 6;
+    else if (period == Period::LAST_30_DAYS) daysBack = 29;
+    int64_t firstMicros = LocalDayStartMicros(daysBack);
+
+    // Zeilen sind nach created_at absteigend sortiert: der Zeitraum ist ein Präfix
+    size_t low = 0, high = files_.Size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (files_.CreatedAtMicros(mid) >= firstMicros) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+bool AttachmentIndex::Matches(const Query& query, size_t row) const {
+    if (row >= files_.Size()) return false;
+    if (query.category != Category::ANY && !CategoryMatches(query.category, CategoryAt(row))) return false;
+    if (query.origin != Origin::ANY && (Origin)origin_[row] != query.origin) return false;
+    return row < PeriodEnd(query.period);
+}
+
+void AttachmentIndex::Select(const Query& query, std::vector<size_t>& outRows, size_t from) const {
+    outRows.clear();
+    size_t end = PeriodEnd(query.period);
+    if (from >= end) return;
+
+    // Kürzeste Facettenliste treiben, die andere Facette pro Zeile prüfen
+    const std::vector<uint32_t>* driver = nullptr;
+    if (query.category != Category::ANY) driver = &byCategory_[(size_t)query.category];
+    if (query.origin != Origin::ANY) {
+        const std::vector<uint32_t>* rows = &byOrigin_[(size_t)query.origin];
+        if (!driver || rows->size() < driver->size()) driver = rows;
+    }
+
+    if (!driver) {
+        outRows.reserve(end - from);
+        for (size_t row = from; row < end; ++row) outRows.push_back(row);
+        return;
+    }
+
+    bool checkCategory = query.category != Category::ANY && driver != &byCategory_[(size_t)query.category];
+    bool checkOrigin = query.origin != Origin::ANY && driver != &byOrigin_[(size_t)query.origin];
+    for (auto it = std::lower_bound(driver->begin(), driver->end(), (uint32_t)from); it != driver->end() && *it < end; ++it) {
+        size_t row = *it;
+        if (checkCategory && !CategoryMatches(query.category, CategoryAt(row))) continue;
+        if (checkOrigin && (Origin)origin_[row] != query.origin) continue;
+        outRows.push_back(row);
+    }
+}
+
+size_t AttachmentIndex::Find(const std::string& id, size_t hint) const {
+    if (hint < files_.Size() && files_.Id(hint) == id) return hint;
+
+    Uuid wanted;
+    bool isUuid = Uuid::Parse(id, wanted);
+    for (size_t row = 0; row < files_.Size(); ++row) {
+        Uuid uuid;
+        if (files_.IdUuid(row, uuid) ? isUuid && uuid == wanted : files_.Id(row) == id) return row;
+    }
+    return NOT_FOUND;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "../storagedata.h"
+#include "CompactListing.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Lokaler Index über das komplette Attachment-Listing (FileFilter::ALL, neueste zuerst).
+// Die Zeilen liegen kompakt in einem CompactListing. Pro Facette (MIME-Kategorie,
+// Herkunft) wird beim Einfügen eine sortierte Liste der Zeilennummern gepflegt;
+// der Zeitraum ist ein Präfix der Liste (Binärsuche auf created_at).
+// Tab-Wechsel und kombinierte Filter brauchen damit keinen Request.
+// Nicht thread-safe: gehört dem UI-Thread.
+class AttachmentIndex {
+public:
+    enum class Category { ANY, IMAGE, AUDIO, MIDI, VIDEO };  // AUDIO enthält MIDI (wie file_type=like.audio*)
+    enum class Origin { ANY, RECEIVED, SENT };
+    enum class Period { ANY, TODAY, LAST_7_DAYS, LAST_30_DAYS };
+
+    struct Query {
+        Category category = Category::ANY;
+        Origin origin = Origin::ANY;
+        Period period = Period::ANY;
+    };
+
+    // Entspricht dem serverseitigen Filter des Tabs
+    static Query FromFilter(storagedata::FileFilter filter);
+
+    // Neu aufbauen (files neueste zuerst); userId trennt RECEIVED/SENT
+    void Build(std::vector<storagedata::FileInfo> files, const std::string& userId);
+
+    // Ältere Zeilen hinten anhängen (nächste Seite des ersten Ladens)
+    void Append(std::vector<storagedata::FileInfo>& files);
+
+    // Änderungen eines Delta-Syncs übernehmen, ohne den Index neu aufzubauen:
+    // removed (IDs) entfernen, added sortiert einmischen (bereits enthaltene IDs
+    // werden ersetzt). Die Facetten werden nur über Zeilennummern neu verteilt.
+    void ApplyDelta(const std::vector<storagedata::FileInfo>& added, const std::vector<std::string>& removed);
+
+    void Clear();
+
+    // Zeilennummern aller Treffer ab Zeile "from" (neueste zuerst)
+    void Select(const Query& query, std::vector<size_t>& outRows, size_t from = 0) const;
+
+    bool Matches(const Query& query, size_t row) const;
+
+    storagedata::FileInfo Get(size_t row) const { return files_.Get(row); }
+    std::string Id(size_t row) const { return files_.Id(row); }
+    // Ersetzt die Zeile (z.B. nach FetchFileDetails); Facetten bleiben unverändert
+    void Update(size_t row, const storagedata::FileInfo& info) { files_.Set(row, info); }
+
+    static const size_t NOT_FOUND = (size_t)-1;
+    // Zeile zur ID (NOT_FOUND, wenn nicht enthalten). hint wird zuerst geprüft;
+    // sonst linear, ohne IDs als Text zu erzeugen.
+    size_t Find(const std::string& id, size_t hint = NOT_FOUND) const;
+
+    size_t Size() const { return files_.Size(); }
+    bool IsEmpty() const { return files_.IsEmpty(); }
+    CompactListing::MemoryUsage GetMemoryUsage() const { return files_.GetMemoryUsage(); }
+
+private:
+    static const size_t CATEGORY_COUNT = 5;
+    static const size_t ORIGIN_COUNT = 3;
+
+    void Insert(size_t row);
+    Origin OriginOf(size_t row) const;
+    void Reindex();  // Facettenlisten aus Kategorie und origin_ neu füllen
+    // Erste Zeile, die nicht mehr im Zeitraum liegt
+    size_t PeriodEnd(Period period) const;
+
+    Category CategoryAt(size_t row) const;
+
+    std::string userId_;
+    CompactListing files_;
+    std::vector<uint8_t> origin_;                          // Origin pro Zeile
+    std::vector<uint32_t> byCategory_[CATEGORY_COUNT];     // ANY bleibt leer (= alle Zeilen)
+    std::vector<uint32_t> byOrigin_[ORIGIN_COUNT];
+};
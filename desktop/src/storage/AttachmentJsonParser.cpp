@@ -0,0 +1,121 @@
+#include "AttachmentJsonParser.h"
+#include <cstring>
+
+AttachmentJsonParser::AttachmentJsonParser(bool keysOnly, std::vector<storagedata::FileInfo>& outFiles)
+    : parser_(*this), keysOnly_(keysOnly), outFiles_(outFiles) {}
+
+std::string AttachmentJsonParser::StoragePathFromUrl(const std::string& url) {
+    static const char* MARKER = "/chat-attachments/";
+    size_t pos = url.find(MARKER);
+    if (pos == std::string::npos) return url;  // Fallback
+    return url.substr(pos + std::strlen(MARKER));
+}
+
+void AttachmentJsonParser::BeginRow() {
+    row_ = storagedata::FileInfo();
+    hasFileName_ = false;
+    hasFileType_ = false;
+}
+
+void AttachmentJsonParser::EndRow() {
+    ++rowCount_;
+    lastKey_.createdAt = row_.createdAt;
+    lastKey_.id = row_.id;
+
+    if (keysOnly_) {
+        if (!row_.id.empty()) outFiles_.push_back(std::move(row_));
+        return;
+    }
+    // Zeilen ohne file_name werden übersprungen (zählen aber für die Pagination)
+    if (!hasFileName_) return;
+    if (!hasFileType_) row_.fileType = "unknown";
+    outFiles_.push_back(std::move(row_));
+}
+
+bool AttachmentJsonParser::StartObject() {
+    ++depth_;
+    if (depth_ == 2 && topIsArray_) {
+        BeginRow();
+    } else if (depth_ == 3 && field_ == Field::MESSAGES) {
+        inMessages_ = true;
+    }
+    field_ = Field::NONE;
+    return true;
+}
+
+bool AttachmentJsonParser::EndObject() {
+    if (depth_ == 2 && topIsArray_) EndRow();
+    if (depth_ == 3) inMessages_ = false;
+    --depth_;
+    field_ = Field::NONE;
+    return true;
+}
+
+bool AttachmentJsonParser::StartArray() {
+    ++depth_;
+    if (depth_ == 1) topIsArray_ = true;
+    field_ = Field::NONE;
+    return true;
+}
+
+bool AttachmentJsonParser::EndArray() {
+    --depth_;
+    field_ = Field::NONE;
+    return true;
+}
+
+bool AttachmentJsonParser::Key(std::string& key) {
+    field_ = Field::NONE;
+    if (depth_ == 3 && inMessages_) {
+        if (key == "sender_id") field_ = Field::SENDER_ID;
+        return true;
+    }
+    if (depth_ != 2 || !topIsArray_) return true;
+
+    if (key == "id") field_ = Field::ID;
+    else if (key == "created_at") field_ = Field::CREATED_AT;
+    else if (key == "file_name") field_ = Field::FILE_NAME;
+    else if (key == "file_type") field_ = Field::FILE_TYPE;
+    else if (key == "file_size") field_ = Field::FILE_SIZE;
+    else if (key == "file_url") field_ = Field::FILE_URL;
+    else if (key == "thumbnail_url") field_ = Field::THUMBNAIL_URL;
+    else if (key == "messages") field_ = Field::MESSAGES;
+    return true;
+}
+
+bool AttachmentJsonParser::String(std::string& value) {
+    switch (field_) {
+        case Field::ID:            row_.id = std::move(value); break;
+        case Field::CREATED_AT:    row_.createdAt = std::move(value); break;
+        case Field::FILE_NAME:     row_.fileName = std::move(value); hasFileName_ = true; break;
+        case Field::FILE_TYPE:     row_.fileType = std::move(value); hasFileType_ = true; break;
+        case Field::FILE_URL:      row_.storagePath = StoragePathFromUrl(value); break;
+        case Field::THUMBNAIL_URL: row_.thumbnailPath = StoragePathFromUrl(value); break;
+        case Field::SENDER_ID:     row_.senderId = std::move(value); break;
+        default: break;
+    }
+    field_ = Field::NONE;
+    return true;
+}
+
+bool AttachmentJsonParser::Integer(long long value) {
+    if (field_ == Field::FILE_SIZE) row_.fileSize = value;
+    field_ = Field::NONE;
+    return true;
+}
+
+bool AttachmentJsonParser::Float(double value) {
+    if (field_ == Field::FILE_SIZE) row_.fileSize = (long long)value;
+    field_ = Field::NONE;
+    return true;
+}
+
+bool AttachmentJsonParser::Bool(bool) {
+    field_ = Field::NONE;
+    return true;
+}
+
+bool AttachmentJsonParser::Null() {
+    field_ = Field::NONE;
+    return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "../storagedata.h"
+#include "../util/JsonPushParser.h"
+#include <string>
+#include <vector>
+
+// Wandelt eine PostgREST-Antwort (Array von message_attachments-Zeilen) schon
+// während des Empfangs in FileInfo um: Feed() mit jedem Body-Stück aufrufen,
+// fertige Zeilen landen sofort in outFiles. Kein DOM, kein Puffer für den Body.
+class AttachmentJsonParser : private JsonPushParser::Handler {
+public:
+    // keysOnly: Zeilen enthalten nur id/created_at (Projection::KEYS_ONLY)
+    AttachmentJsonParser(bool keysOnly, std::vector<storagedata::FileInfo>& outFiles);
+
+    bool Feed(const char* data, size_t size) { return parser_.Feed(data, size); }
+    bool Finish() { return parser_.Finish(); }
+    const std::string& Error() const { return parser_.Error(); }
+
+    // Alle gelieferten Zeilen (auch übersprungene) und der Schlüssel der letzten
+    size_t RowCount() const { return rowCount_; }
+    const storagedata::RowKey& LastKey() const { return lastKey_; }
+
+    // ".../chat-attachments/USER_ID/MSG_ID/FILE.jpg" -> "USER_ID/MSG_ID/FILE.jpg"
+    static std::string StoragePathFromUrl(const std::string& url);
+
+private:
+    enum class Field { NONE, ID, CREATED_AT, FILE_NAME, FILE_TYPE, FILE_SIZE, FILE_URL, THUMBNAIL_URL, MESSAGES, SENDER_ID };
+
+    bool StartObject() override;
+    bool EndObject() override;
+    bool StartArray() override;
+    bool EndArray() override;
+    bool Key(std::string& key) override;
+    bool String(std::string& value) override;
+    bool Integer(long long value) override;
+    bool Float(double value) override;
+    bool Bool(bool value) override;
+    bool Null() override;
+
+    void BeginRow();
+    void EndRow();
+
+    JsonPushParser parser_;
+    bool keysOnly_;
+    std::vector<storagedata::FileInfo>& outFiles_;
+
+    int depth_ = 0;                 // Offene Container (1 = Ergebnis-Array, 2 = Zeile)
+    bool topIsArray_ = false;
+    bool inMessages_ = false;       // Im eingebetteten messages-Objekt (Tiefe 3)
+    Field field_ = Field::NONE;     // Feld des nächsten Werts
+
+    storagedata::FileInfo row_;
+    bool hasFileName_ = false;
+    bool hasFileType_ = false;
+    size_t rowCount_ = 0;
+    storagedata::RowKey lastKey_;
+};
@@ -0,0 +1,392 @@
+#include "CompactListing.h"
+#include "../util/FastParse.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+// ---- UUID ----
+
+bool Uuid::Parse(const std::string& text, Uuid& out) {
+    return FastParse::ParseUuid(text.data(), text.size(), out.hi, out.lo);
+}
+
+std::string Uuid::ToString() const {
+    static const char* HEX = "0123456789abcdef";
+    std::string text(36, '-');
+    int nibble = 0;
+    for (size_t i = 0; i < 36; ++i) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) continue;
+        uint64_t part = nibble < 16 ? hi : lo;
+        text[i] = HEX[(part >> (60 - 4 * (nibble % 16))) & 0xF];
+        ++nibble;
+    }
+    return text;
+}
+
+// ---- MIME / Zeitstempel ----
+
+MimeCategory CategoryOfMime(const std::string& mimeType) {
+    if (mimeType == "audio/midi" || mimeType == "audio/x-midi") return MimeCategory::MIDI;
+    if (mimeType.compare(0, 6, "image/") == 0) return MimeCategory::IMAGE;
+    if (mimeType.compare(0, 6, "audio/") == 0) return MimeCategory::AUDIO;
+    if (mimeType.compare(0, 6, "video/") == 0) return MimeCategory::VIDEO;
+    return MimeCategory::OTHER;
+}
+
+static const int64_t MICROS_PER_SECOND = 1000000;
+static const int64_t SECONDS_PER_DAY = 86400;
+
+std::string FormatTimestamp(int64_t micros, const char* zone) {
+    int64_t seconds = micros / MICROS_PER_SECOND;
+    int64_t fraction = micros % MICROS_PER_SECOND;
+    if (fraction < 0) {
+        fraction += MICROS_PER_SECOND;
+        --seconds;
+    }
+    int64_t days = seconds / SECONDS_PER_DAY;
+    int64_t secondOfDay = seconds % SECONDS_PER_DAY;
+    if (secondOfDay < 0) {
+        secondOfDay += SECONDS_PER_DAY;
+        --days;
+    }
+    int year;
+    unsigned month, day;
+    FastParse::CivilFromDays(days, year, month, day);
+
+    char buffer[64];
+    int length = snprintf(buffer, sizeof(buffer), "%04d-%02u-%02uT%02d:%02d:%02d", year, month, day,
+                          (int)(secondOfDay / 3600), (int)(secondOfDay / 60 % 60), (int)(secondOfDay % 60));
+    // Wie PostgreSQL: Nachkommastellen ohne abschließende Nullen
+    if (fraction != 0) {
+        char digits[8];
+        snprintf(digits, sizeof(digits), "%06lld", (long long)fraction);
+        size_t count = 6;
+        while (count > 0 && digits[count - 1] == '0') --count;
+        buffer[length++] = '.';
+        memcpy(buffer + length, digits, count);
+        length += (int)count;
+    }
+    buffer[length] = '\0';
+    return std::string(buffer) + zone;
+}
+
+// ---- IdSet ----
+
+bool IdSet::Insert(const std::string& id) {
+    Uuid uuid;
+    if (Uuid::Parse(id, uuid)) return uuids_.insert(uuid).second;
+    return others_.insert(id).second;
+}
+
+bool IdSet::Contains(const std::string& id) const {
+    Uuid uuid;
+    if (Uuid::Parse(id, uuid)) return uuids_.count(uuid) > 0;
+    return others_.count(id) > 0;
+}
+
+void IdSet::Erase(const std::string& id) {
+    Uuid uuid;
+    if (Uuid::Parse(id, uuid)) uuids_.erase(uuid);
+    else others_.erase(id);
+}
+
+bool IdSet::Insert(const Uuid& id) {
+    return uuids_.insert(id).second;
+}
+
+bool IdSet::Contains(const Uuid& id) const {
+    return uuids_.count(id) > 0;
+}
+
+void IdSet::Erase(const Uuid& id) {
+    uuids_.erase(id);
+}
+
+void IdSet::Clear() {
+    uuids_.clear();
+    others_.clear();
+}
+
+// ---- CompactListing ----
+
+CompactListing::CompactListing() {
+    Clear();
+}
+
+void CompactListing::Reserve(size_t rows) {
+    rows_.reserve(rows);
+    arena_.reserve(rows * 32);
+}
+
+void CompactListing::Clear() {
+    rows_.clear();
+    arena_.clear();
+    users_.assign(1, std::string());
+    userIndex_.clear();
+    mimeTypes_.assign(1, std::string());
+    mimeIndex_.clear();
+    irregular_.clear();
+}
+
+CompactListing::StringRef CompactListing::Store(const char* data, size_t length) {
+    StringRef ref;
+    ref.offset = (uint32_t)arena_.size();
+    ref.length = (uint32_t)length;
+    arena_.insert(arena_.end(), data, data + length);
+    return ref;
+}
+
+bool CompactListing::LoadEquals(StringRef ref, const char* data, size_t length) const {
+    return ref.length == length && memcmp(arena_.data() + ref.offset, data, length) == 0;
+}
+
+uint32_t CompactListing::InternUser(const std::string& id) {
+    if (id.empty()) return 0;
+    auto it = userIndex_.find(id);
+    if (it != userIndex_.end()) return it->second;
+    uint32_t index = (uint32_t)users_.size();
+    users_.push_back(id);
+    userIndex_.emplace(id, index);
+    return index;
+}
+
+uint16_t CompactListing::InternMime(const std::string& mimeType) {
+    if (mimeType.empty()) return 0;
+    auto it = mimeIndex_.find(mimeType);
+    if (it != mimeIndex_.end()) return it->second;
+    // Praktisch unerreichbar: mehr als 65535 verschiedene MIME-Typen (Kategorie bleibt erhalten)
+    if (mimeTypes_.size() > UINT16_MAX) return 0;
+    uint16_t index = (uint16_t)mimeTypes_.size();
+    mimeTypes_.push_back(mimeType);
+    mimeIndex_.emplace(mimeType, index);
+    return index;
+}
+
+// Nur UUIDs in kanonischer Schreibweise (klein) binär ablegen, damit Text
+// exakt wiederhergestellt wird (Storage-Pfade sind case-sensitive)
+static bool ParseCanonicalUuid(const char* text, size_t length, Uuid& out) {
+    if (!FastParse::ParseUuid(text, length, out.hi, out.lo)) return false;
+    for (size_t i = 0; i < length; ++i) {
+        if (text[i] >= 'A' && text[i] <= 'F') return false;
+    }
+    return true;
+}
+
+CompactListing::Row CompactListing::Pack(const storagedata::FileInfo& info) {
+    Row row;
+    Irregular irregular;
+    if (!ParseCanonicalUuid(info.id.data(), info.id.size(), row.id)) {
+        row.flags |= IRREGULAR_ID;
+        irregular.id = info.id;
+    }
+    // Nur Schreibweisen, die FormatTimestamp exakt wiederherstellt, rein binär
+    // ablegen ("Z", andere Offsets, Nachkommastellen mit Nullen: Text behalten,
+    // die Mikrosekunden gelten trotzdem für Sortierung und Zeiträume)
+    if (!FastParse::ParseTimestamp(info.createdAt.data(), info.createdAt.size(), row.createdAt)) {
+        row.flags |= IRREGULAR_TIME;
+        row.createdAt = INT64_MIN;
+        irregular.createdAt = info.createdAt;
+    } else if (info.createdAt != FormatTimestamp(row.createdAt)) {
+        if (info.createdAt == FormatTimestamp(row.createdAt, "Z")) {
+            row.flags |= TIME_Z;
+        } else {
+            row.flags |= IRREGULAR_TIME;
+            irregular.createdAt = info.createdAt;
+        }
+    }
+    if (row.flags & (IRREGULAR_ID | IRREGULAR_TIME)) {
+        irregular_.push_back(std::move(irregular));
+        row.irregular = (uint32_t)irregular_.size();
+    }
+
+    row.fileSize = info.fileSize;
+    row.mimeType = InternMime(info.fileType);
+    row.category = (uint8_t)CategoryOfMime(info.fileType);
+    row.sender = InternUser(info.senderId);
+
+    // storagePath = "USER_ID/MSG_ID/datei" (sonst unverändert ablegen)
+    const std::string& path = info.storagePath;
+    size_t first = path.find('/');
+    size_t second = first == std::string::npos ? std::string::npos : path.find('/', first + 1);
+    Uuid message;
+    std::string dir;
+    if (second != std::string::npos && first > 0 && ParseCanonicalUuid(path.data() + first + 1, second - first - 1, message)) {
+        row.pathOwner = InternUser(path.substr(0, first));
+        row.pathMessage = message;
+        row.storageLeaf = Store(path.data() + second + 1, path.size() - second - 1);
+        dir = path.substr(0, second + 1);
+    } else {
+        row.flags |= PLAIN_PATH;
+        row.storageLeaf = Store(path);
+    }
+
+    if (!dir.empty() && info.thumbnailPath.size() > dir.size() && info.thumbnailPath.compare(0, dir.size(), dir) == 0 &&
+        info.thumbnailPath.find('/', dir.size()) == std::string::npos) {
+        row.flags |= THUMB_SAME_DIR;
+        row.thumbnail = Store(info.thumbnailPath.data() + dir.size(), info.thumbnailPath.size() - dir.size());
+    } else {
+        row.thumbnail = Store(info.thumbnailPath);
+    }
+
+    if (!(row.flags & PLAIN_PATH) && LoadEquals(row.storageLeaf, info.fileName.data(), info.fileName.size())) {
+        row.flags |= NAME_IS_LEAF;
+        row.fileName = row.storageLeaf;
+    } else {
+        row.fileName = Store(info.fileName);
+    }
+    return row;
+}
+
+void CompactListing::Add(const storagedata::FileInfo& info) {
+    rows_.push_back(Pack(info));
+}
+
+void CompactListing::AddFrom(const CompactListing& other, size_t row) {
+    // Texte kopieren, Indizes auf die eigenen Tabellen umschreiben
+    Row copy = other.rows_[row];
+    const Row& source = other.rows_[row];
+    copy.storageLeaf = Store(other.arena_.data() + source.storageLeaf.offset, source.storageLeaf.length);
+    copy.fileName = (source.flags & NAME_IS_LEAF) ? copy.storageLeaf
+                                                   : Store(other.arena_.data() + source.fileName.offset, source.fileName.length);
+    copy.thumbnail = Store(other.arena_.data() + source.thumbnail.offset, source.thumbnail.length);
+    copy.pathOwner = InternUser(other.users_[source.pathOwner]);
+    copy.sender = InternUser(other.users_[source.sender]);
+    copy.mimeType = InternMime(other.mimeTypes_[source.mimeType]);
+    if (source.irregular) {
+        irregular_.push_back(other.irregular_[source.irregular - 1]);
+        copy.irregular = (uint32_t)irregular_.size();
+    }
+    rows_.push_back(copy);
+}
+
+void CompactListing::Prepend(const std::vector<storagedata::FileInfo>& infos) {
+    std::vector<Row> packed;
+    packed.reserve(infos.size());
+    for (const auto& info : infos) packed.push_back(Pack(info));
+    rows_.insert(rows_.begin(), packed.begin(), packed.end());
+}
+
+// Reihenfolge wie "order=created_at.desc,id.desc". Kanonische UUIDs vergleichen
+// binär wie ihr Text (Hex-Ziffern in Kleinbuchstaben); nicht lesbare Zeitstempel
+// (INT64_MIN) landen am Ende.
+bool CompactListing::Newer(const Row& a, const Row& b) const {
+    if (a.createdAt != b.createdAt) return a.createdAt > b.createdAt;
+    if (!((a.flags | b.flags) & IRREGULAR_ID)) return b.id < a.id;
+    std::string idA = (a.flags & IRREGULAR_ID) ? irregular_[a.irregular - 1].id : a.id.ToString();
+    std::string idB = (b.flags & IRREGULAR_ID) ? irregular_[b.irregular - 1].id : b.id.ToString();
+    return idA > idB;
+}
+
+void CompactListing::Merge(const std::vector<storagedata::FileInfo>& infos, std::vector<size_t>* insertedRows) {
+    if (insertedRows) insertedRows->clear();
+    if (infos.empty()) return;
+    std::vector<Row> packed;
+    packed.reserve(infos.size());
+    for (const auto& info : infos) packed.push_back(Pack(info));
+    std::stable_sort(packed.begin(), packed.end(), [this](const Row& a, const Row& b) { return Newer(a, b); });
+
+    // Wie std::merge (bei Gleichstand die bisherige Zeile zuerst), merkt sich die neuen Positionen
+    std::vector<Row> merged;
+    merged.reserve(rows_.size() + packed.size());
+    size_t old = 0;
+    for (const Row& row : packed) {
+        while (old < rows_.size() && !Newer(row, rows_[old])) merged.push_back(rows_[old++]);
+        if (insertedRows) insertedRows->push_back(merged.size());
+        merged.push_back(row);
+    }
+    merged.insert(merged.end(), rows_.begin() + old, rows_.end());
+    rows_ = std::move(merged);
+}
+
+void CompactListing::Erase(const std::vector<size_t>& rows) {
+    size_t next = 0;
+    size_t kept = 0;
+    for (size_t row = 0; row < rows_.size(); ++row) {
+        if (next < rows.size() && rows[next] == row) {
+            ++next;
+            continue;
+        }
+        if (kept != row) rows_[kept] = rows_[row];
+        ++kept;
+    }
+    rows_.resize(kept);
+}
+
+void CompactListing::Set(size_t row, const storagedata::FileInfo& info) {
+    rows_[row] = Pack(info);
+}
+
+void CompactListing::Retain(const std::function<bool(size_t row)>& keep) {
+    CompactListing kept;
+    kept.Reserve(rows_.size());
+    for (size_t row = 0; row < rows_.size(); ++row) {
+        if (keep(row)) kept.AddFrom(*this, row);
+    }
+    *this = std::move(kept);
+}
+
+std::string CompactListing::StoragePath(const Row& row) const {
+    if (row.flags & PLAIN_PATH) return Load(row.storageLeaf);
+    return users_[row.pathOwner] + "/" + row.pathMessage.ToString() + "/" + Load(row.storageLeaf);
+}
+
+std::string CompactListing::Id(size_t row) const {
+    const Row& r = rows_[row];
+    if (r.flags & IRREGULAR_ID) return irregular_[r.irregular - 1].id;
+    return r.id.ToString();
+}
+
+bool CompactListing::IdUuid(size_t row, Uuid& out) const {
+    const Row& r = rows_[row];
+    if (r.flags & IRREGULAR_ID) return false;
+    out = r.id;
+    return true;
+}
+
+storagedata::RowKey CompactListing::Key(size_t row) const {
+    const Row& r = rows_[row];
+    storagedata::RowKey key;
+    key.id = Id(row);
+    if (r.flags & IRREGULAR_TIME) key.createdAt = irregular_[r.irregular - 1].createdAt;
+    else key.createdAt = FormatTimestamp(r.createdAt, (r.flags & TIME_Z) ? "Z" : "+00:00");
+    return key;
+}
+
+storagedata::FileInfo CompactListing::Get(size_t row) const {
+    const Row& r = rows_[row];
+    storagedata::FileInfo info;
+    storagedata::RowKey key = Key(row);
+    info.id = std::move(key.id);
+    info.createdAt = std::move(key.createdAt);
+    info.fileName = Load(r.fileName);
+    info.fileType = mimeTypes_[r.mimeType];
+    info.fileSize = r.fileSize;
+    info.senderId = users_[r.sender];
+    info.storagePath = StoragePath(r);
+    if (r.flags & THUMB_SAME_DIR) {
+        // Verzeichnis wie in Pack ("USER/MSG/"); das Blatt selbst darf '/' enthalten
+        info.thumbnailPath = users_[r.pathOwner] + "/" + r.pathMessage.ToString() + "/" + Load(r.thumbnail);
+    } else {
+        info.thumbnailPath = Load(r.thumbnail);
+    }
+    return info;
+}
+
+void CompactListing::ToFileInfos(std::vector<storagedata::FileInfo>& out) const {
+    out.clear();
+    out.reserve(rows_.size());
+    for (size_t row = 0; row < rows_.size(); ++row) out.push_back(Get(row));
+}
+
+CompactListing::MemoryUsage CompactListing::GetMemoryUsage() const {
+    MemoryUsage usage;
+    usage.rows = rows_.size();
+    usage.rowBytes = rows_.capacity() * sizeof(Row);
+    usage.arenaBytes = arena_.capacity();
+    // Grobe Schätzung inkl. Hash-Knoten
+    for (const auto& user : users_) usage.internedBytes += sizeof(std::string) * 2 + user.capacity() * 2 + 32;
+    for (const auto& mime : mimeTypes_) usage.internedBytes += sizeof(std::string) * 2 + mime.capacity() * 2 + 32;
+    for (const auto& entry : irregular_) usage.internedBytes += sizeof(Irregular) + entry.id.capacity() + entry.createdAt.capacity();
+    return usage;
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include "../storagedata.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 128-Bit UUID (binär statt 36 Zeichen Text)
+struct Uuid {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    bool IsNil() const { return hi == 0 && lo == 0; }
+    bool operator==(const Uuid& other) const { return hi == other.hi && lo == other.lo; }
+    bool operator!=(const Uuid& other) const { return !(*this == other); }
+    bool operator<(const Uuid& other) const { return hi != other.hi ? hi < other.hi : lo < other.lo; }
+
+    // "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" (Groß/Klein egal); false bei anderem Format
+    static bool Parse(const std::string& text, Uuid& out);
+    std::string ToString() const;  // Kleinbuchstaben
+};
+
+struct UuidHash {
+    size_t operator()(const Uuid& uuid) const {
+        uint64_t h = uuid.hi ^ (uuid.lo * 0x9E3779B97F4A7C15ULL);
+        return (size_t)(h ^ (h >> 32));
+    }
+};
+
+// MIME-Kategorie (Regeln wie die Filter in storagedata::BuildQueryPath)
+enum class MimeCategory : uint8_t { OTHER, IMAGE, AUDIO, MIDI, VIDEO };
+MimeCategory CategoryOfMime(const std::string& mimeType);
+
+// Mikrosekunden seit 1970 (UTC) -> PostgREST-Zeitstempel (Parsen: FastParse::ParseTimestamp)
+// "YYYY-MM-DDTHH:MM:SS[.ffffff]" + zone (Default wie PostgreSQL; die Zeit bleibt UTC)
+std::string FormatTimestamp(int64_t micros, const char* zone = "+00:00");
+
+// Menge von Zeilen-IDs: UUIDs binär, andere IDs als Text
+class IdSet {
+public:
+    bool Insert(const std::string& id);  // false, wenn schon enthalten
+    bool Contains(const std::string& id) const;
+    void Erase(const std::string& id);
+    bool Insert(const Uuid& id);
+    bool Contains(const Uuid& id) const;
+    void Erase(const Uuid& id);
+    void Clear();
+    void Reserve(size_t count) { uuids_.reserve(count); }
+
+private:
+    std::unordered_set<Uuid, UuidHash> uuids_;
+    std::unordered_set<std::string> others_;
+};
+
+// Speichersparendes Listing für sehr viele Zeilen (100k+). Statt sieben
+// std::string pro FileInfo:
+//  - Texte (Dateiname, Blatt der Storage-Pfade) in einer gemeinsamen Arena
+//  - MIME-Typ und User-IDs (Absender, erstes Pfadsegment) interniert
+//  - id und Nachrichten-ID des Pfads ("USER/MSG/datei") als 128-Bit-UUID
+//  - created_at einmal nach int64 Mikrosekunden geparst
+// Zeilen, die nicht ins Schema passen, werden unverändert als Text abgelegt.
+// Nicht thread-safe.
+class CompactListing {
+public:
+    struct MemoryUsage {
+        size_t rows = 0;
+        size_t rowBytes = 0;       // Zeilen-Array
+        size_t arenaBytes = 0;     // String-Arena
+        size_t internedBytes = 0;  // MIME-Typen, User-IDs, Sonderfälle
+        size_t Total() const { return rowBytes + arenaBytes + internedBytes; }
+    };
+
+    CompactListing();
+
+    void Reserve(size_t rows);
+    void Clear();
+
+    void Add(const storagedata::FileInfo& info);
+    void AddFrom(const CompactListing& other, size_t row);   // Ohne Umweg über FileInfo
+    void Prepend(const std::vector<storagedata::FileInfo>& infos);  // Vor die bisherigen Zeilen (Reihenfolge bleibt)
+    // Sortiert einmischen (neueste zuerst nach created_at, dann id; wie der Server).
+    // insertedRows: danach die Zeilennummern der neuen Zeilen (aufsteigend)
+    void Merge(const std::vector<storagedata::FileInfo>& infos, std::vector<size_t>* insertedRows = nullptr);
+    // Entfernt die Zeilen (aufsteigend sortiert); Texte bleiben bis Compact() in der Arena
+    void Erase(const std::vector<size_t>& rows);
+    void Set(size_t row, const storagedata::FileInfo& info); // Alte Texte bleiben bis Compact() in der Arena
+
+    // Behält nur Zeilen, für die keep(row) true liefert, und räumt die Arena auf
+    void Retain(const std::function<bool(size_t row)>& keep);
+    void Compact() { Retain([](size_t) { return true; }); }
+
+    size_t Size() const { return rows_.size(); }
+    bool IsEmpty() const { return rows_.empty(); }
+
+    storagedata::FileInfo Get(size_t row) const;
+    void ToFileInfos(std::vector<storagedata::FileInfo>& out) const;
+
+    std::string Id(size_t row) const;
+    bool IdUuid(size_t row, Uuid& out) const;  // false, wenn die id keine UUID ist
+    storagedata::RowKey Key(size_t row) const;
+    int64_t CreatedAtMicros(size_t row) const { return rows_[row].createdAt; }  // INT64_MIN, wenn nicht lesbar
+    MimeCategory Category(size_t row) const { return (MimeCategory)rows_[row].category; }
+    const std::string& SenderId(size_t row) const { return users_[rows_[row].sender]; }
+
+    MemoryUsage GetMemoryUsage() const;
+
+private:
+    struct StringRef {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    enum : uint8_t {
+        IRREGULAR_ID = 1,          // id ist keine UUID (Text in irregular_)
+        IRREGULAR_TIME = 2,        // created_at nicht aus createdAt reproduzierbar (Text in irregular_)
+        PLAIN_PATH = 4,            // storagePath nicht "USER/MSG/datei": ganzer Pfad in storageLeaf
+        THUMB_SAME_DIR = 8,        // thumbnailPath im Verzeichnis von storagePath: nur das Blatt
+        NAME_IS_LEAF = 16,         // fileName == Blatt von storagePath
+        TIME_Z = 32,               // created_at endet auf "Z" statt "+00:00"
+    };
+
+    struct Row {
+        Uuid id;
+        int64_t createdAt = 0;     // Mikrosekunden seit 1970 (UTC), auch bei IRREGULAR_TIME
+        int64_t fileSize = 0;
+        Uuid pathMessage;          // Zweites Segment von storagePath
+        StringRef fileName;
+        StringRef storageLeaf;
+        StringRef thumbnail;       // Blatt (THUMB_SAME_DIR) oder ganzer Pfad
+        uint32_t pathOwner = 0;    // Erstes Segment von storagePath (users_)
+        uint32_t sender = 0;       // users_
+        uint32_t irregular = 0;    // Index + 1 in irregular_ (0 = keiner)
+        uint16_t mimeType = 0;     // mimeTypes_
+        uint8_t category = 0;      // MimeCategory
+        uint8_t flags = 0;
+    };
+
+    struct Irregular {
+        std::string id;
+        std::string createdAt;
+    };
+
+    Row Pack(const storagedata::FileInfo& info);
+    bool Newer(const Row& a, const Row& b) const;  // a steht in der Liste vor b
+    StringRef Store(const char* data, size_t length);
+    StringRef Store(const std::string& text) { return Store(text.data(), text.size()); }
+    std::string Load(StringRef ref) const { return std::string(arena_.data() + ref.offset, ref.length); }
+    bool LoadEquals(StringRef ref, const char* data, size_t length) const;
+    uint32_t InternUser(const std::string& id);
+    uint16_t InternMime(const std::string& mimeType);
+    std::string StoragePath(const Row& row) const;
+
+    std::vector<Row> rows_;
+    std::vector<char> arena_;
+    std::vector<std::string> users_;                     // [0] = ""
+    std::unordered_map<std::string, uint32_t> userIndex_;
+    std::vector<std::string> mimeTypes_;                 // [0] = ""
+    std::unordered_map<std::string, uint16_t> mimeIndex_;
+    std::vector<Irregular> irregular_;
+};
@@ -0,0 +1,352 @@
+#include "DiskCache.h"
+#include "../util/Md5.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+static const char* INDEX_FILE = "index.txt";
+static const char* INDEX_HEADER = "DegixDAW-DiskCache 1";
+static const uint64_t DEFAULT_MAX_BYTES = 512ULL * 1024 * 1024;
+
+static fs::path DefaultDirectory() {
+#ifdef _WIN32
+    const wchar_t* base = _wgetenv(L"LOCALAPPDATA");
+    if (base && *base) return fs::path(base) / L"DegixDAW" / L"AttachmentCache";
+#else
+    const char* base = std::getenv("XDG_CACHE_HOME");
+    if (base && *base) return fs::path(base) / "degixdaw" / "attachments";
+#endif
+    return fs::path("attachment_cache");
+}
+
+static bool IsHash(const std::string& text) {
+    if (text.size() != 32) return false;
+    for (char c : text) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+    }
+    return true;
+}
+
+static bool ReadFile(const fs::path& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    if (size < 0) return false;
+    file.seekg(0, std::ios::beg);
+    out.resize((size_t)size);
+    return size == 0 || (bool)file.read(&out[0], size);
+}
+
+static bool WriteFileAtomic(const fs::path& target, const std::string& data) {
+    // Eindeutiger Temp-Name, falls zwei Threads denselben Blob schreiben
+    static std::atomic<unsigned> counter{0};
+    fs::path temp = target;
+    temp += ".tmp" + std::to_string(++counter);
+
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(data.data(), (std::streamsize)data.size())) {
+            file.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+DiskCache& DiskCache::Instance() {
+    static DiskCache* cache = [] {
+        DiskCache* instance = new DiskCache();
+        std::string err;
+        if (!instance->Open(DefaultDirectory(), DEFAULT_MAX_BYTES, &err)) {
+            std::ofstream log("debug.log", std::ios::app);
+            log << "DiskCache: " << err << " (Cache deaktiviert)\n";
+        }
+        return instance;
+    }();
+    return *cache;
+}
+
+bool DiskCache::Open(const fs::path& directory, uint64_t maxBytes, std::string* lastError) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = false;
+    entries_.clear();
+    blobs_.clear();
+    lru_.clear();
+    bytes_ = 0;
+
+    std::error_code ec;
+    fs::create_directories(directory / "blobs", ec);
+    if (ec) {
+        if (lastError) *lastError = "Cache-Verzeichnis anlegen fehlgeschlagen: " + ec.message();
+        return false;
+    }
+    directory_ = directory;
+    maxBytes_ = maxBytes;
+
+    LoadIndex();
+    RemoveOrphansLocked();
+    size_t loaded = entries_.size();
+    EvictLocked();
+    if (entries_.size() != loaded || dirty_) SaveIndexLocked();
+    open_ = true;
+
+    std::ofstream log("debug.log", std::ios::app);
+    log << "DiskCache: " << entries_.size() << " Einträge, " << (bytes_ / 1024) << " KB\n";
+    return true;
+}
+
+bool DiskCache::IsOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_;
+}
+
+fs::path DiskCache::Directory() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return directory_;
+}
+
+fs::path DiskCache::BlobPath(const std::string& hash) const {
+    return directory_ / "blobs" / hash.substr(0, 2) / hash;
+}
+
+bool DiskCache::LoadIndex() {
+    std::ifstream file(directory_ / INDEX_FILE);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    if (!std::getline(file, line) || line != INDEX_HEADER) return false;
+
+    // Zeilen "hash größe pfad", zuletzt benutzte zuerst
+    while (std::getline(file, line)) {
+        size_t first = line.find(' ');
+        size_t second = first == std::string::npos ? std::string::npos : line.find(' ', first + 1);
+        if (second == std::string::npos) {
+            dirty_ = true;
+            continue;
+        }
+        std::string hash = line.substr(0, first);
+        uint64_t size = std::strtoull(line.c_str() + first + 1, nullptr, 10);
+        std::string path = line.substr(second + 1);
+
+        std::error_code ec;
+        if (!IsHash(hash) || entries_.count(path) || fs::file_size(BlobPath(hash), ec) != size || ec) {
+            dirty_ = true;
+            continue;
+        }
+
+        Blob& blob = blobs_[hash];
+        if (blob.refs++ == 0) {
+            blob.size = size;
+            bytes_ += size;
+        }
+        lru_.push_back(path);
+        Entry& entry = entries_[path];
+        entry.hash = hash;
+        entry.size = size;
+        entry.lru = std::prev(lru_.end());
+    }
+    return true;
+}
+
+bool DiskCache::SaveIndexLocked() {
+    std::ostringstream out;
+    out << INDEX_HEADER << "\n";
+    for (const auto& path : lru_) {
+        const Entry& entry = entries_[path];
+        out << entry.hash << ' ' << entry.size << ' ' << path << "\n";
+    }
+    dirty_ = false;
+    if (!WriteFileAtomic(directory_ / INDEX_FILE, out.str())) {
+        std::ofstream log("debug.log", std::ios::app);
+        log << "DiskCache: Index speichern fehlgeschlagen\n";
+        return false;
+    }
+    return true;
+}
+
+// Blobs ohne Index-Eintrag und Temp-Dateien abgebrochener Schreibvorgänge
+void DiskCache::RemoveOrphansLocked() {
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(directory_ / "blobs", ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        if (!blobs_.count(it->path().filename().string())) {
+            std::error_code removeError;
+            fs::remove(it->path(), removeError);
+        }
+    }
+}
+
+void DiskCache::Touch(Entry& entry) {
+    if (entry.lru == lru_.begin()) return;
+    lru_.splice(lru_.begin(), lru_, entry.lru);
+    dirty_ = true;
+}
+
+void DiskCache::RemoveLocked(const std::string& storagePath) {
+    auto it = entries_.find(storagePath);
+    if (it == entries_.end()) return;
+
+    auto blob = blobs_.find(it->second.hash);
+    if (blob != blobs_.end() && --blob->second.refs == 0) {
+        std::error_code ec;
+        fs::remove(BlobPath(it->second.hash), ec);
+        bytes_ -= blob->second.size;
+        blobs_.erase(blob);
+    }
+    lru_.erase(it->second.lru);
+    entries_.erase(it);
+}
+
+void DiskCache::EvictLocked() {
+    while (bytes_ > maxBytes_ && !lru_.empty()) {
+        RemoveLocked(lru_.back());
+        ++evictions_;
+    }
+}
+
+bool DiskCache::Get(const std::string& storagePath, std::string& outData) {
+    std::string hash;
+    fs::path file;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = open_ ? entries_.find(storagePath) : entries_.end();
+        if (it == entries_.end()) {
+            ++misses_;
+            return false;
+        }
+        Touch(it->second);
+        hash = it->second.hash;
+        file = BlobPath(hash);
+    }
+
+    // Lesen und Prüfen ohne Lock; beschädigte Einträge werden verworfen
+    bool valid = ReadFile(file, outData) && Md5::Hex(outData) == hash;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!valid) {
+        auto it = entries_.find(storagePath);
+        if (it != entries_.end() && it->second.hash == hash) {
+            std::ofstream log("debug.log", std::ios::app);
+            log << "DiskCache: Eintrag beschädigt, verworfen: " << storagePath << "\n";
+            RemoveLocked(storagePath);
+            SaveIndexLocked();
+        }
+        outData.clear();
+        ++misses_;
+        return false;
+    }
+    ++hits_;
+    return true;
+}
+
+bool DiskCache::Contains(const std::string& storagePath) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(storagePath) > 0;
+}
+
+bool DiskCache::Put(const std::string& storagePath, const std::string& data, std::string* lastError) {
+    if (storagePath.empty() || storagePath.find_first_of("\r\n") != std::string::npos) {
+        if (lastError) *lastError = "Ungültiger Pfad für den Cache";
+        return false;
+    }
+
+    std::string hash = Md5::Hex(data);
+    fs::path target;
+    bool haveBlob;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!open_) {
+            if (lastError) *lastError = "Cache nicht geöffnet";
+            return false;
+        }
+        if (data.size() > maxBytes_) {
+            if (lastError) *lastError = "Datei größer als der Cache";
+            return false;
+        }
+        auto it = entries_.find(storagePath);
+        if (it != entries_.end() && it->second.hash == hash) {
+            Touch(it->second);
+            return true;
+        }
+        haveBlob = blobs_.count(hash) > 0;
+        target = BlobPath(hash);
+    }
+
+    // Inhalt ohne Lock schreiben (Hash im Namen: fertige Blobs ändern sich nie)
+    if (!haveBlob && !WriteFileAtomic(target, data)) {
+        if (lastError) *lastError = "Schreiben in den Cache fehlgeschlagen";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code ec;
+    if (!open_ || !fs::exists(target, ec)) {
+        // Inzwischen verdrängt oder Cache geleert
+        if (lastError) *lastError = "Cache-Eintrag verdrängt";
+        return false;
+    }
+
+    RemoveLocked(storagePath);
+    Blob& blob = blobs_[hash];
+    if (blob.refs++ == 0) {
+        blob.size = data.size();
+        bytes_ += blob.size;
+    }
+    lru_.push_front(storagePath);
+    Entry& entry = entries_[storagePath];
+    entry.hash = hash;
+    entry.size = data.size();
+    entry.lru = lru_.begin();
+
+    EvictLocked();
+    SaveIndexLocked();
+    return true;
+}
+
+void DiskCache::Remove(const std::string& storagePath) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!entries_.count(storagePath)) return;
+    RemoveLocked(storagePath);
+    SaveIndexLocked();
+}
+
+void DiskCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) return;
+    entries_.clear();
+    blobs_.clear();
+    lru_.clear();
+    bytes_ = 0;
+    std::error_code ec;
+    fs::remove_all(directory_ / "blobs", ec);
+    fs::create_directories(directory_ / "blobs", ec);
+    SaveIndexLocked();
+}
+
+void DiskCache::Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_ && dirty_) SaveIndexLocked();
+}
+
+DiskCache::Stats DiskCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    return stats;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Persistenter Cache für heruntergeladene Attachments. Inhalte liegen unter
+// ihrem MD5-Hash (gleiche Datei unter mehreren Pfaden nur einmal), ein Index
+// ordnet Storage-Pfad -> Hash zu. Attachments sind unveränderlich (Pfad enthält
+// die Nachrichten-ID), ein Treffer braucht daher keinen Request.
+//
+// Layout im Cache-Verzeichnis:
+//   blobs/ab/ab12...   Inhalt (Name = MD5)
+//   index.txt          Pfad, Hash, Größe, LRU-Reihenfolge
+// Blobs und Index werden über temporäre Datei + Umbenennen geschrieben, ein
+// Absturz hinterlässt höchstens verwaiste Dateien (beim Öffnen entfernt).
+// Thread-safe.
+class DiskCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        uint64_t bytes = 0;
+    };
+
+    DiskCache() = default;
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
+
+    // Gemeinsame Instanz (%LOCALAPPDATA%\DegixDAW\AttachmentCache, 512 MB)
+    static DiskCache& Instance();
+
+    // Lädt den Index; Einträge ohne passenden Blob werden verworfen
+    bool Open(const std::filesystem::path& directory, uint64_t maxBytes, std::string* lastError = nullptr);
+    bool IsOpen() const;
+    std::filesystem::path Directory() const;  // Auch für andere kleine Zustandsdateien (z.B. PendingDownloads)
+
+    // Liefert den Inhalt, wenn vorhanden und unbeschädigt (Hash wird geprüft)
+    bool Get(const std::string& storagePath, std::string& outData);
+    bool Contains(const std::string& storagePath) const;
+
+    // Speichert den Inhalt und verdrängt älteste Einträge über maxBytes
+    bool Put(const std::string& storagePath, const std::string& data, std::string* lastError = nullptr);
+
+    void Remove(const std::string& storagePath);
+    void Clear();
+
+    // Schreibt die LRU-Reihenfolge (Put/Remove schreiben den Index selbst)
+    void Flush();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        std::string hash;
+        uint64_t size = 0;
+        std::list<std::string>::iterator lru;  // Position in lru_ (vorne = zuletzt benutzt)
+    };
+    struct Blob {
+        uint64_t size = 0;
+        size_t refs = 0;
+    };
+
+    std::filesystem::path BlobPath(const std::string& hash) const;
+    void Touch(Entry& entry);
+    void RemoveLocked(const std::string& storagePath);
+    void EvictLocked();
+    bool LoadIndex();
+    bool SaveIndexLocked();
+    void RemoveOrphansLocked();
+
+    mutable std::mutex mutex_;
+    std::filesystem::path directory_;
+    uint64_t maxBytes_ = 0;
+    bool open_ = false;
+    bool dirty_ = false;                            // LRU-Reihenfolge seit dem letzten Speichern geändert
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_map<std::string, Blob> blobs_;   // Hash -> Blob
+    std::list<std::string> lru_;                    // Storage-Pfade
+    uint64_t bytes_ = 0;                            // Summe der Blobs
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+};
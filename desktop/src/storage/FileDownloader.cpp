@@ -0,0 +1,737 @@
+#include "FileDownloader.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../net/HttpClient.h"
+#include "../util/Md5.h"
+#include "../util/OutputFile.h"
+
+namespace fs = std::filesystem;
+
+namespace FileDownloader {
+    static const char* STATE_HEADER = "DegixDAW-Download 1";
+    // Abstand der Checkpoints (fsync + .meta): höchstens so viel geht bei einem Absturz verloren
+    static const uint64_t CHECKPOINT_BYTES = 32ULL * 1024 * 1024;
+    // Segmentiert: Fortschritt melden bzw. Durchsatz messen in diesen Abständen
+    static const std::chrono::milliseconds PROGRESS_INTERVAL(250);
+    static const std::chrono::milliseconds ADAPT_INTERVAL(1000);
+    // Eine weitere Verbindung bleibt nur, wenn sie den Durchsatz um 15 % steigert
+    static const double ADAPT_GAIN = 1.15;
+    static const int INITIAL_SEGMENTS = 2;
+
+    // Fortsetzbarer Stand der .part-Datei
+    struct PartState {
+        std::string etag;           // Wie vom Server geliefert (inkl. Anführungszeichen)
+        std::string lastModified;
+        int64_t size = -1;          // Gesamtgröße, -1 = unbekannt
+        uint64_t received = 0;      // Bytes ab Dateianfang, sicher in der .part-Datei
+        // Segmentiert: fertige Bereiche hinter received (sortiert, disjunkt, [start, end))
+        std::vector<std::pair<uint64_t, uint64_t>> done;
+
+        bool StrongEtag() const { return !etag.empty() && etag.compare(0, 2, "W/") != 0; }
+
+        // Fortsetzen nur mit bekannter Größe und einem Validator für If-Range
+        bool Resumable() const { return size > 0 && (StrongEtag() || !lastModified.empty()); }
+        std::string IfRange() const { return StrongEtag() ? etag : lastModified; }
+        bool Complete() const { return size >= 0 && received == (uint64_t)size; }
+
+        void MarkDone(uint64_t start, uint64_t end) {
+            done.push_back({ start, end });
+            Normalize();
+        }
+
+        // Bereiche sortieren/zusammenfassen, an received anschließende einrechnen
+        void Normalize() {
+            std::sort(done.begin(), done.end());
+            std::vector<std::pair<uint64_t, uint64_t>> merged;
+            for (const auto& range : done) {
+                if (range.second <= received) continue;
+                if (range.first <= received) {
+                    received = range.second;
+                } else if (!merged.empty() && range.first <= merged.back().second) {
+                    merged.back().second = std::max(merged.back().second, range.second);
+                } else {
+                    merged.push_back(range);
+                }
+            }
+            done.swap(merged);
+        }
+
+        uint64_t CompleteBytes() const {
+            uint64_t bytes = received;
+            for (const auto& range : done) bytes += range.second - range.first;
+            return bytes;
+        }
+
+        // Noch fehlende Bereiche, zerlegt in Stücke von höchstens pieceSize
+        std::vector<std::pair<uint64_t, uint64_t>> Missing(uint64_t pieceSize) const {
+            std::vector<std::pair<uint64_t, uint64_t>> pieces;
+            uint64_t position = received;
+            auto split = [&](uint64_t start, uint64_t end) {
+                for (; start < end; start += pieceSize) pieces.push_back({ start, std::min(end, start + pieceSize) });
+            };
+            for (const auto& range : done) {
+                split(position, range.first);
+                position = range.second;
+            }
+            if (size > 0) split(position, (uint64_t)size);
+            return pieces;
+        }
+    };
+
+    static fs::path PartPath(const fs::path& target) {
+        fs::path path = target;
+        path += ".part";
+        return path;
+    }
+
+    static fs::path StatePath(const fs::path& target) {
+        fs::path path = target;
+        path += ".part.meta";
+        return path;
+    }
+
+    static bool LoadState(const fs::path& path, PartState& state) {
+        std::ifstream file(path);
+        std::string line;
+        if (!file.is_open() || !std::getline(file, line) || line != STATE_HEADER) return false;
+
+        // Zeilen "schlüssel wert"
+        while (std::getline(file, line)) {
+            size_t space = line.find(' ');
+            if (space == std::string::npos) continue;
+            std::string key = line.substr(0, space);
+            std::string value = line.substr(space + 1);
+            if (key == "etag") state.etag = value;
+            else if (key == "modified") state.lastModified = value;
+            else if (key == "size") state.size = std::strtoll(value.c_str(), nullptr, 10);
+            else if (key == "received") state.received = std::strtoull(value.c_str(), nullptr, 10);
+            else if (key == "done") {
+                char* end = nullptr;
+                uint64_t start = std::strtoull(value.c_str(), &end, 10);
+                uint64_t stop = std::strtoull(end, nullptr, 10);
+                if (start < stop) state.done.push_back({ start, stop });
+            }
+        }
+        if (!state.Resumable() || state.received > (uint64_t)state.size) return false;
+        for (const auto& range : state.done) {
+            if (range.second > (uint64_t)state.size) return false;
+        }
+        state.Normalize();
+        return true;
+    }
+
+    // Über Temp-Datei + Umbenennen: ein Absturz hinterlässt den alten oder neuen Stand
+    static bool SaveState(const fs::path& path, const PartState& state) {
+        fs::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            file << STATE_HEADER << "\n"
+                 << "etag " << state.etag << "\n"
+                 << "modified " << state.lastModified << "\n"
+                 << "size " << state.size << "\n"
+                 << "received " << state.received << "\n";
+            for (const auto& range : state.done) file << "done " << range.first << " " << range.second << "\n";
+            if (!file.good()) return false;
+        }
+        std::error_code ec;
+        fs::rename(temp, path, ec);
+        return !ec;
+    }
+
+    static void RemoveFiles(const fs::path& target) {
+        std::error_code ec;
+        fs::remove(PartPath(target), ec);
+        fs::remove(StatePath(target), ec);
+    }
+
+    // "bytes 100-199/1000" -> start 100, last 199, total 1000 (total "*" = unbekannt: false)
+    static bool ParseContentRange(const std::string& value, uint64_t& start, uint64_t& last, uint64_t& total) {
+        if (value.compare(0, 6, "bytes ") != 0) return false;
+        const char* text = value.c_str() + 6;
+        char* end = nullptr;
+        start = std::strtoull(text, &end, 10);
+        if (end == text || *end != '-') return false;
+        last = std::strtoull(end + 1, nullptr, 10);
+        size_t slash = value.find('/');
+        if (slash == std::string::npos || !std::isdigit((unsigned char)value[slash + 1])) return false;
+        total = std::strtoull(value.c_str() + slash + 1, nullptr, 10);
+        return start <= last && last < total;
+    }
+
+    // ETag als MD5 des Inhalts? (Supabase Storage: "\"<32 hex>\"", Multipart-Uploads nicht)
+    static std::string EtagMd5(const std::string& etag) {
+        std::string hash = etag;
+        if (hash.size() >= 2 && hash.front() == '"' && hash.back() == '"') hash = hash.substr(1, hash.size() - 2);
+        if (hash.size() != 32) return "";
+        for (char& c : hash) {
+            if (!std::isxdigit((unsigned char)c)) return "";
+            c = (char)std::tolower((unsigned char)c);
+        }
+        return hash;
+    }
+
+    static bool VerifyContent(const fs::path& path, const PartState& state, std::string* lastError) {
+        std::error_code ec;
+        uint64_t size = fs::file_size(path, ec);
+        if (ec || (state.size >= 0 && size != (uint64_t)state.size)) {
+            if (lastError) *lastError = "Download unvollständig: " + std::to_string(size) + " von " +
+                                        std::to_string(state.size) + " Bytes";
+            return false;
+        }
+
+        std::string expected = EtagMd5(state.etag);
+        if (expected.empty()) return true;
+
+        // Nach Fortsetzen gibt es keinen durchgehenden Hash: Datei einmal lesen
+        std::ifstream file(path, std::ios::binary);
+        std::vector<char> buffer(1024 * 1024);
+        Md5 md5;
+        while (file.read(buffer.data(), (std::streamsize)buffer.size()) || file.gcount() > 0) {
+            md5.Update(buffer.data(), (size_t)file.gcount());
+        }
+        if (!file.eof()) {
+            if (lastError) *lastError = "Prüfen fehlgeschlagen: Datei nicht lesbar";
+            return false;
+        }
+        if (md5.HexDigest() != expected) {
+            if (lastError) *lastError = "Prüfsumme stimmt nicht (ETag " + state.etag + ")";
+            return false;
+        }
+        return true;
+    }
+
+    // Legt erst mit den Antwort-Headern fest, ab wo geschrieben wird: 206 setzt
+    // am angefragten Offset fort, 200 (Range ignoriert oder Datei auf dem Server
+    // geändert) beginnt von vorn mit neuem Validator. Schreibt während des
+    // Empfangs Checkpoints (Schreib-Thread des FileSink).
+    class ResumeSink : public net::BodySink {
+    public:
+        ResumeSink(OutputFile& file, PartState& state, const fs::path& statePath, const Options& options)
+            : file_(file), state_(state), statePath_(statePath), requested_(state.received) {
+            sinkOptions_.bufferSize = options.bufferSize;
+            sinkOptions_.bufferCount = options.bufferCount;
+            // Gesamtgröße melden, auch wenn nur ein Bereich angefragt ist
+            if (options.onProgress) {
+                sinkOptions_.onProgress = [this, onProgress = options.onProgress](uint64_t received, int64_t total) {
+                    return onProgress(received, state_.size >= 0 ? state_.size : total);
+                };
+            }
+            sinkOptions_.onWritten = [this](uint64_t end) { Checkpoint(end, false); };
+        }
+
+        bool Begin(const net::HttpResponse& response, int64_t expectedSize) override {
+            uint64_t offset = 0;
+            if (response.status == 206) {
+                uint64_t start = 0;
+                uint64_t last = 0;
+                uint64_t total = 0;
+                if (!ParseContentRange(response.GetHeader("Content-Range"), start, last, total) || start != requested_ ||
+                    (state_.size >= 0 && total != (uint64_t)state_.size)) {
+                    error_ = "Unerwarteter Content-Range: " + response.GetHeader("Content-Range");
+                    return false;
+                }
+                std::string etag = response.GetHeader("ETag");
+                if (!etag.empty() && state_.StrongEtag() && etag != state_.etag) {
+                    error_ = "ETag geändert";
+                    return false;
+                }
+                offset = start;
+                if (state_.size < 0) {
+                    // Erster Bereich eines neuen Downloads: Validator und Größe übernehmen
+                    state_.etag = etag;
+                    state_.lastModified = response.GetHeader("Last-Modified");
+                    state_.size = (int64_t)total;
+                }
+            } else if (response.IsSuccess()) {
+                state_.etag = response.GetHeader("ETag");
+                state_.lastModified = response.GetHeader("Last-Modified");
+                state_.size = expectedSize;
+                state_.received = 0;
+                state_.done.clear();
+                restarted_ = requested_ > 0;
+            }
+            checkpoint_ = offset;
+            sink_.reset(new net::FileSink(file_, offset, sinkOptions_));
+            return sink_->Begin(response, expectedSize);
+        }
+
+        char* Prepare(size_t& size) override { return sink_->Prepare(size); }
+        bool Commit(size_t size) override { return sink_->Commit(size); }
+
+        // Rest schreiben; bei 2xx zählt alles Geschriebene als empfangen
+        bool Finish(const net::HttpResponse& response, std::string* lastError) {
+            if (!sink_) return true;
+            if (!sink_->Finish(lastError)) return false;
+            if (response.IsSuccess()) Checkpoint(sink_->Offset() + sink_->Written(), true);
+            return true;
+        }
+
+        bool Cancelled() const { return sink_ && sink_->Cancelled(); }
+        bool Restarted() const { return restarted_; }
+        const std::string& Error() const { return error_; }
+
+    private:
+        void Checkpoint(uint64_t end, bool force) {
+            if (!force && end < checkpoint_ + CHECKPOINT_BYTES) return;
+            checkpoint_ = end;
+            state_.received = end;
+            state_.Normalize();
+            // Erst die Daten auf die Platte, dann der Stand, der sie als vorhanden meldet
+            if (state_.Resumable() && file_.Sync()) SaveState(statePath_, state_);
+        }
+
+        OutputFile& file_;
+        PartState& state_;
+        const fs::path& statePath_;
+        const uint64_t requested_;
+        net::FileSink::Options sinkOptions_;
+        std::unique_ptr<net::FileSink> sink_;
+        uint64_t checkpoint_ = 0;
+        bool restarted_ = false;
+        std::string error_;
+    };
+
+    enum class Attempt { DONE, RETRY, FAILED };
+
+    // Ein Request ab state.received, bis limit (0 = Dateiende); aktualisiert state
+    static Attempt Fetch(const std::string& url, OutputFile& file, PartState& state, const fs::path& statePath,
+                         const Options& options, uint64_t limit, std::string& error) {
+        // Ohne Validator kein Range: ein geänderter Inhalt würde sonst angestückelt
+        if (!state.Resumable()) {
+            state.received = 0;
+            state.done.clear();
+        }
+
+        net::HttpRequest request;
+        request.url = url;
+        if (state.received > 0 || limit > 0) {
+            std::string range = "bytes=" + std::to_string(state.received) + "-";
+            if (limit > 0) range += std::to_string(limit - 1);
+            request.headers.push_back({ "Range", range });
+            if (state.Resumable()) request.headers.push_back({ "If-Range", state.IfRange() });
+        }
+        ResumeSink sink(file, state, statePath, options);
+        request.sink = &sink;
+
+        net::HttpResponse response;
+        bool sent = net::HttpClient::Instance().Send(request, response, &error);
+
+        // Auch nach Abbruch: Schreib-Thread beenden und Stand sichern
+        if (!sink.Finish(response, &error)) return Attempt::FAILED;
+        if (sink.Restarted()) {
+            std::ofstream log("debug.log", std::ios::app);
+            log << "FileDownloader: Server lieferte 200 statt 206, Neubeginn\n";
+        }
+        if (sink.Cancelled()) {
+            error = "Download abgebrochen";
+            return Attempt::FAILED;
+        }
+        if (!sink.Error().empty()) {
+            // Server passt nicht zum gespeicherten Stand: von vorn
+            error = sink.Error();
+            state = PartState();
+            return Attempt::RETRY;
+        }
+        if (!sent) return Attempt::RETRY;
+        if (response.status == 416 && state.received == 0) {
+            // Ein Bereich ab 0 ist nur bei leerer Datei nicht erfüllbar
+            state.size = 0;
+            return Attempt::DONE;
+        }
+        if (response.status == 416) {
+            // Angefragter Bereich existiert nicht mehr (Datei kürzer geworden)
+            error = "HTTP 416";
+            state = PartState();
+            return Attempt::RETRY;
+        }
+        if (!response.IsSuccess()) {
+            error = "Download fehlgeschlagen: HTTP " + std::to_string(response.status);
+            return response.status >= 500 ? Attempt::RETRY : Attempt::FAILED;
+        }
+        uint64_t wanted = state.size < 0 ? state.received : (uint64_t)state.size;
+        if (limit > 0 && response.status == 206) wanted = std::min(wanted, limit);
+        if (state.received < wanted) {
+            error = "Download unvollständig: " + std::to_string(state.received) + " von " +
+                    std::to_string(wanted) + " Bytes";
+            return Attempt::RETRY;
+        }
+        if (state.size < 0) state.size = (int64_t)state.received;
+        return Attempt::DONE;
+    }
+
+    // Ein Bereich eines segmentierten Downloads: nur 206 mit genau diesem
+    // Bereich (und unverändertem ETag) wird geschrieben
+    class SegmentSink : public net::BodySink {
+    public:
+        SegmentSink(OutputFile& file, const PartState& state, uint64_t start, uint64_t end, const Options& options,
+                    std::atomic<uint64_t>& received, const std::atomic<bool>& cancel)
+            : file_(file), state_(state), start_(start), end_(end) {
+            sinkOptions_.bufferSize = options.bufferSize;
+            sinkOptions_.bufferCount = 2;   // Je Verbindung; mehrere laufen parallel
+            sinkOptions_.onProgress = [this, &received, &cancel](uint64_t position, int64_t) {
+                received += position - reported_;
+                reported_ = position;
+                return !cancel;
+            };
+        }
+
+        bool Begin(const net::HttpResponse& response, int64_t expectedSize) override {
+            if (response.status == 200) {
+                // If-Range passte nicht mehr (Datei geändert) oder der Server kann keine Bereiche
+                std::string etag = response.GetHeader("ETag");
+                std::string modified = response.GetHeader("Last-Modified");
+                if ((!etag.empty() && etag != state_.etag) || (!modified.empty() && modified != state_.lastModified)) {
+                    mismatch_ = true;
+                } else {
+                    rangesIgnored_ = true;
+                }
+                return false;
+            }
+            if (response.status == 206) {
+                uint64_t start = 0;
+                uint64_t last = 0;
+                uint64_t total = 0;
+                std::string etag = response.GetHeader("ETag");
+                if (!ParseContentRange(response.GetHeader("Content-Range"), start, last, total) || start != start_ ||
+                    total != (uint64_t)state_.size || (!etag.empty() && state_.StrongEtag() && etag != state_.etag)) {
+                    mismatch_ = true;
+                    return false;
+                }
+                if (last + 1 != end_) {
+                    // Bereich ohne das angefragte Ende: Stücke würden sich überlappen
+                    rangesIgnored_ = true;
+                    return false;
+                }
+            }
+            // Fehlerstatus verwirft der FileSink (Verbindung bleibt nutzbar)
+            reported_ = start_;
+            sink_.reset(new net::FileSink(file_, start_, sinkOptions_));
+            return sink_->Begin(response, expectedSize);
+        }
+
+        char* Prepare(size_t& size) override { return sink_->Prepare(size); }
+        bool Commit(size_t size) override { return sink_->Commit(size); }
+
+        bool Finish(std::string* lastError) { return !sink_ || sink_->Finish(lastError); }
+        uint64_t Written() const { return sink_ ? sink_->Written() : 0; }
+        bool RangesIgnored() const { return rangesIgnored_; }
+        bool Mismatch() const { return mismatch_; }
+
+    private:
+        OutputFile& file_;
+        const PartState& state_;
+        const uint64_t start_;
+        const uint64_t end_;
+        net::FileSink::Options sinkOptions_;
+        std::unique_ptr<net::FileSink> sink_;
+        uint64_t reported_ = 0;
+        bool rangesIgnored_ = false;
+        bool mismatch_ = false;
+    };
+
+    // Segmentierter Download: die fehlenden Bereiche werden in Stücke zu
+    // segmentSize zerlegt, Worker holen sie per Range-Request nacheinander über
+    // ihre Keep-Alive-Verbindung und schreiben positionell in die (vorab
+    // angelegte) Datei. Der aufrufende Thread meldet den Fortschritt und misst
+    // den Durchsatz: er beginnt mit INITIAL_SEGMENTS Verbindungen und nimmt so
+    // lange eine hinzu, wie jede weitere ihn um ADAPT_GAIN steigert; bringt die
+    // letzte nichts, wird sie wieder abgebaut.
+    class SegmentedFetch {
+    public:
+        SegmentedFetch(const std::string& url, OutputFile& file, PartState& state, const fs::path& statePath,
+                       const Options& options)
+            : url_(url), file_(file), state_(state), statePath_(statePath), options_(options) {}
+
+        Attempt Run(std::string& error) {
+            for (const auto& piece : state_.Missing(std::max<uint64_t>(options_.segmentSize, 1))) pending_.push_back(piece);
+            if (pending_.empty()) return Attempt::DONE;
+
+            std::string err;
+            if (!file_.Preallocate((uint64_t)state_.size, &err)) {
+                error = err;
+                return Attempt::FAILED;
+            }
+
+            const uint64_t base = state_.CompleteBytes();
+            const int maxSegments = std::max(options_.maxSegments, 1);
+            std::vector<std::thread> workers;
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto spawn = [&] {
+                ++active_;
+                workers.emplace_back([this] { Worker(); });
+            };
+            for (int i = 0; i < std::min(INITIAL_SEGMENTS, maxSegments) && i < (int)pending_.size(); ++i) spawn();
+
+            bool growing = true;
+            double baseline = -1;
+            auto windowStart = std::chrono::steady_clock::now();
+            uint64_t windowBytes = 0;
+            while (!changed_.wait_for(lock, PROGRESS_INTERVAL, [this] { return active_ == 0; })) {
+                uint64_t bytes = received_;
+                lock.unlock();
+                if (options_.onProgress && !options_.onProgress(base + bytes, state_.size)) cancel_ = true;
+                lock.lock();
+
+                auto now = std::chrono::steady_clock::now();
+                if (!growing || now - windowStart < ADAPT_INTERVAL) continue;
+                double rate = (bytes - windowBytes) / std::chrono::duration<double>(now - windowStart).count();
+                windowStart = now;
+                windowBytes = bytes;
+                std::ofstream log("debug.log", std::ios::app);
+                log << "FileDownloader: " << active_ << " Verbindungen, " << (uint64_t)(rate / 1024) << " KB/s\n";
+                if (baseline < 0 || rate >= baseline * ADAPT_GAIN) {
+                    baseline = rate;
+                    if (active_ < maxSegments && !pending_.empty() && !stop_) spawn();
+                    else growing = false;
+                } else {
+                    // Die letzte Verbindung hat nichts gebracht: wieder abbauen
+                    if (active_ > 1) ++retire_;
+                    growing = false;
+                }
+            }
+            lock.unlock();
+            for (auto& worker : workers) worker.join();
+            Checkpoint();
+
+            if (cancel_ && result_ == Attempt::DONE) {
+                error = "Download abgebrochen";
+                return Attempt::FAILED;
+            }
+            if (result_ != Attempt::DONE) {
+                error = error_;
+                return result_;
+            }
+            if (!state_.Complete()) {
+                error = "Download unvollständig: " + std::to_string(state_.CompleteBytes()) + " von " +
+                        std::to_string(state_.size) + " Bytes";
+                return Attempt::RETRY;
+            }
+            if (options_.onProgress) options_.onProgress((uint64_t)state_.size, state_.size);
+            return Attempt::DONE;
+        }
+
+        bool RangesIgnored() const { return rangesIgnored_; }
+        bool Mismatch() const { return mismatch_; }
+        int Connections() const { return peakConnections_; }
+
+    private:
+        void Worker() {
+            while (true) {
+                std::pair<uint64_t, uint64_t> piece;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    peakConnections_ = std::max(peakConnections_, active_);
+                    bool exit = stop_ || cancel_ || pending_.empty();
+                    if (!exit && retire_ > 0) {
+                        --retire_;
+                        exit = true;
+                    }
+                    if (exit) {
+                        --active_;
+                        changed_.notify_all();
+                        return;
+                    }
+                    piece = pending_.front();
+                    pending_.pop_front();
+                }
+
+                net::HttpRequest request;
+                request.url = url_;
+                request.headers.push_back({ "Range", "bytes=" + std::to_string(piece.first) + "-" + std::to_string(piece.second - 1) });
+                request.headers.push_back({ "If-Range", state_.IfRange() });
+                SegmentSink sink(file_, state_, piece.first, piece.second, options_, received_, cancel_);
+                request.sink = &sink;
+                request.http1 = true;   // Eigene TCP-Verbindung je Stück (kein HTTP/2-Multiplexing)
+                net::HttpResponse response;
+                std::string err;
+                bool sent = net::HttpClient::Instance().Send(request, response, &err);
+                std::string writeError;
+                bool written = sink.Finish(&writeError);
+
+                // Geschriebenes zählt auch nach Abbruch; der Rest geht zurück in die Warteschlange
+                uint64_t end = piece.first + (response.status == 206 ? sink.Written() : 0);
+                end = std::min(end, piece.second);
+                bool checkpoint = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (end > piece.first) {
+                        state_.MarkDone(piece.first, end);
+                        sinceCheckpoint_ += end - piece.first;
+                        checkpoint = sinceCheckpoint_ >= CHECKPOINT_BYTES;
+                    }
+                    if (end < piece.second) pending_.push_front({ end, piece.second });
+
+                    if (!written) {
+                        Stop(Attempt::FAILED, writeError);
+                    } else if (sink.RangesIgnored()) {
+                        rangesIgnored_ = true;
+                        Stop(Attempt::RETRY, "Server liefert keine Bereiche");
+                    } else if (sink.Mismatch()) {
+                        // Datei auf dem Server geändert: von vorn
+                        Stop(Attempt::RETRY, "Datei auf dem Server geändert");
+                        mismatch_ = true;
+                    } else if (cancel_) {
+                        stop_ = true;
+                    } else if (!sent || response.status >= 500) {
+                        // Nur dieser Worker hört auf; die übrigen machen weiter
+                        std::string reason = sent ? "HTTP " + std::to_string(response.status) : err;
+                        if (active_ == 1) Stop(Attempt::RETRY, reason);
+                    } else if (response.status != 206) {
+                        Stop(Attempt::FAILED, "Download fehlgeschlagen: HTTP " + std::to_string(response.status));
+                    }
+                    if (stop_ || !sent || response.status != 206) {
+                        --active_;
+                        changed_.notify_all();
+                        break;
+                    }
+                }
+                if (checkpoint) Checkpoint();
+            }
+            Checkpoint();
+        }
+
+        // Mutex gehalten
+        void Stop(Attempt result, const std::string& error) {
+            stop_ = true;
+            cancel_ = true;     // Laufende Bereiche der anderen Worker abbrechen
+            if (result_ == Attempt::FAILED) return;
+            if (result == Attempt::FAILED || result_ == Attempt::DONE) {
+                result_ = result;
+                error_ = error;
+            }
+        }
+
+        // Erst die Daten auf die Platte, dann der Stand, der sie als vorhanden meldet
+        void Checkpoint() {
+            std::lock_guard<std::mutex> checkpointLock(checkpointMutex_);
+            PartState snapshot;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (sinceCheckpoint_ == 0) return;
+                sinceCheckpoint_ = 0;
+                snapshot = state_;
+            }
+            if (file_.Sync()) SaveState(statePath_, snapshot);
+        }
+
+        const std::string& url_;
+        OutputFile& file_;
+        PartState& state_;              // Geschützt durch mutex_, solange Worker laufen
+        const fs::path& statePath_;
+        const Options& options_;
+
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        std::deque<std::pair<uint64_t, uint64_t>> pending_;
+        int active_ = 0;
+        int retire_ = 0;                // So viele Worker hören nach ihrem Bereich auf
+        int peakConnections_ = 0;
+        bool stop_ = false;
+        bool rangesIgnored_ = false;
+        bool mismatch_ = false;
+        Attempt result_ = Attempt::DONE;
+        std::string error_;
+        uint64_t sinceCheckpoint_ = 0;
+        std::mutex checkpointMutex_;
+        std::atomic<uint64_t> received_{0};
+        std::atomic<bool> cancel_{false};
+    };
+
+    static bool Fail(const fs::path& target, OutputFile& file, const PartState& state, const std::string& error,
+                     std::string* lastError) {
+        file.Close();
+        bool keep = state.Resumable() && state.CompleteBytes() > 0;
+        if (!keep) RemoveFiles(target);
+        std::ofstream log("debug.log", std::ios::app);
+        log << "FileDownloader: " << error;
+        if (keep) log << " (fortsetzbar, " << state.CompleteBytes() << " von " << state.size << " Bytes vorhanden)";
+        log << "\n";
+        if (lastError) *lastError = keep ? error + " (erneutes Speichern setzt fort)" : error;
+        return false;
+    }
+
+    bool Download(const std::string& url, const fs::path& target, const Options& options, std::string* lastError) {
+        fs::path partPath = PartPath(target);
+        fs::path statePath = StatePath(target);
+
+        // Vorhandenen Teil nur übernehmen, wenn die Datei mindestens den Checkpoint enthält
+        PartState state;
+        std::error_code ec;
+        bool resume = LoadState(statePath, state) && fs::file_size(partPath, ec) >= state.received && !ec;
+        if (!resume) {
+            state = PartState();
+            fs::remove(statePath, ec);
+        } else {
+            std::ofstream log("debug.log", std::ios::app);
+            log << "FileDownloader: setze fort bei " << state.received << " von " << state.size << " Bytes\n";
+        }
+
+        OutputFile file;
+        std::string err;
+        if (!file.Open(partPath, !resume, &err)) return Fail(target, file, PartState(), err, lastError);
+
+        bool segments = options.maxSegments > 1;
+        int failures = 0;
+        while (!state.Complete()) {
+            Attempt result;
+            if (segments && state.size < 0 && state.received == 0) {
+                // Erster Bereich klärt Größe, Validator und Range-Unterstützung;
+                // kleine Dateien sind damit schon fertig
+                result = Fetch(url, file, state, statePath, options, options.segmentSize, err);
+            } else if (segments && state.Resumable() && (uint64_t)state.size >= options.segmentThreshold) {
+                SegmentedFetch fetch(url, file, state, statePath, options);
+                result = fetch.Run(err);
+                std::ofstream log("debug.log", std::ios::app);
+                log << "FileDownloader: segmentiert, bis zu " << fetch.Connections() << " Verbindungen\n";
+                if (fetch.RangesIgnored()) segments = false;
+                if (fetch.Mismatch()) state = PartState();
+            } else {
+                result = Fetch(url, file, state, statePath, options, 0, err);
+            }
+            if (result == Attempt::DONE) continue;
+            if (result == Attempt::FAILED || ++failures >= options.maxAttempts) {
+                return Fail(target, file, state, err, lastError);
+            }
+            std::ofstream log("debug.log", std::ios::app);
+            log << "FileDownloader: " << err << ", Versuch " << (failures + 1) << " ab " << state.CompleteBytes() << " Bytes\n";
+            log.close();
+            std::this_thread::sleep_for(options.retryDelay * failures);
+        }
+
+        // Vorab-Allokation auf die tatsächliche Länge kürzen, dann auf die Platte
+        if (!file.Truncate(state.received, &err) || !file.Sync(&err)) return Fail(target, file, state, err, lastError);
+        file.Close();
+
+        if (!VerifyContent(partPath, state, &err)) {
+            // Beschädigter Teil ist nicht fortsetzbar
+            return Fail(target, file, PartState(), err, lastError);
+        }
+
+        fs::rename(partPath, target, ec);
+        if (ec) return Fail(target, file, state, "Umbenennen fehlgeschlagen: " + ec.message(), lastError);
+        fs::remove(statePath, ec);
+        return true;
+    }
+
+    bool HasPartial(const fs::path& target) {
+        std::error_code ec;
+        return fs::exists(PartPath(target), ec) && fs::exists(StatePath(target), ec);
+    }
+
+    void DiscardPartial(const fs::path& target) {
+        RemoveFiles(target);
+    }
+}
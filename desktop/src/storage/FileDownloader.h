@@ -0,0 +1,51 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include "../net/FileSink.h"
+
+// Lädt große Attachments (Audio-Stems, Videos) direkt in eine Datei statt in
+// den Speicher. Der Body läuft über einen FileSink (fester Pufferring), die
+// Datei wird vorab auf die Gesamtgröße angelegt und erst nach fsync und
+// Prüfung unter dem Zielnamen sichtbar ("<Ziel>.part" -> Ziel).
+//
+// Fortsetzen: neben der .part-Datei liegt "<Ziel>.part.meta" mit Validator
+// (ETag bzw. Last-Modified), Gesamtgröße und der Anzahl sicher geschriebener
+// Bytes (Checkpoint nach fsync). Nach Verbindungsabbruch und auch nach einem
+// Neustart der App geht es per "Range: bytes=n-" mit If-Range weiter; hat sich
+// die Datei auf dem Server geändert, liefert er 200 und der Download beginnt
+// von vorn. Signierte URLs dürfen sich zwischen den Versuchen ändern.
+// Am Ende wird die Größe und, wenn der ETag eine MD5 ist, der Inhalt geprüft.
+//
+// Segmentiert: der erste Request holt nur die ersten segmentSize Bytes und
+// klärt so Größe und Range-Unterstützung (kleine Dateien sind damit fertig).
+// Ab segmentThreshold holen mehrere HTTP/1.1-Keep-Alive-Verbindungen die übrigen Stücke
+// parallel und schreiben sie positionell in die vorab angelegte Datei; die
+// Anzahl wächst, solange der gemessene Durchsatz mitwächst (bis maxSegments).
+// Fertige Stücke stehen im .meta, ein Fortsetzen holt nur die Lücken.
+// Thread-safe (keine globalen Daten), aber höchstens ein Download je Ziel.
+namespace FileDownloader {
+    struct Options {
+        net::FileSink::ProgressCallback onProgress;     // false bricht ab; nur im aufrufenden Thread
+        size_t bufferSize = 256 * 1024;
+        size_t bufferCount = 4;
+        int maxAttempts = 3;                            // Versuche bei Transport-/5xx-Fehlern
+        std::chrono::milliseconds retryDelay{2000};     // Wartezeit * Versuch
+        uint64_t segmentThreshold = 32ULL * 1024 * 1024; // Darunter ein einzelner Stream
+        uint64_t segmentSize = 8ULL * 1024 * 1024;      // Stückgröße je Range-Request
+        int maxSegments = 6;                            // Parallele Verbindungen; 1 = nie segmentieren
+    };
+
+    // Fehler/Abbruch: ist der Stand fortsetzbar (Validator vorhanden), bleiben
+    // .part und .part.meta für den nächsten Aufruf mit demselben Ziel liegen,
+    // sonst wird aufgeräumt
+    bool Download(const std::string& url, const std::filesystem::path& target, const Options& options,
+                  std::string* lastError = nullptr);
+
+    // Liegt zu target ein fortsetzbarer Teil-Download (.part + .part.meta)?
+    bool HasPartial(const std::filesystem::path& target);
+
+    // Verwirft einen fortsetzbaren Teil-Download zu target
+    void DiscardPartial(const std::filesystem::path& target);
+}
@@ -0,0 +1,262 @@
+#include "ListingSync.h"
+#include "../util/ThreadPool.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+// Worker für SyncAsync (absichtlich nie zerstört: laufende Requests dürfen
+// beim Beenden nicht auf bereits zerstörte Statics treffen)
+static ThreadPool& SyncPool() {
+    static ThreadPool* pool = new ThreadPool(1);
+    return *pool;
+}
+
+ListingSync::ListingSync() : options_(Options()) {}
+
+ListingSync::ListingSync(Options options) : options_(options) {}
+
+ListingSync& ListingSync::Instance() {
+    static ListingSync* instance = new ListingSync();
+    return *instance;
+}
+
+ListingSync::FilterState& ListingSync::State(storagedata::FileFilter filter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& state = states_[filter];
+    if (!state) state.reset(new FilterState());
+    return *state;
+}
+
+bool ListingSync::Sync(storagedata::FileFilter filter, Delta& outDelta, std::string* lastError,
+                       const storagedata::PageCallback& onInitialPage) {
+    FilterState& state = State(filter);
+    std::lock_guard<std::mutex> syncLock(state.syncMutex);
+    outDelta = Delta();
+
+    bool loaded;
+    Clock::time_point now = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        loaded = state.loaded;
+        if (loaded && now - state.lastSync < options_.freshFor) {
+            ++stats_.skipped;
+            return true;
+        }
+    }
+
+    if (!loaded) {
+        if (!LoadFull(state, filter, lastError, onInitialPage)) return false;
+    } else {
+        if (!FetchDelta(state, filter, outDelta, lastError)) return false;
+        if (now - state.lastReconcile >= options_.reconcileEvery) {
+            if (!Reconcile(state, filter, outDelta, lastError)) return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    state.lastSync = Clock::now();
+    return true;
+}
+
+bool ListingSync::LoadFull(FilterState& state, storagedata::FileFilter filter, std::string* lastError,
+                           const storagedata::PageCallback& onInitialPage) {
+    CompactListing files;
+    bool aborted = false;
+    bool ok = storagedata::ListFilesPaged(filter, [&](std::vector<storagedata::FileInfo>& page) {
+        for (const auto& info : page) files.Add(info);
+        if (onInitialPage && !onInitialPage(page)) {
+            aborted = true;
+            return false;
+        }
+        return true;
+    }, storagedata::LIST_PAGE_SIZE, lastError, options_.initialProjection, true);
+
+    // Abgebrochene Loads sind unvollständig und werden nicht übernommen
+    if (!ok || aborted) {
+        if (ok && lastError) *lastError = "Abgebrochen";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    state.files = std::move(files);
+    state.ids.Clear();
+    state.ids.Reserve(state.files.Size());
+    for (size_t row = 0; row < state.files.Size(); ++row) {
+        Uuid uuid;
+        if (state.files.IdUuid(row, uuid)) state.ids.Insert(uuid);
+        else state.ids.Insert(state.files.Id(row));
+    }
+    state.watermark = state.files.IsEmpty() ? storagedata::RowKey() : state.files.Key(0);
+    state.loaded = true;
+    state.lastReconcile = Clock::now();
+    ++stats_.fullLoads;
+    stats_.rowsAdded += state.files.Size();
+    return true;
+}
+
+bool ListingSync::FetchDelta(FilterState& state, storagedata::FileFilter filter, Delta& delta, std::string* lastError) {
+    storagedata::RowKey watermark;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        watermark = state.watermark;
+    }
+
+    // Älteste zuerst: die letzte Zeile ist das neue Watermark
+    std::vector<storagedata::FileInfo> newer;
+    if (!storagedata::ListFilesNewerThan(filter, watermark, newer, lastError)) return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.deltaRequests;
+    if (newer.empty()) return true;
+
+    // Auch wenn alle Zeilen schon bekannt sind (per Reconcile eingemischt oder auf
+    // anderem Weg gesehen): sonst kämen dieselben Zeilen bei jedem Delta wieder
+    state.watermark = storagedata::RowKey{ newer.back().createdAt, newer.back().id };
+
+    std::vector<storagedata::FileInfo> added;
+    added.reserve(newer.size());
+    for (auto it = newer.rbegin(); it != newer.rend(); ++it) {
+        if (state.ids.Insert(it->id)) {
+            added.push_back(*it);
+            ++stats_.rowsAdded;
+        }
+    }
+    if (added.empty()) return true;
+
+    state.files.Prepend(added);
+    delta.added.insert(delta.added.end(), std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()));
+    return true;
+}
+
+// Binär über die UUID vergleichen, ohne die ID als Text zu erzeugen
+static bool ContainsRow(const IdSet& ids, const CompactListing& files, size_t row) {
+    Uuid uuid;
+    return files.IdUuid(row, uuid) ? ids.Contains(uuid) : ids.Contains(files.Id(row));
+}
+
+bool ListingSync::Reconcile(FilterState& state, storagedata::FileFilter filter, Delta& delta, std::string* lastError) {
+    std::vector<storagedata::RowKey> keys;
+    if (!storagedata::ListFileKeys(filter, keys, lastError)) return false;
+
+    IdSet serverIds;
+    serverIds.Reserve(keys.size());
+    for (const auto& key : keys) serverIds.Insert(key.id);
+
+    // Auf dem Server vorhanden, lokal nicht (z.B. verpasst, weil älter als das
+    // Watermark): vollständig nachladen. syncMutex hält andere Syncs fern.
+    std::vector<std::string> unknown;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& key : keys) {
+            if (!state.ids.Contains(key.id)) unknown.push_back(key.id);
+        }
+    }
+    std::vector<storagedata::FileInfo> added;
+    if (!unknown.empty() && !storagedata::FetchFilesByIds(unknown, added, lastError)) return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.reconciles;
+    state.lastReconcile = Clock::now();
+
+    // Retain baut die Arena neu auf: nur, wenn wirklich etwas fehlt
+    size_t before = state.files.Size();
+    bool anyMissing = false;
+    for (size_t row = 0; row < before && !anyMissing; ++row) {
+        anyMissing = !ContainsRow(serverIds, state.files, row);
+    }
+    if (anyMissing) {
+        state.files.Retain([&](size_t row) {
+            if (ContainsRow(serverIds, state.files, row)) return true;
+            Uuid uuid;
+            std::string id = state.files.Id(row);
+            if (state.files.IdUuid(row, uuid)) state.ids.Erase(uuid);
+            else state.ids.Erase(id);
+            delta.removed.push_back(std::move(id));
+            return false;
+        });
+    }
+
+    std::ofstream log("debug.log", std::ios::app);
+    if (state.files.Size() != before) {
+        log << "ListingSync: " << (before - state.files.Size()) << " gelöschte Einträge entfernt\n";
+        stats_.rowsRemoved += before - state.files.Size();
+    }
+
+    added.erase(std::remove_if(added.begin(), added.end(), [&](const storagedata::FileInfo& info) {
+        return !state.ids.Insert(info.id);
+    }), added.end());
+    if (!added.empty()) {
+        state.files.Merge(added);
+        if (state.watermark.IsEmpty()) state.watermark = state.files.Key(0);
+        log << "ListingSync: " << added.size() << " fehlende Einträge nachgeladen\n";
+        stats_.rowsAdded += added.size();
+        delta.added.insert(delta.added.end(), std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()));
+    }
+    return true;
+}
+
+std::shared_ptr<storagedata::ListingStream> ListingSync::SyncAsync(storagedata::FileFilter filter, std::function<void()> onProgress, bool signUrls) {
+    auto stream = std::make_shared<storagedata::ListingStream>();
+
+    SyncPool().Submit([this, stream, filter, onProgress, signUrls]() {
+        Delta delta;
+        std::string error;
+        bool success = Sync(filter, delta, &error, [&](std::vector<storagedata::FileInfo>& page) {
+            if (stream->IsCancelled()) return false;
+            stream->PushPage(std::vector<storagedata::FileInfo>(page));
+            if (onProgress) onProgress();
+            // Nach dem Ausliefern signieren (erste Seite sofort sichtbar)
+            if (signUrls) storagedata::PresignFiles(page);
+            return !stream->IsCancelled();
+        });
+
+        // Delta-Sync: nur die Änderungen liefern (nichts, wenn unverändert)
+        std::vector<std::string> paths;
+        if (success && !delta.IsEmpty()) {
+            if (signUrls) paths = storagedata::SignablePaths(delta.added);
+            stream->PushDelta(std::move(delta.added), std::move(delta.removed));
+        }
+
+        stream->Finish(success, error);
+        if (onProgress) onProgress();
+        if (!paths.empty()) storagedata::PrefetchSignedUrls(paths);
+    });
+    return stream;
+}
+
+bool ListingSync::GetCached(storagedata::FileFilter filter, std::vector<storagedata::FileInfo>& outFiles) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = states_.find(filter);
+    if (it == states_.end() || !it->second->loaded) return false;
+    it->second->files.ToFileInfos(outFiles);
+    return true;
+}
+
+bool ListingSync::IsLoaded(storagedata::FileFilter filter) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = states_.find(filter);
+    return it != states_.end() && it->second->loaded;
+}
+
+void ListingSync::MarkStale(storagedata::FileFilter filter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = states_.find(filter);
+    if (it != states_.end()) it->second->lastSync = Clock::time_point();
+}
+
+void ListingSync::Clear() {
+    // Laufende Syncs halten Referenzen auf States: nur Inhalte zurücksetzen
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : states_) {
+        FilterState& state = *entry.second;
+        state.loaded = false;
+        state.files.Clear();
+        state.ids.Clear();
+        state.watermark = storagedata::RowKey();
+    }
+}
+
+ListingSync::Stats ListingSync::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "../storagedata.h"
+#include "CompactListing.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Lokaler Cache der Attachment-Listings pro FileFilter mit Watermark.
+// Der erste Sync lädt alles (seitenweise), danach werden nur Zeilen neuer als
+// das Watermark (neuestes created_at/id) geholt und eingemischt. Innerhalb von
+// freshFor wird gar nicht angefragt; alle reconcileEvery gleicht ein reiner
+// Schlüssel-Abgleich serverseitig gelöschte Einträge ab und lädt lokal
+// fehlende Zeilen (per ID, vollständig) nach.
+class ListingSync {
+public:
+    struct Options {
+        std::chrono::seconds freshFor = std::chrono::seconds(5);
+        std::chrono::seconds reconcileEvery = std::chrono::seconds(120);
+        storagedata::Projection initialProjection = storagedata::Projection::LIST_ONLY;
+    };
+
+    struct Stats {
+        uint64_t fullLoads = 0;
+        uint64_t deltaRequests = 0;
+        uint64_t skipped = 0;        // Innerhalb von freshFor, kein Request
+        uint64_t reconciles = 0;
+        uint64_t rowsAdded = 0;
+        uint64_t rowsRemoved = 0;
+    };
+
+    // Änderungen eines Syncs gegenüber dem vorherigen Stand
+    struct Delta {
+        std::vector<storagedata::FileInfo> added;   // Neue Zeilen (neueste zuerst)
+        std::vector<std::string> removed;           // IDs serverseitig gelöschter Zeilen
+
+        bool IsEmpty() const { return added.empty() && removed.empty(); }
+    };
+
+    ListingSync();
+    explicit ListingSync(Options options);
+
+    static ListingSync& Instance();
+
+    // Bringt den Cache für filter auf Stand und liefert nur die Änderungen
+    // (innerhalb von freshFor bzw. ohne Änderungen ein leeres Delta).
+    // Das erste, vollständige Laden liefert seine Zeilen ausschließlich über
+    // onInitialPage (pro Seite; false bricht ab, der Cache bleibt dann ungeladen).
+    bool Sync(storagedata::FileFilter filter, Delta& outDelta, std::string* lastError = nullptr,
+              const storagedata::PageCallback& onInitialPage = nullptr);
+
+    // Asynchroner Sync auf einem Worker: beim ersten Laden kommen die Seiten
+    // einzeln, danach (nur bei Änderungen) eine Delta-Seite (ListingPage::delta).
+    std::shared_ptr<storagedata::ListingStream> SyncAsync(storagedata::FileFilter filter, std::function<void()> onProgress, bool signUrls = false);
+
+    // Letzter bekannter Stand ohne Netzwerk (false, wenn noch nie geladen)
+    bool GetCached(storagedata::FileFilter filter, std::vector<storagedata::FileInfo>& outFiles) const;
+
+    // Wurde filter schon vollständig geladen? (Sonst liefert der nächste Sync Seiten statt Deltas)
+    bool IsLoaded(storagedata::FileFilter filter) const;
+
+    // Erzwingt beim nächsten Sync(filter) einen Request (z.B. nach Upload)
+    void MarkStale(storagedata::FileFilter filter);
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct FilterState {
+        std::mutex syncMutex;                          // Serialisiert Syncs desselben Filters
+        bool loaded = false;
+        CompactListing files;                          // Neueste zuerst
+        IdSet ids;
+        storagedata::RowKey watermark;
+        Clock::time_point lastSync;
+        Clock::time_point lastReconcile;
+    };
+
+    FilterState& State(storagedata::FileFilter filter);
+    bool LoadFull(FilterState& state, storagedata::FileFilter filter, std::string* lastError, const storagedata::PageCallback& onInitialPage);
+    bool FetchDelta(FilterState& state, storagedata::FileFilter filter, Delta& delta, std::string* lastError);
+    bool Reconcile(FilterState& state, storagedata::FileFilter filter, Delta& delta, std::string* lastError);
+
+    Options options_;
+    mutable std::mutex mutex_;  // Schützt states_, Inhalte der States und stats_
+    std::map<storagedata::FileFilter, std::unique_ptr<FilterState>> states_;
+    Stats stats_;
+};
@@ -0,0 +1,84 @@
+#include "PendingDownloads.h"
+#include "DiskCache.h"
+#include "FileDownloader.h"
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+static const char* PENDING_FILE = "pending_downloads.txt";
+
+PendingDownloads& PendingDownloads::Instance() {
+    static PendingDownloads* instance = [] {
+        PendingDownloads* pending = new PendingDownloads();
+        pending->Open(DiskCache::Instance().Directory() / PENDING_FILE);
+        return pending;
+    }();
+    return *instance;
+}
+
+bool PendingDownloads::Open(const fs::path& file) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_ = file;
+    entries_.clear();
+
+    std::ifstream in(file_, std::ios::binary);
+    if (!in.is_open()) return true;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t tab = line.find('\t');
+        if (tab == 0 || tab == std::string::npos || tab + 1 == line.size()) continue;
+        entries_[line.substr(0, tab)] = fs::u8path(line.substr(tab + 1));
+    }
+    return true;
+}
+
+void PendingDownloads::Add(const std::string& id, const fs::path& target) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it != entries_.end() && it->second == target) return;
+    entries_[id] = target;
+    SaveLocked();
+}
+
+void PendingDownloads::Remove(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.erase(id)) SaveLocked();
+}
+
+bool PendingDownloads::Find(const std::string& id, fs::path& outTarget) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return false;
+    if (!FileDownloader::HasPartial(it->second)) {
+        entries_.erase(it);
+        SaveLocked();
+        return false;
+    }
+    outTarget = it->second;
+    return true;
+}
+
+bool PendingDownloads::SaveLocked() {
+    if (file_.empty()) return false;
+    std::error_code ec;
+    fs::create_directories(file_.parent_path(), ec);
+
+    fs::path temp = file_;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        for (const auto& entry : entries_) out << entry.first << '\t' << entry.second.u8string() << '\n';
+        if (!out) {
+            out.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+    fs::rename(temp, file_, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
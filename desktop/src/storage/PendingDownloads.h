@@ -0,0 +1,38 @@
+#pragma once
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Unfertige "Speichern unter..."-Downloads: Zeilen-ID -> Zieldatei.
+// FileDownloader setzt nur fort, wenn dasselbe Ziel erneut gewählt wird; mit
+// dieser Liste bietet der FileBrowser das Fortsetzen auch nach einem Neustart an.
+// Liegt als pending_downloads.txt im Verzeichnis des DiskCache (eine Zeile pro
+// Eintrag: ID, Tab, Ziel in UTF-8; Schreiben über temporäre Datei + Umbenennen).
+// Thread-safe.
+class PendingDownloads {
+public:
+    PendingDownloads() = default;
+    PendingDownloads(const PendingDownloads&) = delete;
+    PendingDownloads& operator=(const PendingDownloads&) = delete;
+
+    // Gemeinsame Instanz (neben dem Index von DiskCache::Instance())
+    static PendingDownloads& Instance();
+
+    // Lädt die Liste (fehlende Datei = leer)
+    bool Open(const std::filesystem::path& file);
+
+    void Add(const std::string& id, const std::filesystem::path& target);
+    void Remove(const std::string& id);
+
+    // Ziel eines noch fortsetzbaren Downloads; Einträge ohne Teil-Download
+    // (abgeschlossen, verworfen, gelöscht) werden dabei entfernt
+    bool Find(const std::string& id, std::filesystem::path& outTarget);
+
+private:
+    bool SaveLocked();
+
+    std::mutex mutex_;
+    std::filesystem::path file_;
+    std::map<std::string, std::filesystem::path> entries_;
+};
@@ -0,0 +1,65 @@
+#include "SignedUrlCache.h"
+
+SignedUrlCache::SignedUrlCache(std::chrono::seconds refreshMargin) : refreshMargin_(refreshMargin) {}
+
+SignedUrlCache& SignedUrlCache::Instance() {
+    static SignedUrlCache* instance = new SignedUrlCache();
+    return *instance;
+}
+
+void SignedUrlCache::Put(const std::string& path, const std::string& url, std::chrono::seconds expiresIn) {
+    std::chrono::seconds lifetime = expiresIn > refreshMargin_ ? expiresIn - refreshMargin_ : std::chrono::seconds(0);
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[path] = Entry{ url, Clock::now() + lifetime };
+}
+
+bool SignedUrlCache::Get(const std::string& path, std::string& outUrl) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it == entries_.end() || Clock::now() >= it->second.refreshAt) {
+        ++misses_;
+        return false;
+    }
+    ++hits_;
+    outUrl = it->second.url;
+    return true;
+}
+
+std::vector<std::string> SignedUrlCache::PathsNeedingSignature(const std::vector<std::string>& paths) const {
+    std::vector<std::string> result;
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& path : paths) {
+        auto it = entries_.find(path);
+        if (it == entries_.end() || now >= it->second.refreshAt) {
+            result.push_back(path);
+        }
+    }
+    return result;
+}
+
+void SignedUrlCache::Prune() {
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (now >= it->second.refreshAt) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void SignedUrlCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+SignedUrlCache::Stats SignedUrlCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.entries = entries_.size();
+    return stats;
+}
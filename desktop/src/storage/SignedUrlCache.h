@@ -0,0 +1,53 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Thread-safe Cache für signierte Storage-URLs (Key: storage path).
+// Einträge gelten ab refreshMargin vor Ablauf als veraltet, damit nie eine
+// URL ausgeliefert wird, die während des Downloads abläuft.
+class SignedUrlCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;
+    };
+
+    explicit SignedUrlCache(std::chrono::seconds refreshMargin = std::chrono::seconds(300));
+
+    // Gemeinsame Instanz der Storage-Schicht
+    static SignedUrlCache& Instance();
+
+    // expiresIn wie beim Signieren angefragt; Ablauf wird ab "jetzt" gerechnet
+    void Put(const std::string& path, const std::string& url, std::chrono::seconds expiresIn);
+
+    // Liefert eine noch gültige URL (zählt Hit/Miss)
+    bool Get(const std::string& path, std::string& outUrl);
+
+    // Pfade, die fehlen oder bald ablaufen und neu signiert werden müssen (ohne Statistik)
+    std::vector<std::string> PathsNeedingSignature(const std::vector<std::string>& paths) const;
+
+    // Entfernt abgelaufene Einträge
+    void Prune();
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        std::string url;
+        Clock::time_point refreshAt;  // Ablauf minus refreshMargin
+    };
+
+    std::chrono::seconds refreshMargin_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
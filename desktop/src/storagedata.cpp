@@ -1,8 +1,12 @@
 #include "storagedata.h"
 #include "auth/Auth.h"
-#include "config.h"  // Contains SUPABASE_HOST, SUPABASE_ANON_KEY
-#include <windows.h>
-#include <winhttp.h>
+#include "net/HttpClient.h"
+#include "net/Supabase.h"
+#include "storage/AttachmentJsonParser.h"
+#include "storage/SignedUrlCache.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -10,336 +14,536 @@
 #include <fstream>
 
 // REST API Base Path
-static const wchar_t* ATTACHMENTS_BASE_PATH = L"/rest/v1/message_attachments";
-// Storage API als Fallback
-static const wchar_t* STORAGE_LIST_PATH = L"/storage/v1/object/list/chat-attachments";
+static const char* ATTACHMENTS_BASE_PATH = "/rest/v1/message_attachments";
+// Storage API: Signieren (einzeln: + "/<path>", Batch: ohne Pfad)
+static const char* SIGN_BASE_PATH = "/storage/v1/object/sign/chat-attachments";
+// Maximale Anzahl Pfade pro Batch-Request
+static const size_t SIGN_BATCH_SIZE = 500;
 
 using json = nlohmann::json;
 
-// Helper: Erstellt Query-String basierend auf Filter
-static std::wstring BuildQueryPath(storagedata::FileFilter filter) {
-    std::wstring path = ATTACHMENTS_BASE_PATH;
-    path += L"?select=*,messages!inner(sender_id)&limit=100&order=created_at.desc";
-    
-    switch (filter) {
+// Helper: Prozent-Kodierung für Werte in der Query (z.B. '+' im Zeitstempel)
+static std::string EncodeQueryValue(const std::string& value) {
+    static const char* HEX = "0123456789ABCDEF";
+    std::string encoded;
+    for (unsigned char c : value) {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == ':') {
+            encoded += (char)c;
+        } else {
+            encoded += '%';
+            encoded += HEX[c >> 4];
+            encoded += HEX[c & 0x0F];
+        }
+    }
+    return encoded;
+}
+
+// Spalten, die FileInfo tatsächlich liest, mit der schlanksten Projection,
+// in der sie noch enthalten sind
+struct ColumnSpec {
+    const char* column;
+    storagedata::Projection minProjection;
+};
+static const ColumnSpec FILEINFO_COLUMNS[] = {
+    { "id", storagedata::Projection::KEYS_ONLY },
+    { "created_at", storagedata::Projection::KEYS_ONLY },
+    { "file_name", storagedata::Projection::LIST_ONLY },
+    { "file_type", storagedata::Projection::LIST_ONLY },
+    { "file_size", storagedata::Projection::LIST_ONLY },
+    { "file_url", storagedata::Projection::FULL },
+    { "thumbnail_url", storagedata::Projection::FULL },
+};
+// Inner Join auf messages: liefert nur Anhänge sichtbarer Nachrichten (+ sender_id)
+static const char* MESSAGES_JOIN = "messages!inner(sender_id)";
+
+// Helper: Explizite Spaltenliste statt select=*
+// (Projection ist von FULL nach KEYS_ONLY immer schlanker)
+static std::string BuildSelectClause(storagedata::Projection projection) {
+    std::string select = "select=";
+    for (const auto& spec : FILEINFO_COLUMNS) {
+        if (static_cast<int>(spec.minProjection) > static_cast<int>(projection)) continue;
+        select += spec.column;
+        select += ',';
+    }
+    select += MESSAGES_JOIN;
+    return select;
+}
+
+// Parameter eines Listing-Requests
+struct ListQuery {
+    storagedata::FileFilter filter = storagedata::FileFilter::ALL;
+    storagedata::Projection projection = storagedata::Projection::FULL;
+    size_t limit = storagedata::LIST_PAGE_SIZE;
+    std::string userId;         // Eigene User-ID (nur für RECEIVED)
+    bool ascending = false;     // true: älteste zuerst (Delta ab Watermark)
+};
+
+// Helper: Erstellt Query-String basierend auf Filter.
+// Keyset-Pagination auf (created_at, id); "after" ist die letzte Zeile der
+// vorherigen Seite bzw. das Watermark (nullptr = von Anfang an).
+static std::string BuildQueryPath(const ListQuery& query, const storagedata::RowKey* after) {
+    std::string path = ATTACHMENTS_BASE_PATH;
+    path += "?" + BuildSelectClause(query.projection);
+    path += query.ascending ? "&order=created_at.asc,id.asc" : "&order=created_at.desc,id.desc";
+    path += "&limit=" + std::to_string(query.limit);
+
+    if (after) {
+        // Werte in Anführungszeichen, da Zeitstempel ':' und '.' enthalten
+        const char* op = query.ascending ? "gt" : "lt";
+        std::string createdAt = EncodeQueryValue("\"" + after->createdAt + "\"");
+        std::string id = EncodeQueryValue("\"" + after->id + "\"");
+        path += std::string("&or=(created_at.") + op + "." + createdAt + ",and(created_at.eq." + createdAt + ",id." + op + "." + id + "))";
+    }
+
+    switch (query.filter) {
         case storagedata::FileFilter::IMAGES:
-            path += L"&file_type=like.image*";
+            path += "&file_type=like.image*";
             break;
         case storagedata::FileFilter::AUDIO:
-            path += L"&file_type=like.audio*";
+            path += "&file_type=like.audio*";
             break;
         case storagedata::FileFilter::MIDI:
-            path += L"&file_type=in.(audio/midi,audio/x-midi)";
+            path += "&file_type=in.(audio/midi,audio/x-midi)";
             break;
         case storagedata::FileFilter::VIDEO:
-            path += L"&file_type=like.video*";
+            path += "&file_type=like.video*";
             break;
         case storagedata::FileFilter::RECEIVED:
-            // Filter wird später im Code angewendet (braucht current_user_id)
+            // Serverseitig: nur Anhänge von Nachrichten anderer User (über den inner join)
+            path += "&messages.sender_id=neq." + EncodeQueryValue(query.userId);
             break;
         case storagedata::FileFilter::ALL:
         default:
             // Keine zusätzlichen Filter
             break;
     }
-    
+
     return path;
 }
 
+// Helper: Lädt eine Seite und wandelt die JSON-Zeilen beim Empfang in FileInfo um
+// (AttachmentJsonParser, ohne DOM und ohne den Body zu puffern).
+// rowCount/cursor beziehen sich auf alle gelieferten Zeilen (auch übersprungene).
+// keysOnly: Zeilen enthalten nur id/created_at (Projection::KEYS_ONLY).
+static bool FetchPage(const std::string& queryPath, bool keysOnly, std::vector<storagedata::FileInfo>& outFiles, size_t& rowCount,
+                      storagedata::RowKey& cursor, std::ofstream& log, std::string* lastError) {
+    log << "Query Path: " << queryPath << "\n";
+
+    std::string accessToken = Auth::GetAccessToken();
+    if (accessToken.empty()) {
+        log << "WARNUNG: Kein JWT-Token verfügbar, verwende ANON_KEY (RLS könnte blockieren)\n";
+    }
+
+    size_t firstNew = outFiles.size();
+    AttachmentJsonParser parser(keysOnly, outFiles);
+    net::HttpResponse httpResponse;
+    std::string errorBody;
+    size_t bodyBytes = 0;
+
+    net::HttpRequest request;
+    request.url = net::SupabaseUrl(queryPath);
+    net::AddSupabaseHeaders(request, accessToken);
+    request.headers.push_back({ "Prefer", "return=representation" });
+    request.onBody = [&](const char* data, size_t size) {
+        bodyBytes += size;
+        // Fehlerantworten sind klein und werden für die Meldung gesammelt
+        if (!httpResponse.IsSuccess()) {
+            errorBody.append(data, size);
+            return true;
+        }
+        return parser.Feed(data, size);
+    };
+
+    bool sent = net::HttpClient::Instance().Send(request, httpResponse, lastError);
+    if (!parser.Error().empty()) {
+        if (lastError) *lastError = "JSON-Parsing fehlgeschlagen: " + parser.Error();
+        log << "JSON-Parsing fehlgeschlagen: " << parser.Error() << "\n";
+        return false;
+    }
+    if (!sent) {
+        log << "HTTP-Request fehlgeschlagen\n";
+        return false;
+    }
+    log << "HTTP-Status: " << httpResponse.status << ", " << bodyBytes << " Bytes\n";
+
+    if (!httpResponse.IsSuccess()) {
+        log << "Response: " << errorBody << "\n";
+        if (lastError) *lastError = "HTTP " + std::to_string(httpResponse.status) + ": " + errorBody;
+        return false;
+    }
+    if (!parser.Finish()) {
+        if (lastError) *lastError = "JSON-Parsing fehlgeschlagen: " + parser.Error();
+        log << "JSON-Parsing fehlgeschlagen: " << parser.Error() << "\n";
+        return false;
+    }
+
+    rowCount = parser.RowCount();
+    if (rowCount > 0) cursor = parser.LastKey();
+    if (!keysOnly) {
+        for (size_t i = firstNew; i < outFiles.size(); ++i) {
+            log << "Datei gefunden: " << outFiles[i].fileName << " -> " << outFiles[i].storagePath << "\n";
+        }
+    }
+    return true;
+}
+
+// Helper: Supabase liefert signedURL relativ zu /storage/v1
+static std::string ToAbsoluteSignedUrl(const std::string& signedUrl) {
+    if (!signedUrl.empty() && signedUrl[0] == '/') {
+        return net::SupabaseUrl("/storage/v1" + signedUrl);
+    }
+    return signedUrl;
+}
+
+// Helper: POST an die Sign-API mit JWT
+static bool PostSignRequest(const std::string& path, const json& body, json& outResponse, std::string* lastError) {
+    std::string jwt = Auth::GetAccessToken();
+    if (jwt.empty()) {
+        if (lastError) *lastError = "Kein JWT-Token verfügbar";
+        return false;
+    }
+
+    net::HttpRequest request;
+    request.method = "POST";
+    request.url = net::SupabaseUrl(path);
+    net::AddSupabaseHeaders(request, jwt);
+    request.headers.push_back({ "Content-Type", "application/json" });
+    request.body = body.dump();
+
+    net::HttpResponse response;
+    if (!net::HttpClient::Instance().Send(request, response, lastError)) {
+        return false;
+    }
+    if (!response.IsSuccess()) {
+        if (lastError) *lastError = "Signieren fehlgeschlagen (HTTP " + std::to_string(response.status) + "): " + response.body;
+        return false;
+    }
+
+    try {
+        outResponse = json::parse(response.body);
+    } catch (const std::exception& ex) {
+        if (lastError) *lastError = std::string("JSON-Parsing fehlgeschlagen: ") + ex.what();
+        return false;
+    }
+    return true;
+}
+
 namespace storagedata {
-    // Neue API: Returns detailed FileInfo structs
-    bool ListFilesDetailed(std::vector<FileInfo>& outFiles, FileFilter filter, std::string* lastError) {
+    bool CreateSignedUrl(const std::string& storagePath, std::string& outUrl, int expiresIn, std::string* lastError) {
+        json response;
+        if (!PostSignRequest(std::string(SIGN_BASE_PATH) + "/" + storagePath, json{ { "expiresIn", expiresIn } }, response, lastError)) {
+            return false;
+        }
+        if (!response.is_object() || !response.contains("signedURL") || !response["signedURL"].is_string()) {
+            if (lastError) *lastError = "Antwort enthält keine signedURL";
+            return false;
+        }
+        outUrl = ToAbsoluteSignedUrl(response["signedURL"].get<std::string>());
+        SignedUrlCache::Instance().Put(storagePath, outUrl, std::chrono::seconds(expiresIn));
+        return true;
+    }
+
+    bool CreateSignedUrls(const std::vector<std::string>& storagePaths, std::vector<SignedUrl>& outUrls, int expiresIn, std::string* lastError) {
         std::ofstream log("debug.log", std::ios::app);
-        outFiles.clear();
+        outUrls.clear();
 
-        log << "=== ListFilesDetailed called with filter: " << static_cast<int>(filter) << " ===\n";
+        for (size_t offset = 0; offset < storagePaths.size(); offset += SIGN_BATCH_SIZE) {
+            size_t end = std::min(storagePaths.size(), offset + SIGN_BATCH_SIZE);
+            json body;
+            body["expiresIn"] = expiresIn;
+            body["paths"] = std::vector<std::string>(storagePaths.begin() + offset, storagePaths.begin() + end);
 
-        HINTERNET hSession = WinHttpOpen(L"DegixDAW-VST/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, NULL, NULL, 0);
-        if (!hSession) { if (lastError) *lastError = "WinHttpOpen fehlgeschlagen"; log << "WinHttpOpen fehlgeschlagen\n"; return false; }
+            json response;
+            if (!PostSignRequest(SIGN_BASE_PATH, body, response, lastError)) {
+                log << "Batch-Signierung fehlgeschlagen\n";
+                return false;
+            }
+            if (!response.is_array()) {
+                if (lastError) *lastError = "Batch-Antwort ist kein Array";
+                return false;
+            }
+
+            for (const auto& entry : response) {
+                SignedUrl signedUrl;
+                if (entry.contains("path") && entry["path"].is_string()) signedUrl.path = entry["path"].get<std::string>();
+                if (entry.contains("signedURL") && entry["signedURL"].is_string()) {
+                    signedUrl.url = ToAbsoluteSignedUrl(entry["signedURL"].get<std::string>());
+                    SignedUrlCache::Instance().Put(signedUrl.path, signedUrl.url, std::chrono::seconds(expiresIn));
+                } else if (entry.contains("error") && entry["error"].is_string()) {
+                    signedUrl.error = entry["error"].get<std::string>();
+                }
+                outUrls.push_back(signedUrl);
+            }
+        }
 
-        HINTERNET hConnect = WinHttpConnect(hSession, SUPABASE_HOST, INTERNET_DEFAULT_HTTPS_PORT, 0);
-        if (!hConnect) { if (lastError) *lastError = "WinHttpConnect fehlgeschlagen"; log << "WinHttpConnect fehlgeschlagen\n"; WinHttpCloseHandle(hSession); return false; }
+        log << "Batch-Signierung: " << outUrls.size() << " URLs für " << storagePaths.size() << " Pfade\n";
+        return true;
+    }
 
-        std::wstring queryPath = BuildQueryPath(filter);
-        log << "Query Path: " << std::string(queryPath.begin(), queryPath.end()) << "\n";
+    bool GetSignedUrl(const std::string& storagePath, std::string& outUrl, std::string* lastError) {
+        if (SignedUrlCache::Instance().Get(storagePath, outUrl)) {
+            return true;
+        }
+        return CreateSignedUrl(storagePath, outUrl, SIGNED_URL_EXPIRES_IN, lastError);
+    }
 
-        HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"GET", queryPath.c_str(), NULL, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, WINHTTP_FLAG_SECURE);
-        if (!hRequest) { if (lastError) *lastError = "WinHttpOpenRequest fehlgeschlagen"; log << "WinHttpOpenRequest fehlgeschlagen\n"; WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false; }
+    std::string ImageTransform::Key() const {
+        return "w" + std::to_string(width) + "h" + std::to_string(height) + "q" + std::to_string(quality);
+    }
 
-        std::string accessToken = Auth::GetAccessToken();
-        if (accessToken.empty()) {
-            log << "WARNUNG: Kein JWT-Token verfügbar, verwende ANON_KEY (RLS könnte blockieren)\n";
-            accessToken = SUPABASE_ANON_KEY;
-        } else {
-            log << "JWT-Token gefunden, verwende authentifizierten Zugriff\n";
+    bool GetSignedRenderUrl(const std::string& storagePath, const ImageTransform& transform, std::string& outUrl, std::string* lastError) {
+        std::string cacheKey = storagePath + "#" + transform.Key();
+        if (SignedUrlCache::Instance().Get(cacheKey, outUrl)) {
+            return true;
         }
 
-        std::wstring headers = L"apikey: ";
-        headers += std::wstring(SUPABASE_ANON_KEY, SUPABASE_ANON_KEY + strlen(SUPABASE_ANON_KEY));
-        headers += L"\r\nAuthorization: Bearer ";
-        headers += std::wstring(accessToken.begin(), accessToken.end());
-        headers += L"\r\nPrefer: return=representation";
-
-        BOOL bResults = WinHttpSendRequest(hRequest, headers.c_str(), (DWORD)headers.length(), WINHTTP_NO_REQUEST_DATA, 0, 0, 0);
-        if (!bResults) {
-            if (lastError) *lastError = "WinHttpSendRequest fehlgeschlagen";
-            log << "WinHttpSendRequest fehlgeschlagen\n";
-            WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false;
+        // Mit "transform" liefert die Sign-API eine /render/image/sign/...-URL
+        json body;
+        body["expiresIn"] = SIGNED_URL_EXPIRES_IN;
+        body["transform"] = json{ { "width", transform.width }, { "height", transform.height },
+                                  { "resize", "contain" }, { "quality", transform.quality } };
+        json response;
+        if (!PostSignRequest(std::string(SIGN_BASE_PATH) + "/" + storagePath, body, response, lastError)) {
+            return false;
         }
+        if (!response.is_object() || !response.contains("signedURL") || !response["signedURL"].is_string()) {
+            if (lastError) *lastError = "Antwort enthält keine signedURL";
+            return false;
+        }
+        outUrl = ToAbsoluteSignedUrl(response["signedURL"].get<std::string>());
+        SignedUrlCache::Instance().Put(cacheKey, outUrl, std::chrono::seconds(SIGNED_URL_EXPIRES_IN));
+        return true;
+    }
 
-        bResults = WinHttpReceiveResponse(hRequest, NULL);
-        if (!bResults) {
-            if (lastError) *lastError = "WinHttpReceiveResponse fehlgeschlagen";
-            log << "WinHttpReceiveResponse fehlgeschlagen\n";
-            WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false;
+    bool PrefetchSignedUrls(const std::vector<std::string>& storagePaths, std::string* lastError) {
+        std::vector<std::string> missing = SignedUrlCache::Instance().PathsNeedingSignature(storagePaths);
+        if (missing.empty()) {
+            return true;
         }
+        std::vector<SignedUrl> signedUrls;
+        return CreateSignedUrls(missing, signedUrls, SIGNED_URL_EXPIRES_IN, lastError);
+    }
 
-        DWORD dwStatusCode = 0; DWORD dwSize = sizeof(dwStatusCode);
-        WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, NULL, &dwStatusCode, &dwSize, NULL);
-        log << "HTTP-Status: " << dwStatusCode << "\n";
-
-        WinHttpQueryDataAvailable(hRequest, &dwSize);
-        std::string response;
-        while (dwSize > 0) {
-            std::vector<char> buffer(dwSize);
-            DWORD dwDownloaded = 0;
-            WinHttpReadData(hRequest, buffer.data(), dwSize, &dwDownloaded);
-            response.append(buffer.data(), dwDownloaded);
-            WinHttpQueryDataAvailable(hRequest, &dwSize);
+    // Helper: Setzt query.userId für RECEIVED (braucht die eigene User-ID aus dem JWT)
+    static bool ResolveUserId(ListQuery& query, std::ofstream& log, std::string* lastError) {
+        if (query.filter != FileFilter::RECEIVED) return true;
+        query.userId = Auth::GetUserId();
+        if (query.userId.empty()) {
+            if (lastError) *lastError = "Empfangene Dateien: keine User-ID im JWT (nicht angemeldet?)";
+            log << "RECEIVED-Filter ohne User-ID\n";
+            return false;
         }
-        log << "Response: " << response << "\n";
-        WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession);
-
-        try {
-            auto j = json::parse(response);
-            if (j.is_array() && !j.empty()) {
-                for (const auto& entry : j) {
-                    if (entry.contains("file_name") && entry.contains("file_url")) {
-                        FileInfo info;
-
-                        // Handle null values properly
-                        info.id = (entry.contains("id") && !entry["id"].is_null()) ? entry["id"].get<std::string>() : "";
-                        info.fileName = entry["file_name"].get<std::string>();
-                        info.fileType = (entry.contains("file_type") && !entry["file_type"].is_null()) ? entry["file_type"].get<std::string>() : "unknown";
-
-                        // Extract storage path from full URL
-                        // URL format: https://HOST/storage/v1/object/public/chat-attachments/USER_ID/MSG_ID/FILE.jpg
-                        // We need: USER_ID/MSG_ID/FILE.jpg
-                        std::string fullUrl = entry["file_url"].get<std::string>();
-                        size_t pos = fullUrl.find("/chat-attachments/");
-                        if (pos != std::string::npos) {
-                            info.storagePath = fullUrl.substr(pos + 18); // Skip "/chat-attachments/"
-                        } else {
-                            info.storagePath = fullUrl; // Fallback
-                        }
-
-                        // Same for thumbnail
-                        if (entry.contains("thumbnail_url") && !entry["thumbnail_url"].is_null()) {
-                            std::string thumbUrl = entry["thumbnail_url"].get<std::string>();
-                            size_t thumbPos = thumbUrl.find("/chat-attachments/");
-                            if (thumbPos != std::string::npos) {
-                                info.thumbnailPath = thumbUrl.substr(thumbPos + 18);
-                            } else {
-                                info.thumbnailPath = thumbUrl;
-                            }
-                        } else {
-                            info.thumbnailPath = "";
-                        }
-
-                        info.fileSize = (entry.contains("file_size") && !entry["file_size"].is_null()) ? entry["file_size"].get<long long>() : 0LL;
-                        info.createdAt = (entry.contains("created_at") && !entry["created_at"].is_null()) ? entry["created_at"].get<std::string>() : "";
-
-                        outFiles.push_back(info);
-                        log << "Datei gefunden: " << info.fileName << " -> " << info.storagePath << "\n";
-                    }
-                }
+        log << "RECEIVED-Filter für User: " << query.userId << "\n";
+        return true;
+    }
+
+    // Helper: Seitenweises Listing ab start (nullptr = von Anfang an); die erste
+    // Seite kann eine andere Projection nutzen. aborted: onPage hat false geliefert.
+    static bool ListPages(ListQuery query, Projection firstPageProjection, const RowKey* start, const PageCallback& onPage,
+                          std::string* lastError, bool* aborted = nullptr) {
+        std::ofstream log("debug.log", std::ios::app);
+        log << "=== ListFilesPaged called with filter: " << static_cast<int>(query.filter) << ", pageSize: " << query.limit
+            << ", projection: " << static_cast<int>(query.projection) << (start ? ", delta" : "") << " ===\n";
+        if (query.limit == 0) query.limit = LIST_PAGE_SIZE;
+        if (aborted) *aborted = false;
+        if (!ResolveUserId(query, log, lastError)) return false;
+
+        Projection projection = query.projection;
+        RowKey cursor;
+        bool firstPage = true;
+        size_t total = 0;
+        while (true) {
+            std::vector<FileInfo> page;
+            size_t rowCount = 0;
+            query.projection = firstPage ? firstPageProjection : projection;
+            std::string queryPath = BuildQueryPath(query, firstPage ? start : &cursor);
+            if (!FetchPage(queryPath, query.projection == Projection::KEYS_ONLY, page, rowCount, cursor, log, lastError)) {
+                return false;
+            }
+            firstPage = false;
+            total += page.size();
+
+            if (!page.empty() && !onPage(page)) {
+                log << "Abgebrochen nach " << total << " Einträgen.\n";
+                if (aborted) *aborted = true;
+                return true;
+            }
+            // Letzte Seite erreicht (oder Cursor unbrauchbar)
+            if (rowCount < query.limit || cursor.createdAt.empty() || cursor.id.empty()) {
+                break;
             }
-        } catch (const std::exception& ex) {
-            if (lastError) *lastError = std::string("JSON-Parsing fehlgeschlagen: ") + ex.what();
-            log << "JSON-Parsing fehlgeschlagen: " << ex.what() << "\n";
-            return false;
         }
 
-        log << "Fertig. " << outFiles.size() << " Einträge.\n";
+        log << "Fertig. " << total << " Einträge.\n";
         return true;
     }
 
-    // Legacy API: Wrapper around ListFilesDetailed
-    bool ListFiles(std::vector<std::string>& outFiles, FileFilter filter, std::string* lastError) {
-        std::vector<FileInfo> detailedFiles;
-        if (!ListFilesDetailed(detailedFiles, filter, lastError)) {
+    bool ListFilesPaged(FileFilter filter, const PageCallback& onPage, size_t pageSize, std::string* lastError,
+                        Projection projection, bool fullFirstPage) {
+        ListQuery query;
+        query.filter = filter;
+        query.projection = projection;
+        query.limit = pageSize;
+        return ListPages(query, fullFirstPage ? Projection::FULL : projection, nullptr, onPage, lastError);
+    }
+
+    bool ListFilesNewerThan(FileFilter filter, const RowKey& watermark, std::vector<FileInfo>& outFiles, std::string* lastError) {
+        outFiles.clear();
+        ListQuery query;
+        query.filter = filter;
+        query.ascending = true;
+        return ListPages(query, Projection::FULL, watermark.IsEmpty() ? nullptr : &watermark, [&outFiles](std::vector<FileInfo>& page) {
+            outFiles.insert(outFiles.end(), std::make_move_iterator(page.begin()), std::make_move_iterator(page.end()));
+            return true;
+        }, lastError);
+    }
+
+    bool ListFileKeys(FileFilter filter, std::vector<RowKey>& outKeys, std::string* lastError) {
+        outKeys.clear();
+        ListQuery query;
+        query.filter = filter;
+        query.projection = Projection::KEYS_ONLY;
+        query.limit = KEYS_PAGE_SIZE;
+        return ListPages(query, Projection::KEYS_ONLY, nullptr, [&outKeys](std::vector<FileInfo>& page) {
+            for (const auto& info : page) {
+                outKeys.push_back(RowKey{ info.createdAt, info.id });
+            }
+            return true;
+        }, lastError);
+    }
+
+    bool FetchFileDetails(FileInfo& info, std::string* lastError) {
+        std::ofstream log("debug.log", std::ios::app);
+        log << "=== FetchFileDetails: " << info.id << " ===\n";
+        if (info.id.empty()) {
+            if (lastError) *lastError = "FileInfo ohne id";
             return false;
         }
 
-        // Convert FileInfo to display strings
-        outFiles.clear();
-        for (const auto& info : detailedFiles) {
-            outFiles.push_back(info.GetDisplayName());
+        std::string queryPath = ATTACHMENTS_BASE_PATH;
+        queryPath += "?" + BuildSelectClause(Projection::FULL) + "&id=eq." + EncodeQueryValue(info.id) + "&limit=1";
+
+        std::vector<FileInfo> rows;
+        size_t rowCount = 0;
+        RowKey cursor;
+        if (!FetchPage(queryPath, false, rows, rowCount, cursor, log, lastError)) {
+            return false;
+        }
+        if (rows.empty()) {
+            if (lastError) *lastError = "Datei nicht gefunden: " + info.id;
+            return false;
         }
+        info = std::move(rows.front());
         return true;
     }
 
-    // OLD IMPLEMENTATION - DEPRECATED - keeping for reference
-    bool ListFiles_OLD(std::vector<std::string>& outFiles, FileFilter filter, std::string* lastError) {
+    bool FetchFilesByIds(const std::vector<std::string>& ids, std::vector<FileInfo>& outFiles, std::string* lastError) {
         std::ofstream log("debug.log", std::ios::app);
+        log << "=== FetchFilesByIds: " << ids.size() << " IDs ===\n";
         outFiles.clear();
 
-        log << "=== ListFiles_OLD called with filter: " << static_cast<int>(filter) << " ===\n";
-        
-        HINTERNET hSession = WinHttpOpen(L"DegixDAW-VST/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, NULL, NULL, 0);
-        if (!hSession) { if (lastError) *lastError = "WinHttpOpen fehlgeschlagen"; log << "WinHttpOpen fehlgeschlagen\n"; return false; }
-        
-        HINTERNET hConnect = WinHttpConnect(hSession, SUPABASE_HOST, INTERNET_DEFAULT_HTTPS_PORT, 0);
-        if (!hConnect) { if (lastError) *lastError = "WinHttpConnect fehlgeschlagen"; log << "WinHttpConnect fehlgeschlagen\n"; WinHttpCloseHandle(hSession); return false; }
-        
-        // Query-Path basierend auf Filter erstellen
-        std::wstring queryPath = BuildQueryPath(filter);
-        log << "Query Path: " << std::string(queryPath.begin(), queryPath.end()) << "\n";
-        
-        // GET Request für REST API (Tabelle message_attachments)
-        HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"GET", queryPath.c_str(), NULL, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, WINHTTP_FLAG_SECURE);
-        if (!hRequest) { if (lastError) *lastError = "WinHttpOpenRequest fehlgeschlagen"; log << "WinHttpOpenRequest fehlgeschlagen\n"; WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false; }
-
-        // Headers für Supabase REST API (braucht apikey + JWT Token für RLS)
-        std::string accessToken = Auth::GetAccessToken();
-        if (accessToken.empty()) {
-            log << "WARNUNG: Kein JWT-Token verfügbar, verwende ANON_KEY (RLS könnte blockieren)\n";
-            accessToken = SUPABASE_ANON_KEY;
-        } else {
-            log << "JWT-Token gefunden, verwende authentifizierten Zugriff\n";
-        }
-        
-        std::wstring headers = L"apikey: ";
-        headers += std::wstring(SUPABASE_ANON_KEY, SUPABASE_ANON_KEY + strlen(SUPABASE_ANON_KEY));
-        headers += L"\r\nAuthorization: Bearer ";
-        headers += std::wstring(accessToken.begin(), accessToken.end());
-        headers += L"\r\nPrefer: return=representation";
-
-        // GET-Request (kein Body)
-        BOOL bResults = WinHttpSendRequest(hRequest, headers.c_str(), (DWORD)headers.length(), WINHTTP_NO_REQUEST_DATA, 0, 0, 0);
-        if (!bResults) {
-            if (lastError) *lastError = "WinHttpSendRequest fehlgeschlagen";
-            log << "WinHttpSendRequest fehlgeschlagen\n";
-            WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false;
-        }
-        
-        bResults = WinHttpReceiveResponse(hRequest, NULL);
-        if (!bResults) {
-            if (lastError) *lastError = "WinHttpReceiveResponse fehlgeschlagen";
-            log << "WinHttpReceiveResponse fehlgeschlagen\n";
-            WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession); return false;
+        for (size_t offset = 0; offset < ids.size(); offset += IDS_PER_REQUEST) {
+            size_t end = std::min(ids.size(), offset + IDS_PER_REQUEST);
+            std::string list;
+            for (size_t i = offset; i < end; ++i) {
+                if (i > offset) list += ",";
+                // Werte in Anführungszeichen (IDs außerhalb des UUID-Formats könnten ',' enthalten)
+                list += EncodeQueryValue("\"" + ids[i] + "\"");
+            }
+
+            std::string queryPath = ATTACHMENTS_BASE_PATH;
+            queryPath += "?" + BuildSelectClause(Projection::FULL) + "&id=in.(" + list + ")" +
+                         "&order=created_at.desc,id.desc&limit=" + std::to_string(end - offset);
+
+            size_t rowCount = 0;
+            RowKey cursor;
+            if (!FetchPage(queryPath, false, outFiles, rowCount, cursor, log, lastError)) {
+                return false;
+            }
         }
-        
-        DWORD dwStatusCode = 0; DWORD dwSize = sizeof(dwStatusCode);
-        WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, NULL, &dwStatusCode, &dwSize, NULL);
-        log << "HTTP-Status: " << dwStatusCode << "\n";
-        
-        WinHttpQueryDataAvailable(hRequest, &dwSize);
-        std::string response;
-        while (dwSize > 0) {
-            std::vector<char> buffer(dwSize);
-            DWORD dwDownloaded = 0;
-            WinHttpReadData(hRequest, buffer.data(), dwSize, &dwDownloaded);
-            response.append(buffer.data(), dwDownloaded);
-            WinHttpQueryDataAvailable(hRequest, &dwSize);
+        return true;
+    }
+
+    // Neue API: Returns detailed FileInfo structs (alle Seiten)
+    bool ListFilesDetailed(std::vector<FileInfo>& outFiles, FileFilter filter, std::string* lastError) {
+        outFiles.clear();
+        return ListFilesPaged(filter, [&outFiles](std::vector<FileInfo>& page) {
+            outFiles.insert(outFiles.end(), std::make_move_iterator(page.begin()), std::make_move_iterator(page.end()));
+            return true;
+        }, LIST_PAGE_SIZE, lastError);
+    }
+
+    std::vector<std::string> SignablePaths(const std::vector<FileInfo>& files) {
+        std::vector<std::string> paths;
+        for (const auto& info : files) {
+            if (!info.storagePath.empty()) paths.push_back(info.storagePath);
+            if (!info.thumbnailPath.empty()) paths.push_back(info.thumbnailPath);
         }
-        log << "Response: " << response << "\n";
-        WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession);
-        
-        // JSON parsen und file_name extrahieren
-        try {
-            auto j = json::parse(response);
-            if (j.is_array()) {
-                if (j.empty()) {
-                    log << "Tabelle message_attachments ist leer. Versuche Storage API als Fallback...\n";
-                    
-                    // FALLBACK: Storage API direkt abfragen
-                    HINTERNET hSession2 = WinHttpOpen(L"DegixDAW-VST/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, NULL, NULL, 0);
-                    if (hSession2) {
-                        HINTERNET hConnect2 = WinHttpConnect(hSession2, SUPABASE_HOST, INTERNET_DEFAULT_HTTPS_PORT, 0);
-                        if (hConnect2) {
-                            HINTERNET hRequest2 = WinHttpOpenRequest(hConnect2, L"POST", STORAGE_LIST_PATH, NULL, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, WINHTTP_FLAG_SECURE);
-                            if (hRequest2) {
-                                std::wstring headers2 = L"Content-Type: application/json\r\napikey: ";
-                                headers2 += std::wstring(SUPABASE_ANON_KEY, SUPABASE_ANON_KEY + strlen(SUPABASE_ANON_KEY));
-                                headers2 += L"\r\nAuthorization: Bearer ";
-                                headers2 += std::wstring(SUPABASE_ANON_KEY, SUPABASE_ANON_KEY + strlen(SUPABASE_ANON_KEY));
-                                
-                                std::string body = "{\"prefix\":\"\",\"limit\":100,\"offset\":0,\"sortBy\":{\"column\":\"name\",\"order\":\"asc\"}}";
-                                if (WinHttpSendRequest(hRequest2, headers2.c_str(), (DWORD)headers2.length(), (LPVOID)body.c_str(), (DWORD)body.size(), (DWORD)body.size(), 0)) {
-                                    if (WinHttpReceiveResponse(hRequest2, NULL)) {
-                                        DWORD dwSize2 = 0;
-                                        WinHttpQueryDataAvailable(hRequest2, &dwSize2);
-                                        std::string response2;
-                                        while (dwSize2 > 0) {
-                                            std::vector<char> buffer(dwSize2);
-                                            DWORD dwDownloaded = 0;
-                                            WinHttpReadData(hRequest2, buffer.data(), dwSize2, &dwDownloaded);
-                                            response2.append(buffer.data(), dwDownloaded);
-                                            WinHttpQueryDataAvailable(hRequest2, &dwSize2);
-                                        }
-                                        log << "Storage API Response: " << response2 << "\n";
-                                        
-                                        auto j2 = json::parse(response2);
-                                        if (j2.is_array() && !j2.empty()) {
-                                            outFiles.push_back("=== Dateien im Storage (UUID-Namen) ===");
-                                            for (const auto& entry : j2) {
-                                                if (entry.contains("name")) {
-                                                    outFiles.push_back(entry["name"].get<std::string>());
-                                                }
-                                            }
-                                        } else {
-                                            outFiles.push_back("Keine Dateien im Storage gefunden.");
-                                        }
-                                    }
-                                }
-                                WinHttpCloseHandle(hRequest2);
-                            }
-                            WinHttpCloseHandle(hConnect2);
-                        }
-                        WinHttpCloseHandle(hSession2);
-                    }
-                } else {
-                    // TODO: Für RECEIVED-Filter brauchen wir die current_user_id
-                    // Für jetzt: Zeige alle Dateien an, RECEIVED-Filter später implementieren
-                    
-                    for (const auto& entry : j) {
-                        if (entry.contains("file_name")) {
-                            std::string fileName = entry["file_name"].get<std::string>();
-                            std::string fileType = entry.value("file_type", "unknown");
-                            
-                            // Optionale Informationen sammeln
-                            std::string displayName = fileName;
-                            
-                            // Dateigröße hinzufügen
-                            if (entry.contains("file_size") && !entry["file_size"].is_null()) {
-                                long long fileSize = entry["file_size"].get<long long>();
-                                double sizeMB = fileSize / (1024.0 * 1024.0);
-                                char buffer[512];
-                                snprintf(buffer, sizeof(buffer), "%s (%.2f MB)", fileName.c_str(), sizeMB);
-                                displayName = buffer;
-                            }
-                            
-                            // RECEIVED-Filter: Prüfe sender_id (falls vorhanden)
-                            if (filter == FileFilter::RECEIVED) {
-                                // TODO: Vergleiche mit current_user_id
-                                // Für jetzt: Zeige alle an
-                                log << "RECEIVED filter aktiv (noch nicht vollständig implementiert)\n";
-                            }
-                            
-                            outFiles.push_back(displayName);
-                            log << "Datei gefunden: " << fileName << " (" << fileType << ")\n";
-                        }
-                    }
-                }
-            }
-        } catch (const std::exception& ex) {
-            if (lastError) *lastError = std::string("JSON-Parsing fehlgeschlagen: ") + ex.what();
-            log << "JSON-Parsing fehlgeschlagen: " << ex.what() << "\n";
+        return paths;
+    }
+
+    void PresignFiles(const std::vector<FileInfo>& files) {
+        std::vector<std::string> paths = SignablePaths(files);
+        if (!paths.empty()) PrefetchSignedUrls(paths);
+    }
+
+    std::vector<ListingPage> ListingStream::TakePages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<ListingPage> pages;
+        pages.swap(pages_);
+        return pages;
+    }
+
+    bool ListingStream::IsDone() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return done_;
+    }
+
+    bool ListingStream::Succeeded() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return success_;
+    }
+
+    std::string ListingStream::Error() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return error_;
+    }
+
+    void ListingStream::PushPage(std::vector<FileInfo>&& files) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ListingPage page;
+        page.files = std::move(files);
+        pages_.push_back(std::move(page));
+    }
+
+    void ListingStream::PushDelta(std::vector<FileInfo>&& added, std::vector<std::string>&& removed) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ListingPage page;
+        page.files = std::move(added);
+        page.delta = true;
+        page.removed = std::move(removed);
+        pages_.push_back(std::move(page));
+    }
+
+    void ListingStream::Finish(bool success, const std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+        success_ = success;
+        error_ = error;
+    }
+
+    // Legacy API: Wrapper around ListFilesDetailed
+    bool ListFiles(std::vector<std::string>& outFiles, FileFilter filter, std::string* lastError) {
+        std::vector<FileInfo> detailedFiles;
+        if (!ListFilesDetailed(detailedFiles, filter, lastError)) {
             return false;
         }
-        
-        log << "Fertig. " << outFiles.size() << " Einträge.\n";
+
+        // Convert FileInfo to display strings
+        outFiles.clear();
+        for (const auto& info : detailedFiles) {
+            outFiles.push_back(info.GetDisplayName());
+        }
         return true;
     }
 }
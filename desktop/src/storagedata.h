@@ -1,4 +1,9 @@
 #pragma once
+#include <cstdio>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -13,6 +18,22 @@ namespace storagedata {
         VIDEO             // Nur Videos (video/*)
     };
 
+    // Spaltenauswahl für Listing-Requests
+    // (Reihenfolge: jede Stufe enthält eine Teilmenge der vorherigen)
+    enum class Projection {
+        FULL,             // Alle Felder von FileInfo
+        LIST_ONLY,        // Nur was die Listbox braucht (ohne file_url/thumbnail_url)
+        KEYS_ONLY         // Nur id + created_at (Abgleich gelöschter Einträge)
+    };
+
+    // Keyset-Schlüssel einer Zeile (Sortierung, Pagination, Watermark)
+    struct RowKey {
+        std::string createdAt;
+        std::string id;
+
+        bool IsEmpty() const { return createdAt.empty() || id.empty(); }
+    };
+
     // File Info Struktur
     struct FileInfo {
         std::string id;              // UUID
@@ -20,8 +41,9 @@ namespace storagedata {
         std::string fileType;        // MIME type (image/jpeg, audio/mp3, etc.)
         std::string storagePath;     // Storage path (für signed URL generation)
         std::string thumbnailPath;   // Optional: Thumbnail path
-        long long fileSize;          // Dateigröße in Bytes
+        long long fileSize = 0;      // Dateigröße in Bytes
         std::string createdAt;       // Timestamp
+        std::string senderId;        // Absender der Nachricht (messages.sender_id)
 
         // Helper: Formatierter Display-Name
         std::string GetDisplayName() const {
@@ -34,15 +56,130 @@ namespace storagedata {
             return fileName;
         }
 
+        // Helper: Sind Storage-Pfade geladen? (Nicht bei Projection::LIST_ONLY)
+        bool HasDetails() const {
+            return !storagePath.empty();
+        }
+
         // Helper: Ist es ein Bild?
         bool IsImage() const {
             return fileType.find("image/") == 0;
         }
     };
 
-    // Neue API: Gibt FileInfo Structs zurück
+    // Ergebnis einer Signierung (url leer => error gesetzt)
+    struct SignedUrl {
+        std::string path;            // Storage path
+        std::string url;             // Vollständige signed URL
+        std::string error;
+    };
+
+    // Zeilen pro Seite beim Listing (Keyset-Pagination auf created_at, id)
+    const size_t LIST_PAGE_SIZE = 100;
+
+    // Wird pro Seite aufgerufen (neueste zuerst); false bricht das Listing ab
+    using PageCallback = std::function<bool(std::vector<FileInfo>& page)>;
+
+    // Streamt das komplette Listing seitenweise (Keyset-Pagination, keine Obergrenze).
+    // fullFirstPage: erste Seite (der erste Bildschirm) trotzdem mit Projection::FULL.
+    bool ListFilesPaged(FileFilter filter, const PageCallback& onPage, size_t pageSize = LIST_PAGE_SIZE, std::string* lastError = nullptr,
+                        Projection projection = Projection::FULL, bool fullFirstPage = false);
+
+    // Zeilen pro Seite beim reinen Schlüssel-Abgleich
+    const size_t KEYS_PAGE_SIZE = 1000;
+
+    // Delta: alle Zeilen, die neuer als watermark sind (älteste zuerst, volle Projection)
+    bool ListFilesNewerThan(FileFilter filter, const RowKey& watermark, std::vector<FileInfo>& outFiles, std::string* lastError = nullptr);
+
+    // Nur die Schlüssel aller Zeilen (billiger Abgleich, um Löschungen zu erkennen)
+    bool ListFileKeys(FileFilter filter, std::vector<RowKey>& outKeys, std::string* lastError = nullptr);
+
+    // Lädt die vollständige Zeile zu info.id nach (für Einträge aus Projection::LIST_ONLY)
+    bool FetchFileDetails(FileInfo& info, std::string* lastError = nullptr);
+
+    // IDs pro Request bei FetchFilesByIds (id=in.(...) steht in der URL)
+    const size_t IDS_PER_REQUEST = 100;
+
+    // Vollständige Zeilen zu vielen IDs (id=in.(...), Projection::FULL, neueste zuerst
+    // je Request). Unbekannte oder inzwischen gelöschte IDs fehlen einfach im Ergebnis.
+    bool FetchFilesByIds(const std::vector<std::string>& ids, std::vector<FileInfo>& outFiles, std::string* lastError = nullptr);
+
+    // Neue API: Gibt FileInfo Structs zurück (alle Seiten)
     bool ListFilesDetailed(std::vector<FileInfo>& outFiles, FileFilter filter = FileFilter::ALL, std::string* lastError = nullptr);
 
+    // Gültigkeit angeforderter signed URLs in Sekunden
+    const int SIGNED_URL_EXPIRES_IN = 3600;
+
+    // Signiert einen Storage-Pfad (POST /storage/v1/object/sign/chat-attachments/<path>)
+    bool CreateSignedUrl(const std::string& storagePath, std::string& outUrl, int expiresIn = 3600, std::string* lastError = nullptr);
+
+    // Signiert viele Pfade in einem Round-Trip (Batch-Endpoint mit "paths"-Array).
+    // outUrls enthält pro Eingabepfad einen Eintrag (Reihenfolge wie vom Server geliefert).
+    bool CreateSignedUrls(const std::vector<std::string>& storagePaths, std::vector<SignedUrl>& outUrls, int expiresIn = 3600, std::string* lastError = nullptr);
+    // (Beide legen erfolgreiche URLs zusätzlich im SignedUrlCache ab.)
+
+    // Signed URL über den SignedUrlCache: signiert nur, wenn nicht (mehr) gültig gecacht
+    bool GetSignedUrl(const std::string& storagePath, std::string& outUrl, std::string* lastError = nullptr);
+
+    // Serverseitig verkleinerte Bildvariante (Supabase Image Transformation, resize=contain)
+    struct ImageTransform {
+        int width = 0;               // Zielbox in Pixeln
+        int height = 0;
+        int quality = 75;            // 20..100
+
+        // Eindeutiger Schlüssel der Variante, z.B. "w380h430q75" (für Caches)
+        std::string Key() const;
+    };
+
+    // Signiert die Variante: die URL zeigt auf /storage/v1/render/image/sign/...
+    // (über den SignedUrlCache, Schlüssel = Pfad + "#" + transform.Key())
+    bool GetSignedRenderUrl(const std::string& storagePath, const ImageTransform& transform, std::string& outUrl,
+                            std::string* lastError = nullptr);
+
+    // Signiert per Batch alle Pfade, die fehlen oder bald ablaufen
+    bool PrefetchSignedUrls(const std::vector<std::string>& storagePaths, std::string* lastError = nullptr);
+
+    // storagePath + thumbnailPath der Dateien (Eingabe für PrefetchSignedUrls)
+    std::vector<std::string> SignablePaths(const std::vector<FileInfo>& files);
+
+    // Signiert storagePath + thumbnailPath der Dateien per Batch (nur ungecachte;
+    // Fehler sind nicht fatal, die Vorschau signiert dann einzeln)
+    void PresignFiles(const std::vector<FileInfo>& files);
+
+    // Eine Lieferung eines ListingStreams
+    struct ListingPage {
+        std::vector<FileInfo> files;
+        bool delta = false;              // true: Änderung der bisherigen Liste (Delta-Sync):
+        std::vector<std::string> removed;  // files einmischen, diese IDs entfernen
+    };
+
+    // Handle eines laufenden, seitenweisen Listings (ListingSync::SyncAsync). Der Worker
+    // reiht Seiten ein, der UI-Thread holt sie mit TakePages() ab. Alle Methoden sind thread-safe.
+    class ListingStream {
+    public:
+        std::vector<ListingPage> TakePages();
+        bool IsDone() const;
+        bool Succeeded() const;
+        std::string Error() const;
+
+        // Worker bricht nach der aktuellen Seite ab
+        void Cancel() { cancelled_ = true; }
+        bool IsCancelled() const { return cancelled_; }
+
+        // Nur für den Worker
+        void PushPage(std::vector<FileInfo>&& files);
+        void PushDelta(std::vector<FileInfo>&& added, std::vector<std::string>&& removed);
+        void Finish(bool success, const std::string& error);
+
+    private:
+        mutable std::mutex mutex_;
+        std::vector<ListingPage> pages_;
+        bool done_ = false;
+        bool success_ = false;
+        std::string error_;
+        std::atomic<bool> cancelled_{false};
+    };
+
     // Legacy API: Gibt nur Display-Namen zurück (für Kompatibilität)
     bool ListFiles(std::vector<std::string>& outFiles, FileFilter filter = FileFilter::ALL, std::string* lastError = nullptr);
 
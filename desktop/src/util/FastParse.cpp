@@ -0,0 +1,285 @@
+#include "FastParse.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define FASTPARSE_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace FastParse {
+
+static const int64_t MICROS_PER_SECOND = 1000000;
+static const int64_t SECONDS_PER_DAY = 86400;
+
+int64_t DaysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = (unsigned)(y - era * 400);
+    unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (int64_t)era * 146097 + (int64_t)doe - 719468;
+}
+
+void CivilFromDays(int64_t z, int& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = (unsigned)(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = (int)(yoe + era * 400) + (m <= 2);
+}
+
+// ---- UUID ----
+
+static const size_t UUID_LENGTH = 36;
+
+static bool HasUuidDashes(const char* text) {
+    return text[8] == '-' && text[13] == '-' && text[18] == '-' && text[23] == '-';
+}
+
+static int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool ParseUuidScalar(const char* text, size_t length, uint64_t& hi, uint64_t& lo) {
+    if (length != UUID_LENGTH || !HasUuidDashes(text)) return false;
+    uint64_t parts[2] = { 0, 0 };
+    int nibble = 0;
+    for (size_t i = 0; i < UUID_LENGTH; ++i) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) continue;
+        int value = HexValue(text[i]);
+        if (value < 0) return false;
+        parts[nibble / 16] = (parts[nibble / 16] << 4) | (uint64_t)value;
+        ++nibble;
+    }
+    hi = parts[0];
+    lo = parts[1];
+    return true;
+}
+
+#ifdef FASTPARSE_SSE2
+
+// Hex-Zeichen -> Wert 0..15 pro Byte; validMask bekommt ein Bit pro gültigem Zeichen
+static inline __m128i HexValues(__m128i chars, int& validMask) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_subs_epu8(digit, _mm_set1_epi8(9)), zero);
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_subs_epu8(letter, _mm_set1_epi8(5)), zero);
+    validMask = _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter));
+    return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+// Zwei Nibbles pro 16-Bit-Lane zu einem Byte: Lane i = 16 * v[2i] + v[2i+1]
+static inline __m128i JoinNibbles(__m128i values) {
+    __m128i high = _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00FF)), 4);
+    return _mm_or_si128(high, _mm_srli_epi16(values, 8));
+}
+
+static inline uint64_t LoadBigEndian64(const unsigned char* bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value = (value << 8) | bytes[i];
+    return value;
+}
+
+bool ParseUuid(const char* text, size_t length, uint64_t& hi, uint64_t& lo) {
+    if (length != UUID_LENGTH || !HasUuidDashes(text)) return false;
+
+    // Bindestriche entfernen: 32 Hex-Zeichen in zwei Registern
+    char hex[32];
+    memcpy(hex, text, 8);
+    memcpy(hex + 8, text + 9, 4);
+    memcpy(hex + 12, text + 14, 4);
+    memcpy(hex + 16, text + 19, 4);
+    memcpy(hex + 20, text + 24, 12);
+
+    int validFirst, validSecond;
+    __m128i first = HexValues(_mm_loadu_si128((const __m128i*)hex), validFirst);
+    __m128i second = HexValues(_mm_loadu_si128((const __m128i*)(hex + 16)), validSecond);
+    if ((validFirst & validSecond) != 0xFFFF) return false;
+
+    unsigned char bytes[16];
+    _mm_storeu_si128((__m128i*)bytes, _mm_packus_epi16(JoinNibbles(first), JoinNibbles(second)));
+    hi = LoadBigEndian64(bytes);
+    lo = LoadBigEndian64(bytes + 8);
+    return true;
+}
+
+#else
+
+bool ParseUuid(const char* text, size_t length, uint64_t& hi, uint64_t& lo) {
+    return ParseUuidScalar(text, length, hi, lo);
+}
+
+#endif
+
+// ---- Zeitstempel ----
+
+struct DateTimeFields {
+    int year, month, day, hour, minute, second;
+};
+
+static bool ReadDigits(const char* text, size_t length, size_t pos, size_t count, int& out) {
+    if (pos + count > length) return false;
+    out = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        if (text[i] < '0' || text[i] > '9') return false;
+        out = out * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+static bool HasTimestampSeparators(const char* text) {
+    return text[4] == '-' && text[7] == '-' && (text[10] == 'T' || text[10] == ' ') && text[13] == ':' && text[16] == ':';
+}
+
+static bool IsValid(const DateTimeFields& f) {
+    return f.month >= 1 && f.month <= 12 && f.day >= 1 && f.day <= 31 && f.hour <= 23 && f.minute <= 59 && f.second <= 60;
+}
+
+static int64_t ToMicros(const DateTimeFields& f, int64_t fraction, int offsetMinutes) {
+    int64_t seconds = DaysFromCivil(f.year, (unsigned)f.month, (unsigned)f.day) * SECONDS_PER_DAY +
+                      f.hour * 3600 + f.minute * 60 + f.second;
+    seconds -= (int64_t)offsetMinutes * 60;
+    return seconds * MICROS_PER_SECOND + fraction;
+}
+
+// Nachkommastellen und Zeitzone ab Position 19, dann Umrechnung nach UTC
+static bool FinishTimestamp(const char* text, size_t length, const DateTimeFields& f, int64_t& outMicros) {
+    if (!IsValid(f)) return false;
+
+    size_t pos = 19;
+    int64_t fraction = 0;
+    if (pos < length && text[pos] == '.') {
+        ++pos;
+        size_t digits = 0;
+        while (pos < length && text[pos] >= '0' && text[pos] <= '9') {
+            if (digits < 6) fraction = fraction * 10 + (text[pos] - '0');
+            ++digits;
+            ++pos;
+        }
+        if (digits == 0) return false;
+        for (size_t i = digits; i < 6; ++i) fraction *= 10;
+    }
+
+    int offsetMinutes = 0;
+    if (pos < length) {
+        char sign = text[pos];
+        if (sign == 'Z' && pos + 1 == length) {
+            ++pos;
+        } else if (sign == '+' || sign == '-') {
+            int offsetHours, offsetMins = 0;
+            if (!ReadDigits(text, length, pos + 1, 2, offsetHours)) return false;
+            pos += 3;
+            if (pos < length && text[pos] == ':') ++pos;
+            if (pos < length) {
+                if (!ReadDigits(text, length, pos, 2, offsetMins)) return false;
+                pos += 2;
+            }
+            offsetMinutes = (offsetHours * 60 + offsetMins) * (sign == '-' ? -1 : 1);
+        }
+    }
+    if (pos != length) return false;
+
+    outMicros = ToMicros(f, fraction, offsetMinutes);
+    return true;
+}
+
+bool ParseTimestampScalar(const char* text, size_t length, int64_t& micros) {
+    DateTimeFields f;
+    if (length < 19 || !HasTimestampSeparators(text) ||
+        !ReadDigits(text, length, 0, 4, f.year) || !ReadDigits(text, length, 5, 2, f.month) ||
+        !ReadDigits(text, length, 8, 2, f.day) || !ReadDigits(text, length, 11, 2, f.hour) ||
+        !ReadDigits(text, length, 14, 2, f.minute) || !ReadDigits(text, length, 17, 2, f.second)) {
+        return false;
+    }
+    return FinishTimestamp(text, length, f, micros);
+}
+
+#ifdef FASTPARSE_SSE2
+
+// Benachbarte Ziffern ab geradem Offset zu Zahlen 0..99: Lane i = 10 * b[2i] + b[2i+1]
+static inline __m128i DigitPairs(__m128i values) {
+    __m128i tens = _mm_and_si128(values, _mm_set1_epi16(0x00FF));
+    return _mm_add_epi16(_mm_mullo_epi16(tens, _mm_set1_epi16(10)), _mm_srli_epi16(values, 8));
+}
+
+// Anzahl der gesetzten Bits von Bit 0 an (= Ziffern am Anfang)
+static inline int LowestZeroBit(int mask) {
+    unsigned zeros = ~(unsigned)mask;
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, zeros);
+    return (int)index;
+#else
+    return __builtin_ctz(zeros);
+#endif
+}
+
+static inline __m128i DigitValues(__m128i chars, int& digitMask) {
+    __m128i values = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    digitMask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(values, _mm_set1_epi8(9)), _mm_setzero_si128()));
+    return values;
+}
+
+bool ParseTimestamp(const char* text, size_t length, int64_t& micros) {
+    // "YYYY-MM-DDTHH:MM:SS" mit zwei überlappenden Ladevorgängen: ab 0 liegen
+    // Jahr, Tag und Minute auf geraden Offsets, ab 3 Monat, Stunde und Sekunde
+    if (length < 19 || !HasTimestampSeparators(text)) return false;
+
+    const int DIGITS_AT_0 = 0xDB6F;  // Offsets 0-3, 5-6, 8-9, 11-12, 14-15
+    const int DIGITS_AT_3 = 0xC000;  // Offsets 17-18 (der Rest ist schon geprüft)
+    int maskAt0, maskAt3;
+    __m128i at0 = DigitPairs(DigitValues(_mm_loadu_si128((const __m128i*)text), maskAt0));
+    __m128i at3 = DigitPairs(DigitValues(_mm_loadu_si128((const __m128i*)(text + 3)), maskAt3));
+    if ((maskAt0 & DIGITS_AT_0) != DIGITS_AT_0 || (maskAt3 & DIGITS_AT_3) != DIGITS_AT_3) return false;
+
+    DateTimeFields f;
+    f.year = _mm_extract_epi16(at0, 0) * 100 + _mm_extract_epi16(at0, 1);
+    f.day = _mm_extract_epi16(at0, 4);
+    f.minute = _mm_extract_epi16(at0, 7);
+    f.month = _mm_extract_epi16(at3, 1);
+    f.hour = _mm_extract_epi16(at3, 4);
+    f.second = _mm_extract_epi16(at3, 7);
+
+    // Üblicher Rest ".f{1,6}" + "+00:00"/"Z"/nichts ohne Schleife; alles andere skalar
+    size_t tailLength = length - 19;
+    if (tailLength < 2 || tailLength > 16 || text[19] != '.') return FinishTimestamp(text, length, f, micros);
+
+    char tail[16] = { 0 };
+    memcpy(tail, text + 20, tailLength - 1);
+    int tailMask;
+    __m128i tailValues = DigitValues(_mm_loadu_si128((const __m128i*)tail), tailMask);
+    int digits = LowestZeroBit(tailMask);
+    const char* zone = text + 20 + digits;
+    size_t zoneLength = tailLength - 1 - digits;
+    bool utc = zoneLength == 0 || (zoneLength == 1 && zone[0] == 'Z') || (zoneLength == 6 && memcmp(zone, "+00:00", 6) == 0);
+    if (digits == 0 || digits > 6 || !utc) return FinishTimestamp(text, length, f, micros);
+    if (!IsValid(f)) return false;
+
+    // Stellen hinter der letzten Ziffer auf 0: fehlende Stellen zählen als Nullen
+    __m128i keep = _mm_cmplt_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm_set1_epi8((char)digits));
+    __m128i fraction = DigitPairs(_mm_and_si128(tailValues, keep));
+    micros = ToMicros(f, (int64_t)_mm_extract_epi16(fraction, 0) * 10000 + _mm_extract_epi16(fraction, 1) * 100 +
+                             _mm_extract_epi16(fraction, 2), 0);
+    return true;
+}
+
+#else
+
+bool ParseTimestamp(const char* text, size_t length, int64_t& micros) {
+    return ParseTimestampScalar(text, length, micros);
+}
+
+#endif
+
+}
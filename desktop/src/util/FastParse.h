@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Parser für die festen Textformate der Listing-Zeilen (id, created_at).
+// Mit SSE2 (x64 immer vorhanden) werden Ziffern/Hex-Zeichen 16 Byte auf einmal
+// geprüft und umgerechnet; die *Scalar-Varianten sind der Fallback und die
+// Referenz. Beide liefern für jede Eingabe dasselbe Ergebnis.
+namespace FastParse {
+    // "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" (Groß/Klein egal) -> 128 Bit, big-endian wie PostgreSQL
+    bool ParseUuid(const char* text, size_t length, uint64_t& hi, uint64_t& lo);
+    bool ParseUuidScalar(const char* text, size_t length, uint64_t& hi, uint64_t& lo);
+
+    // YYYY-MM-DD[T ]HH:MM:SS[.f{1,9}][Z|±HH[:MM]] -> Mikrosekunden seit 1970 (UTC).
+    // Mehr als 6 Nachkommastellen werden abgeschnitten.
+    bool ParseTimestamp(const char* text, size_t length, int64_t& micros);
+    bool ParseTimestampScalar(const char* text, size_t length, int64_t& micros);
+
+    // Tage seit 1970-01-01 (proleptisch gregorianisch) und zurück
+    int64_t DaysFromCivil(int year, unsigned month, unsigned day);
+    void CivilFromDays(int64_t days, int& year, unsigned& month, unsigned& day);
+
+    // Tag (UTC) eines Zeitpunkts, auch vor 1970 korrekt abgerundet
+    inline int64_t DayOf(int64_t micros) {
+        const int64_t MICROS_PER_DAY = 86400LL * 1000000;
+        return micros >= 0 ? micros / MICROS_PER_DAY : -((-micros - 1) / MICROS_PER_DAY) - 1;
+    }
+}
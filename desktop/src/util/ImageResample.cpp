@@ -0,0 +1,365 @@
+#include "ImageResample.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define IMAGERESAMPLE_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(IMAGERESAMPLE_SSE2) && defined(__AVX2__)
+#define IMAGERESAMPLE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace ImageResample {
+
+static const int WEIGHT_BITS = 14;
+static const int WEIGHT_ONE = 1 << WEIGHT_BITS;
+static const double PI = 3.14159265358979323846;
+
+static double Sinc(double x) {
+    if (x == 0.0) return 1.0;
+    x *= PI;
+    return std::sin(x) / x;
+}
+
+// Filterkern und sein Träger (halbe Breite in Quellpixeln bei Maßstab 1)
+static double FilterSupport(Filter filter) {
+    switch (filter) {
+    case Filter::Box:        return 0.5;
+    case Filter::Bilinear:   return 1.0;
+    case Filter::CatmullRom: return 2.0;
+    case Filter::Lanczos3:   return 3.0;
+    }
+    return 2.0;
+}
+
+static double FilterWeight(Filter filter, double x) {
+    x = std::fabs(x);
+    switch (filter) {
+    case Filter::Box:
+        return x < 0.5 ? 1.0 : 0.0;
+    case Filter::Bilinear:
+        return x < 1.0 ? 1.0 - x : 0.0;
+    case Filter::CatmullRom:
+        if (x < 1.0) return (1.5 * x - 2.5) * x * x + 1.0;
+        if (x < 2.0) return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+        return 0.0;
+    case Filter::Lanczos3:
+        return x < 3.0 ? Sinc(x) * Sinc(x / 3.0) : 0.0;
+    }
+    return 0.0;
+}
+
+// Pro Zielpixel: erstes Quellpixel, Anzahl und Gewichte (Summe = WEIGHT_ONE)
+struct Contributions {
+    int taps = 0;                 // Maximale Anzahl; weights hat taps Einträge pro Zielpixel
+    std::vector<int> start;
+    std::vector<int> count;
+    std::vector<int16_t> weights;
+};
+
+static Contributions ComputeContributions(int srcSize, int dstSize, Filter filter) {
+    double scale = (double)srcSize / dstSize;
+    double filterScale = std::max(scale, 1.0);
+    double support = FilterSupport(filter) * filterScale;
+
+    Contributions result;
+    result.taps = (int)std::ceil(support) * 2 + 1;
+    result.start.resize(dstSize);
+    result.count.resize(dstSize);
+    result.weights.assign((size_t)dstSize * result.taps, 0);
+
+    std::vector<double> raw(result.taps);
+    for (int i = 0; i < dstSize; ++i) {
+        double center = (i + 0.5) * scale;
+        int first = std::max(0, (int)std::floor(center - support));
+        int last = std::min(srcSize, (int)std::ceil(center + support));
+        int count = std::min(last - first, result.taps);
+
+        double total = 0.0;
+        for (int k = 0; k < count; ++k) {
+            raw[k] = FilterWeight(filter, (first + k + 0.5 - center) / filterScale);
+            total += raw[k];
+        }
+        int16_t* weights = &result.weights[(size_t)i * result.taps];
+        if (total == 0.0) {
+            // Kein Quellpixel im Träger (nur am Rand denkbar): nächstes nehmen
+            first = std::min(std::max(0, (int)center), srcSize - 1);
+            count = 1;
+            weights[0] = (int16_t)WEIGHT_ONE;
+        } else {
+            // In Festkomma runden; Rundungsrest auf das größte Gewicht, damit
+            // flache Flächen exakt ihren Wert behalten
+            int sum = 0;
+            int largest = 0;
+            for (int k = 0; k < count; ++k) {
+                weights[k] = (int16_t)std::lround(raw[k] / total * WEIGHT_ONE);
+                sum += weights[k];
+                if (weights[k] > weights[largest]) largest = k;
+            }
+            weights[largest] = (int16_t)(weights[largest] + WEIGHT_ONE - sum);
+        }
+        result.start[i] = first;
+        result.count[i] = count;
+    }
+    return result;
+}
+
+// Horizontal: eine Quellzeile -> dstWidth Pixel
+typedef void (*RowKernel)(const uint8_t* src, uint8_t* dst, int dstWidth, const Contributions& cx);
+// Vertikal: count Zeilen ab tmp (Abstand tmpStride) -> eine Zielzeile
+typedef void (*ColumnKernel)(const uint8_t* tmp, size_t tmpStride, uint8_t* dst, int width, int count, const int16_t* weights);
+
+static inline uint8_t ClampChannel(int32_t value) {
+    value = (value + (WEIGHT_ONE >> 1)) >> WEIGHT_BITS;
+    return (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// Negative Filteranteile dürfen die Farbe nicht über Alpha heben (vormultipliziert)
+static inline void StorePixel(uint8_t* out, int32_t c0, int32_t c1, int32_t c2, int32_t a) {
+    uint8_t alpha = ClampChannel(a);
+    out[0] = std::min(ClampChannel(c0), alpha);
+    out[1] = std::min(ClampChannel(c1), alpha);
+    out[2] = std::min(ClampChannel(c2), alpha);
+    out[3] = alpha;
+}
+
+static void ResampleRowScalar(const uint8_t* src, uint8_t* dst, int dstWidth, const Contributions& cx) {
+    for (int x = 0; x < dstWidth; ++x) {
+        const uint8_t* in = src + (size_t)cx.start[x] * 4;
+        const int16_t* weights = &cx.weights[(size_t)x * cx.taps];
+        int32_t c0 = 0, c1 = 0, c2 = 0, a = 0;
+        for (int k = 0; k < cx.count[x]; ++k, in += 4) {
+            c0 += in[0] * weights[k];
+            c1 += in[1] * weights[k];
+            c2 += in[2] * weights[k];
+            a += in[3] * weights[k];
+        }
+        StorePixel(dst + (size_t)x * 4, c0, c1, c2, a);
+    }
+}
+
+static void ResampleColumnScalar(const uint8_t* tmp, size_t tmpStride, uint8_t* dst, int width, int count, const int16_t* weights) {
+    for (int x = 0; x < width; ++x) {
+        const uint8_t* in = tmp + (size_t)x * 4;
+        int32_t c0 = 0, c1 = 0, c2 = 0, a = 0;
+        for (int k = 0; k < count; ++k, in += tmpStride) {
+            c0 += in[0] * weights[k];
+            c1 += in[1] * weights[k];
+            c2 += in[2] * weights[k];
+            a += in[3] * weights[k];
+        }
+        StorePixel(dst + (size_t)x * 4, c0, c1, c2, a);
+    }
+}
+
+#ifdef IMAGERESAMPLE_SSE2
+// Zwei Gewichte als Paar für _mm_madd_epi16 (w0 im unteren, w1 im oberen Wort)
+static inline int WeightPair(int16_t w0, int16_t w1) {
+    return (int)(uint16_t)w0 | (int)((uint32_t)(uint16_t)w1 << 16);
+}
+
+// Jedes Farbbyte auf das Alpha-Byte seines Pixels begrenzen
+static inline __m128i ClampToAlpha(__m128i pixels) {
+    __m128i alpha = _mm_srli_epi32(pixels, 24);
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+    return _mm_min_epu8(pixels, alpha);
+}
+
+// Summen (mit Rundung) -> Bytes; Sättigung entspricht ClampChannel
+static inline __m128i PackSums(__m128i s0, __m128i s1, __m128i s2, __m128i s3) {
+    __m128i lo = _mm_packs_epi32(_mm_srai_epi32(s0, WEIGHT_BITS), _mm_srai_epi32(s1, WEIGHT_BITS));
+    __m128i hi = _mm_packs_epi32(_mm_srai_epi32(s2, WEIGHT_BITS), _mm_srai_epi32(s3, WEIGHT_BITS));
+    return ClampToAlpha(_mm_packus_epi16(lo, hi));
+}
+
+// Zwei benachbarte Quellpixel pro Schritt: Kanäle paarweise verschränkt
+// (c0 c0' c1 c1' ...) und mit (w, w') multipliziert-addiert
+static void ResampleRowSse2(const uint8_t* src, uint8_t* dst, int dstWidth, const Contributions& cx) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi32(WEIGHT_ONE >> 1);
+    for (int x = 0; x < dstWidth; ++x) {
+        const uint8_t* in = src + (size_t)cx.start[x] * 4;
+        const int16_t* weights = &cx.weights[(size_t)x * cx.taps];
+        int count = cx.count[x];
+        __m128i sum = half;
+        int k = 0;
+        for (; k + 1 < count; k += 2) {
+            __m128i pixels = _mm_loadl_epi64((const __m128i*)(in + k * 4));
+            pixels = _mm_unpacklo_epi8(pixels, _mm_srli_si128(pixels, 4));
+            pixels = _mm_unpacklo_epi8(pixels, zero);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(pixels, _mm_set1_epi32(WeightPair(weights[k], weights[k + 1]))));
+        }
+        if (k < count) {
+            int32_t value;
+            memcpy(&value, in + k * 4, 4);
+            __m128i pixel = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(pixel, _mm_set1_epi32(WeightPair(weights[k], 0))));
+        }
+        __m128i packed = _mm_packs_epi32(_mm_srai_epi32(sum, WEIGHT_BITS), zero);
+        int32_t result = _mm_cvtsi128_si32(ClampToAlpha(_mm_packus_epi16(packed, zero)));
+        memcpy(dst + (size_t)x * 4, &result, 4);
+    }
+}
+
+// 16 Byte (4 Pixel) einer Zeile, je zwei Quellzeilen byteweise verschränkt
+static void ResampleColumnSse2(const uint8_t* tmp, size_t tmpStride, uint8_t* dst, int width, int count, const int16_t* weights) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi32(WEIGHT_ONE >> 1);
+    size_t bytes = (size_t)width * 4;
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i s0 = half, s1 = half, s2 = half, s3 = half;
+        const uint8_t* in = tmp + i;
+        int k = 0;
+        for (; k < count; k += 2, in += 2 * tmpStride) {
+            __m128i a = _mm_loadu_si128((const __m128i*)in);
+            __m128i b = zero;
+            int pair = WeightPair(weights[k], 0);
+            if (k + 1 < count) {
+                b = _mm_loadu_si128((const __m128i*)(in + tmpStride));
+                pair = WeightPair(weights[k], weights[k + 1]);
+            }
+            __m128i w = _mm_set1_epi32(pair);
+            __m128i lo = _mm_unpacklo_epi8(a, b);
+            __m128i hi = _mm_unpackhi_epi8(a, b);
+            s0 = _mm_add_epi32(s0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), w));
+            s1 = _mm_add_epi32(s1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), w));
+            s2 = _mm_add_epi32(s2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), w));
+            s3 = _mm_add_epi32(s3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), w));
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), PackSums(s0, s1, s2, s3));
+    }
+    if (i < bytes) ResampleColumnScalar(tmp + i, tmpStride, dst + i, (int)((bytes - i) / 4), count, weights);
+}
+#endif
+
+#ifdef IMAGERESAMPLE_AVX2
+// Wie ResampleColumnSse2 mit 32 Byte; unpack/pack arbeiten je 128-Bit-Hälfte,
+// die Reihenfolge der Bytes bleibt dadurch erhalten
+static void ResampleColumnAvx2(const uint8_t* tmp, size_t tmpStride, uint8_t* dst, int width, int count, const int16_t* weights) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i half = _mm256_set1_epi32(WEIGHT_ONE >> 1);
+    size_t bytes = (size_t)width * 4;
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i s0 = half, s1 = half, s2 = half, s3 = half;
+        const uint8_t* in = tmp + i;
+        int k = 0;
+        for (; k < count; k += 2, in += 2 * tmpStride) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)in);
+            __m256i b = zero;
+            int pair = WeightPair(weights[k], 0);
+            if (k + 1 < count) {
+                b = _mm256_loadu_si256((const __m256i*)(in + tmpStride));
+                pair = WeightPair(weights[k], weights[k + 1]);
+            }
+            __m256i w = _mm256_set1_epi32(pair);
+            __m256i lo = _mm256_unpacklo_epi8(a, b);
+            __m256i hi = _mm256_unpackhi_epi8(a, b);
+            s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), w));
+            s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), w));
+            s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), w));
+            s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), w));
+        }
+        __m256i lo = _mm256_packs_epi32(_mm256_srai_epi32(s0, WEIGHT_BITS), _mm256_srai_epi32(s1, WEIGHT_BITS));
+        __m256i hi = _mm256_packs_epi32(_mm256_srai_epi32(s2, WEIGHT_BITS), _mm256_srai_epi32(s3, WEIGHT_BITS));
+        __m256i pixels = _mm256_packus_epi16(lo, hi);
+        __m256i alpha = _mm256_srli_epi32(pixels, 24);
+        alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 8));
+        alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_min_epu8(pixels, alpha));
+    }
+    if (i < bytes) ResampleColumnSse2(tmp + i, tmpStride, dst + i, (int)((bytes - i) / 4), count, weights);
+}
+#endif
+
+static bool ResizeWith(RowKernel resampleRow, ColumnKernel resampleColumn,
+                       const uint8_t* src, int srcWidth, int srcHeight, ptrdiff_t srcStride,
+                       uint8_t* dst, int dstWidth, int dstHeight, ptrdiff_t dstStride, Filter filter) {
+    if (!src || !dst || srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0) return false;
+
+    if (srcWidth == dstWidth && srcHeight == dstHeight) {
+        for (int y = 0; y < dstHeight; ++y) memcpy(dst + y * dstStride, src + y * srcStride, (size_t)dstWidth * 4);
+        return true;
+    }
+
+    // Erst horizontal in ein Zwischenbild (dstWidth x srcHeight), dann vertikal.
+    // Nur die Zeilen, die die vertikale Stufe tatsächlich liest.
+    Contributions cx = ComputeContributions(srcWidth, dstWidth, filter);
+    Contributions cy = ComputeContributions(srcHeight, dstHeight, filter);
+    int firstRow = cy.start.front();
+    int lastRow = cy.start.back() + cy.count.back();
+
+    size_t tmpStride = (size_t)dstWidth * 4;
+    std::vector<uint8_t> tmp(tmpStride * (size_t)(lastRow - firstRow));
+    for (int y = firstRow; y < lastRow; ++y) {
+        resampleRow(src + y * srcStride, &tmp[(size_t)(y - firstRow) * tmpStride], dstWidth, cx);
+    }
+    for (int y = 0; y < dstHeight; ++y) {
+        resampleColumn(&tmp[(size_t)(cy.start[y] - firstRow) * tmpStride], tmpStride, dst + y * dstStride, dstWidth,
+                       cy.count[y], &cy.weights[(size_t)y * cy.taps]);
+    }
+    return true;
+}
+
+void FitSize(int srcWidth, int srcHeight, int boxWidth, int boxHeight, int& outWidth, int& outHeight) {
+    if (srcWidth <= 0 || srcHeight <= 0 || boxWidth <= 0 || boxHeight <= 0) {
+        outWidth = outHeight = 1;
+        return;
+    }
+    double scale = std::min((double)boxWidth / srcWidth, (double)boxHeight / srcHeight);
+    outWidth = std::max(1, std::min(boxWidth, (int)(srcWidth * scale + 0.5)));
+    outHeight = std::max(1, std::min(boxHeight, (int)(srcHeight * scale + 0.5)));
+}
+
+int ScaleDenominator(int srcWidth, int srcHeight, int boxWidth, int boxHeight) {
+    int fitWidth, fitHeight;
+    FitSize(srcWidth, srcHeight, boxWidth, boxHeight, fitWidth, fitHeight);
+    for (int d = 8; d > 1; d /= 2) {
+        if (srcWidth / d >= fitWidth && srcHeight / d >= fitHeight) return d;
+    }
+    return 1;
+}
+
+bool Resize(const uint8_t* src, int srcWidth, int srcHeight, ptrdiff_t srcStride,
+            uint8_t* dst, int dstWidth, int dstHeight, ptrdiff_t dstStride, Filter filter) {
+#if defined(IMAGERESAMPLE_AVX2)
+    return ResizeWith(ResampleRowSse2, ResampleColumnAvx2, src, srcWidth, srcHeight, srcStride,
+                      dst, dstWidth, dstHeight, dstStride, filter);
+#elif defined(IMAGERESAMPLE_SSE2)
+    return ResizeWith(ResampleRowSse2, ResampleColumnSse2, src, srcWidth, srcHeight, srcStride,
+                      dst, dstWidth, dstHeight, dstStride, filter);
+#else
+    return ResizeScalar(src, srcWidth, srcHeight, srcStride, dst, dstWidth, dstHeight, dstStride, filter);
+#endif
+}
+
+bool ResizeScalar(const uint8_t* src, int srcWidth, int srcHeight, ptrdiff_t srcStride,
+                  uint8_t* dst, int dstWidth, int dstHeight, ptrdiff_t dstStride, Filter filter) {
+    return ResizeWith(ResampleRowScalar, ResampleColumnScalar, src, srcWidth, srcHeight, srcStride,
+                      dst, dstWidth, dstHeight, dstStride, filter);
+}
+
+void CompositeOver(uint8_t* pixels, int width, int height, ptrdiff_t stride,
+                   uint8_t red, uint8_t green, uint8_t blue) {
+    for (int y = 0; y < height; ++y) {
+        uint8_t* p = pixels + y * stride;
+        for (int x = 0; x < width; ++x, p += 4) {
+            unsigned inverse = 255u - p[3];
+            if (inverse == 0) continue;
+            // c + bg * (255 - a) / 255, gerundet
+            unsigned tb = blue * inverse + 128, tg = green * inverse + 128, tr = red * inverse + 128;
+            p[0] = (uint8_t)(p[0] + ((tb + (tb >> 8)) >> 8));
+            p[1] = (uint8_t)(p[1] + ((tg + (tg >> 8)) >> 8));
+            p[2] = (uint8_t)(p[2] + ((tr + (tr >> 8)) >> 8));
+            p[3] = 255;
+        }
+    }
+}
+
+}
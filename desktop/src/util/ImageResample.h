@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Skalieren von 32-Bit-Bildern (4 Byte pro Pixel, Alpha im 4. Byte: GDI+
+// PARGB/DIB als B, G, R, A oder RGBA). Farbe muss mit Alpha vormultipliziert
+// sein (deckende Bilder sind es immer). Separierbare Filter mit Festkomma-
+// Gewichten; beim Verkleinern wird der Filter über die Quellpixel gestreckt
+// (Flächenmittel, kein Aliasing). Mit SSE2 (x64 immer vorhanden) bzw. AVX2
+// (/arch:AVX2) laufen die Kernel vektorisiert; ResizeScalar ist Fallback und
+// Referenz, beide liefern bitgleiche Ergebnisse. Portabel, ohne Win32.
+namespace ImageResample {
+    enum class Filter {
+        Box,         // Flächenmittel; beim Vergrößern nächster Nachbar
+        Bilinear,
+        CatmullRom,  // Bikubisch, scharf ohne starkes Überschwingen
+        Lanczos3,    // Schärfste Verkleinerung, teuerster Filter
+    };
+
+    // Größte Größe mit gleichem Seitenverhältnis, die in die Box passt (mind. 1x1)
+    void FitSize(int srcWidth, int srcHeight, int boxWidth, int boxHeight, int& outWidth, int& outHeight);
+
+    // Kleinster Maßstab 1/d (d = 8, 4, 2, 1), der die Box noch ohne Vergrößern
+    // füllt; für JPEG-Decoder, die im DCT-Bereich verkleinern (ScaledJpeg)
+    int ScaleDenominator(int srcWidth, int srcHeight, int boxWidth, int boxHeight);
+
+    // Stride in Bytes, negativ für Bottom-up-Bilder. Quelle und Ziel dürfen
+    // sich nicht überlappen. false bei ungültiger Größe.
+    bool Resize(const uint8_t* src, int srcWidth, int srcHeight, ptrdiff_t srcStride,
+                uint8_t* dst, int dstWidth, int dstHeight, ptrdiff_t dstStride,
+                Filter filter = Filter::CatmullRom);
+    bool ResizeScalar(const uint8_t* src, int srcWidth, int srcHeight, ptrdiff_t srcStride,
+                      uint8_t* dst, int dstWidth, int dstHeight, ptrdiff_t dstStride,
+                      Filter filter = Filter::CatmullRom);
+
+    // Legt ein vormultipliziertes Bild auf einen einfarbigen Hintergrund (danach deckend)
+    void CompositeOver(uint8_t* pixels, int width, int height, ptrdiff_t stride,
+                       uint8_t red, uint8_t green, uint8_t blue);
+}
@@ -0,0 +1,311 @@
+#include "JsonPushParser.h"
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static bool IsNumberChar(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+static bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Grammatik aus RFC 8259: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+// (strtod allein nähme auch "01", "1." oder "-" bzw. nur einen Präfix davon)
+static bool IsValidNumber(const std::string& text) {
+    size_t i = 0, n = text.size();
+    if (i < n && text[i] == '-') ++i;
+    if (i == n) return false;
+    if (text[i] == '0') {
+        ++i;
+    } else if (IsDigit(text[i])) {
+        while (i < n && IsDigit(text[i])) ++i;
+    } else {
+        return false;
+    }
+    if (i < n && text[i] == '.') {
+        ++i;
+        if (i == n || !IsDigit(text[i])) return false;
+        while (i < n && IsDigit(text[i])) ++i;
+    }
+    if (i < n && (text[i] == 'e' || text[i] == 'E')) {
+        ++i;
+        if (i < n && (text[i] == '+' || text[i] == '-')) ++i;
+        if (i == n || !IsDigit(text[i])) return false;
+        while (i < n && IsDigit(text[i])) ++i;
+    }
+    return i == n;
+}
+
+static bool IsWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+JsonPushParser::JsonPushParser(Handler& handler) : handler_(handler) {}
+
+bool JsonPushParser::Fail(const char* message) {
+    failed_ = true;
+    error_ = std::string(message) + " (Byte " + std::to_string(offset_) + ")";
+    return false;
+}
+
+bool JsonPushParser::Feed(const char* data, size_t size) {
+    if (failed_) return false;
+
+    for (size_t i = 0; i < size; ++i, ++offset_) {
+        char c = data[i];
+        switch (token_) {
+            case Token::STRING:
+                if (!StringChar(c)) { failed_ = true; return false; }
+                continue;
+            case Token::NUMBER:
+                if (IsNumberChar(c)) {
+                    buffer_ += c;
+                    continue;
+                }
+                // Zahl endet am ersten fremden Zeichen, das dann normal verarbeitet wird
+                if (!EmitNumber()) { failed_ = true; return false; }
+                break;
+            case Token::LITERAL:
+                if (!LiteralChar(c)) { failed_ = true; return false; }
+                continue;
+            case Token::NONE:
+                break;
+        }
+
+        if (IsWhitespace(c)) continue;
+        if (!Structural(c)) { failed_ = true; return false; }
+    }
+    return true;
+}
+
+bool JsonPushParser::Finish() {
+    if (failed_) return false;
+    if (token_ == Token::NUMBER && !EmitNumber()) { failed_ = true; return false; }
+    if (token_ != Token::NONE || expect_ != Expect::DONE) {
+        return Fail("Unerwartetes Ende der JSON-Eingabe");
+    }
+    return true;
+}
+
+bool JsonPushParser::Structural(char c) {
+    switch (expect_) {
+        case Expect::DONE:
+            return Fail("Zusätzliche Zeichen nach dem JSON-Wert");
+
+        case Expect::COLON:
+            if (c != ':') return Fail("':' erwartet");
+            expect_ = Expect::VALUE;
+            return true;
+
+        case Expect::COMMA_OR_END:
+            if (c == ',') {
+                expect_ = stack_.back() == '{' ? Expect::KEY : Expect::VALUE;
+                return true;
+            }
+            if ((c == '}' && stack_.back() == '{') || (c == ']' && stack_.back() == '[')) {
+                stack_.pop_back();
+                if (!(c == '}' ? handler_.EndObject() : handler_.EndArray())) return false;
+                return AfterValue();
+            }
+            return Fail("',' oder Containerende erwartet");
+
+        case Expect::KEY_OR_END:
+            if (c == '}') {
+                stack_.pop_back();
+                if (!handler_.EndObject()) return false;
+                return AfterValue();
+            }
+            // fallthrough
+        case Expect::KEY:
+            if (c != '"') return Fail("Schlüssel erwartet");
+            token_ = Token::STRING;
+            stringIsKey_ = true;
+            buffer_.clear();
+            return true;
+
+        case Expect::VALUE_OR_END:
+            if (c == ']') {
+                stack_.pop_back();
+                if (!handler_.EndArray()) return false;
+                return AfterValue();
+            }
+            // fallthrough
+        case Expect::VALUE:
+            break;
+    }
+
+    // Anfang eines Werts
+    buffer_.clear();
+    if (c == '{') {
+        stack_.push_back('{');
+        expect_ = Expect::KEY_OR_END;
+        return handler_.StartObject();
+    }
+    if (c == '[') {
+        stack_.push_back('[');
+        expect_ = Expect::VALUE_OR_END;
+        return handler_.StartArray();
+    }
+    if (c == '"') {
+        token_ = Token::STRING;
+        stringIsKey_ = false;
+        return true;
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        token_ = Token::NUMBER;
+        buffer_ += c;
+        return true;
+    }
+    if (c == 't' || c == 'f' || c == 'n') {
+        token_ = Token::LITERAL;
+        buffer_ += c;
+        return true;
+    }
+    return Fail("Wert erwartet");
+}
+
+bool JsonPushParser::AfterValue() {
+    expect_ = stack_.empty() ? Expect::DONE : Expect::COMMA_OR_END;
+    return true;
+}
+
+void JsonPushParser::AppendCodePoint(uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        buffer_ += (char)codePoint;
+    } else if (codePoint < 0x800) {
+        buffer_ += (char)(0xC0 | (codePoint >> 6));
+        buffer_ += (char)(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        buffer_ += (char)(0xE0 | (codePoint >> 12));
+        buffer_ += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        buffer_ += (char)(0x80 | (codePoint & 0x3F));
+    } else {
+        buffer_ += (char)(0xF0 | (codePoint >> 18));
+        buffer_ += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        buffer_ += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        buffer_ += (char)(0x80 | (codePoint & 0x3F));
+    }
+}
+
+bool JsonPushParser::StringChar(char c) {
+    if (unicodeDigits_ > 0) {
+        uint32_t digit;
+        if (c >= '0' && c <= '9') digit = (uint32_t)(c - '0');
+        else if (c >= 'a' && c <= 'f') digit = (uint32_t)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') digit = (uint32_t)(c - 'A' + 10);
+        else return Fail("Ungültige \\u-Escape-Sequenz");
+        unicodeValue_ = (unicodeValue_ << 4) | digit;
+        if (--unicodeDigits_ > 0) return true;
+
+        // Surrogatpaare zu einem Codepoint zusammenfügen
+        if (unicodeValue_ >= 0xD800 && unicodeValue_ <= 0xDBFF) {
+            if (highSurrogate_) AppendCodePoint(0xFFFD);
+            highSurrogate_ = unicodeValue_;
+            return true;
+        }
+        if (unicodeValue_ >= 0xDC00 && unicodeValue_ <= 0xDFFF) {
+            if (!highSurrogate_) {
+                AppendCodePoint(0xFFFD);
+                return true;
+            }
+            AppendCodePoint(0x10000 + ((highSurrogate_ - 0xD800) << 10) + (unicodeValue_ - 0xDC00));
+            highSurrogate_ = 0;
+            return true;
+        }
+        if (highSurrogate_) {
+            AppendCodePoint(0xFFFD);
+            highSurrogate_ = 0;
+        }
+        AppendCodePoint(unicodeValue_);
+        return true;
+    }
+
+    if (escape_) {
+        escape_ = false;
+        if (c == 'u') {
+            unicodeDigits_ = 4;
+            unicodeValue_ = 0;
+            return true;
+        }
+        if (highSurrogate_) {
+            AppendCodePoint(0xFFFD);
+            highSurrogate_ = 0;
+        }
+        switch (c) {
+            case '"':  buffer_ += '"'; break;
+            case '\\': buffer_ += '\\'; break;
+            case '/':  buffer_ += '/'; break;
+            case 'b':  buffer_ += '\b'; break;
+            case 'f':  buffer_ += '\f'; break;
+            case 'n':  buffer_ += '\n'; break;
+            case 'r':  buffer_ += '\r'; break;
+            case 't':  buffer_ += '\t'; break;
+            default:   return Fail("Ungültige Escape-Sequenz");
+        }
+        return true;
+    }
+
+    if (c == '\\') {
+        escape_ = true;
+        return true;
+    }
+    if (highSurrogate_) {
+        AppendCodePoint(0xFFFD);
+        highSurrogate_ = 0;
+    }
+    if (c == '"') {
+        token_ = Token::NONE;
+        if (stringIsKey_) {
+            expect_ = Expect::COLON;
+            return handler_.Key(buffer_);
+        }
+        if (!handler_.String(buffer_)) return false;
+        return AfterValue();
+    }
+    if ((unsigned char)c < 0x20) return Fail("Steuerzeichen in Zeichenkette");
+    buffer_ += c;
+    return true;
+}
+
+bool JsonPushParser::EmitNumber() {
+    token_ = Token::NONE;
+    if (!IsValidNumber(buffer_)) return Fail("Ungültige Zahl");
+    const char* text = buffer_.c_str();
+    char* end = nullptr;
+    bool isFloat = buffer_.find_first_of(".eE") != std::string::npos;
+
+    if (!isFloat) {
+        errno = 0;
+        long long value = std::strtoll(text, &end, 10);
+        if (end == text + buffer_.size() && errno == 0) {
+            if (!handler_.Integer(value)) return false;
+            return AfterValue();
+        }
+        // Überlauf: als Gleitkommazahl weitergeben
+    }
+    double value = std::strtod(text, &end);
+    if (end != text + buffer_.size()) return Fail("Ungültige Zahl");
+    // Wie nlohmann::json: Überlauf auf inf ist ein Fehler
+    if (!std::isfinite(value)) return Fail("Zahl außerhalb des Wertebereichs");
+    if (!handler_.Float(value)) return false;
+    return AfterValue();
+}
+
+bool JsonPushParser::LiteralChar(char c) {
+    static const char* LITERALS[] = { "true", "false", "null" };
+    buffer_ += c;
+    for (const char* literal : LITERALS) {
+        size_t length = std::strlen(literal);
+        if (buffer_.size() > length || buffer_.compare(0, buffer_.size(), literal, buffer_.size()) != 0) continue;
+        if (buffer_.size() < length) return true;
+
+        token_ = Token::NONE;
+        bool ok = literal[0] == 'n' ? handler_.Null() : handler_.Bool(literal[0] == 't');
+        if (!ok) return false;
+        return AfterValue();
+    }
+    return Fail("Ungültiges Literal");
+}
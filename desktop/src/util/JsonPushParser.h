@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Inkrementeller JSON-Parser im Push-Betrieb: Feed() nimmt beliebig geschnittene
+// Teile der Eingabe (z.B. direkt vom Socket) und meldet SAX-Events an den Handler.
+// Es wird kein DOM aufgebaut; gepuffert wird nur das gerade offene Token.
+// (nlohmann::json::sax_parse zieht die Eingabe selbst und braucht sie daher komplett.)
+class JsonPushParser {
+public:
+    // Rückgabe false bricht das Parsen ab (Feed liefert dann false, Error() bleibt leer)
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+        virtual bool StartObject() { return true; }
+        virtual bool EndObject() { return true; }
+        virtual bool StartArray() { return true; }
+        virtual bool EndArray() { return true; }
+        virtual bool Key(std::string& key) = 0;
+        virtual bool String(std::string& value) = 0;
+        virtual bool Integer(long long value) = 0;
+        virtual bool Float(double value) = 0;
+        virtual bool Bool(bool value) { (void)value; return true; }
+        virtual bool Null() { return true; }
+    };
+
+    explicit JsonPushParser(Handler& handler);
+
+    // Verarbeitet den nächsten Teil der Eingabe; false bei Syntaxfehler oder Abbruch
+    bool Feed(const char* data, size_t size);
+
+    // Eingabe zu Ende: prüft, dass genau ein vollständiger Wert gelesen wurde
+    bool Finish();
+
+    // Beschreibung des Syntaxfehlers (leer, wenn der Handler abgebrochen hat)
+    const std::string& Error() const { return error_; }
+    size_t BytesConsumed() const { return offset_; }
+
+private:
+    enum class Expect { VALUE, VALUE_OR_END, KEY, KEY_OR_END, COLON, COMMA_OR_END, DONE };
+    enum class Token { NONE, STRING, NUMBER, LITERAL };
+
+    bool Structural(char c);
+    bool StringChar(char c);
+    bool EmitNumber();
+    bool LiteralChar(char c);
+    bool AfterValue();
+    bool Fail(const char* message);
+    void AppendCodePoint(uint32_t codePoint);
+
+    Handler& handler_;
+    std::vector<char> stack_;       // '{' bzw. '[' der offenen Container
+    Expect expect_ = Expect::VALUE;
+    Token token_ = Token::NONE;
+    std::string buffer_;            // Inhalt des offenen Tokens
+    bool stringIsKey_ = false;
+    bool escape_ = false;
+    int unicodeDigits_ = 0;         // Noch erwartete Hex-Ziffern von \uXXXX
+    uint32_t unicodeValue_ = 0;
+    uint32_t highSurrogate_ = 0;
+    bool failed_ = false;
+    size_t offset_ = 0;
+    std::string error_;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// LRU-Cache mit Budget nach Kosten (z.B. Bytes) statt nach Anzahl.
+// Einträge, die allein das Budget sprengen, werden nicht aufgenommen.
+// Nicht thread-safe.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(size_t budget) : budget_(budget) {}
+
+    // Liefert den Wert und markiert ihn als zuletzt benutzt
+    bool Get(const Key& key, Value& out) {
+        auto it = map_.find(key);
+        if (it == map_.end()) {
+            ++misses_;
+            return false;
+        }
+        order_.splice(order_.begin(), order_, it->second);
+        out = it->second->value;
+        ++hits_;
+        return true;
+    }
+
+    bool Contains(const Key& key) const { return map_.count(key) > 0; }
+
+    void Put(const Key& key, Value value, size_t cost) {
+        Remove(key);
+        if (cost > budget_) return;
+        order_.push_front(Node{ key, std::move(value), cost });
+        map_[key] = order_.begin();
+        cost_ += cost;
+        Trim();
+    }
+
+    void Remove(const Key& key) {
+        auto it = map_.find(key);
+        if (it == map_.end()) return;
+        cost_ -= it->second->cost;
+        order_.erase(it->second);
+        map_.erase(it);
+    }
+
+    void Clear() {
+        map_.clear();
+        order_.clear();
+        cost_ = 0;
+    }
+
+    void SetBudget(size_t budget) {
+        budget_ = budget;
+        Trim();
+    }
+
+    size_t Size() const { return map_.size(); }
+    size_t Cost() const { return cost_; }
+    size_t Budget() const { return budget_; }
+    size_t Hits() const { return hits_; }
+    size_t Misses() const { return misses_; }
+
+private:
+    struct Node {
+        Key key;
+        Value value;
+        size_t cost;
+    };
+
+    void Trim() {
+        while (cost_ > budget_ && !order_.empty()) {
+            cost_ -= order_.back().cost;
+            map_.erase(order_.back().key);
+            order_.pop_back();
+        }
+    }
+
+    size_t budget_;
+    size_t cost_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    std::list<Node> order_;  // Vorne = zuletzt benutzt
+    std::unordered_map<Key, typename std::list<Node>::iterator, Hash> map_;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// MD5 (RFC 1321), inkrementell. Dient als Inhalts-Hash für Cache und
+// Download-Prüfung: Supabase Storage liefert die MD5 des Objekts als ETag.
+// Kein kryptographischer Schutz, nur Erkennung von Beschädigung.
+class Md5 {
+public:
+    Md5() { Reset(); }
+
+    void Reset();
+    void Update(const void* data, size_t size);
+    std::string HexDigest();  // 32 Zeichen, Kleinbuchstaben; danach Reset()
+
+    static std::string Hex(const void* data, size_t size);
+    static std::string Hex(const std::string& data) { return Hex(data.data(), data.size()); }
+
+private:
+    void Transform(const unsigned char* block);
+
+    uint32_t state_[4];
+    uint64_t length_;           // Bisher verarbeitete Bytes
+    unsigned char buffer_[64];
+    size_t buffered_;
+};
@@ -0,0 +1,180 @@
+#include "OutputFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+OutputFile::~OutputFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+static std::string LastErrorText(const char* what) {
+    return std::string(what) + " fehlgeschlagen (Fehler " + std::to_string(GetLastError()) + ")";
+}
+
+bool OutputFile::Open(const std::filesystem::path& path, bool truncate, std::string* lastError) {
+    Close();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                              truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        if (lastError) *lastError = LastErrorText("Datei öffnen");
+        return false;
+    }
+    handle_ = file;
+    return true;
+}
+
+bool OutputFile::IsOpen() const {
+    return handle_ != nullptr;
+}
+
+void OutputFile::Close() {
+    if (handle_) {
+        CloseHandle((HANDLE)handle_);
+        handle_ = nullptr;
+    }
+}
+
+uint64_t OutputFile::Size() const {
+    LARGE_INTEGER size;
+    if (!handle_ || !GetFileSizeEx((HANDLE)handle_, &size)) return 0;
+    return (uint64_t)size.QuadPart;
+}
+
+bool OutputFile::Truncate(uint64_t size, std::string* lastError) {
+    FILE_END_OF_FILE_INFO info;
+    info.EndOfFile.QuadPart = (LONGLONG)size;
+    if (!handle_ || !SetFileInformationByHandle((HANDLE)handle_, FileEndOfFileInfo, &info, sizeof(info))) {
+        if (lastError) *lastError = LastErrorText("Dateigröße setzen");
+        return false;
+    }
+    return true;
+}
+
+bool OutputFile::Preallocate(uint64_t size, std::string* lastError) {
+    if (Size() >= size) return true;
+    // Belegt die Cluster am Stück; die Länge selbst setzt Truncate
+    FILE_ALLOCATION_INFO allocation;
+    allocation.AllocationSize.QuadPart = (LONGLONG)size;
+    SetFileInformationByHandle((HANDLE)handle_, FileAllocationInfo, &allocation, sizeof(allocation));
+    return Truncate(size, lastError);
+}
+
+bool OutputFile::WriteAt(uint64_t offset, const void* data, size_t size, std::string* lastError) {
+    const char* bytes = (const char*)data;
+    while (size > 0) {
+        // Offset pro Aufruf über OVERLAPPED: kein gemeinsamer Dateizeiger
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD)offset;
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+        DWORD chunk = size > 0x40000000 ? 0x40000000 : (DWORD)size;
+        DWORD written = 0;
+        if (!handle_ || !WriteFile((HANDLE)handle_, bytes, chunk, &written, &overlapped) || written == 0) {
+            if (lastError) *lastError = LastErrorText("Schreiben");
+            return false;
+        }
+        bytes += written;
+        offset += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool OutputFile::Sync(std::string* lastError) {
+    if (!handle_ || !FlushFileBuffers((HANDLE)handle_)) {
+        if (lastError) *lastError = LastErrorText("FlushFileBuffers");
+        return false;
+    }
+    return true;
+}
+
+#else
+
+static std::string ErrnoText(const char* what) {
+    return std::string(what) + " fehlgeschlagen: " + std::strerror(errno);
+}
+
+bool OutputFile::Open(const std::filesystem::path& path, bool truncate, std::string* lastError) {
+    Close();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    if (fd < 0) {
+        if (lastError) *lastError = ErrnoText("Datei öffnen");
+        return false;
+    }
+    fd_ = fd;
+    return true;
+}
+
+bool OutputFile::IsOpen() const {
+    return fd_ >= 0;
+}
+
+void OutputFile::Close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+uint64_t OutputFile::Size() const {
+    struct stat info;
+    if (fd_ < 0 || fstat(fd_, &info) != 0) return 0;
+    return (uint64_t)info.st_size;
+}
+
+bool OutputFile::Truncate(uint64_t size, std::string* lastError) {
+    if (fd_ < 0 || ftruncate(fd_, (off_t)size) != 0) {
+        if (lastError) *lastError = ErrnoText("Dateigröße setzen");
+        return false;
+    }
+    return true;
+}
+
+bool OutputFile::Preallocate(uint64_t size, std::string* lastError) {
+    if (Size() >= size) return true;
+#if defined(__linux__)
+    // Echte Blöcke reservieren (Datenträger voll -> Fehler jetzt statt mittendrin)
+    int result = posix_fallocate(fd_, 0, (off_t)size);
+    if (result == 0) return true;
+    if (result != EINVAL && result != EOPNOTSUPP) {
+        errno = result;
+        if (lastError) *lastError = ErrnoText("posix_fallocate");
+        return false;
+    }
+#endif
+    return Truncate(size, lastError);
+}
+
+bool OutputFile::WriteAt(uint64_t offset, const void* data, size_t size, std::string* lastError) {
+    const char* bytes = (const char*)data;
+    while (size > 0) {
+        ssize_t written = pwrite(fd_, bytes, size, (off_t)offset);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            if (lastError) *lastError = ErrnoText("Schreiben");
+            return false;
+        }
+        bytes += written;
+        offset += (uint64_t)written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+bool OutputFile::Sync(std::string* lastError) {
+    if (fd_ < 0 || fsync(fd_) != 0) {
+        if (lastError) *lastError = ErrnoText("fsync");
+        return false;
+    }
+    return true;
+}
+
+#endif
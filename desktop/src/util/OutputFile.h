@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// Ausgabedatei für Downloads: positionelles Schreiben (mehrere Threads dürfen
+// gleichzeitig an verschiedene Offsets schreiben), Vorab-Allokation und Sync
+// auf den Datenträger. Windows: CreateFileW/WriteFile, sonst pwrite/fsync.
+class OutputFile {
+public:
+    OutputFile() = default;
+    ~OutputFile();
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    // Öffnet zum Schreiben; truncate = vorhandenen Inhalt verwerfen
+    bool Open(const std::filesystem::path& path, bool truncate, std::string* lastError = nullptr);
+    bool IsOpen() const;
+    void Close();
+
+    uint64_t Size() const;
+
+    // Reserviert Platz bis size (Datei wird mindestens so groß)
+    bool Preallocate(uint64_t size, std::string* lastError = nullptr);
+    bool Truncate(uint64_t size, std::string* lastError = nullptr);
+
+    bool WriteAt(uint64_t offset, const void* data, size_t size, std::string* lastError = nullptr);
+
+    // Schreibt Daten und Metadaten auf den Datenträger (FlushFileBuffers/fsync)
+    bool Sync(std::string* lastError = nullptr);
+
+private:
+#ifdef _WIN32
+    void* handle_ = nullptr;   // HANDLE (ohne <windows.h> im Header)
+#else
+    int fd_ = -1;
+#endif
+};
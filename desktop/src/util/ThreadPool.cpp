@@ -0,0 +1,50 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) threadCount = 1;
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        queue_.clear();
+        lowQueue_.clear();
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task, Priority priority) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return;
+        (priority == Priority::LOW ? lowQueue_ : queue_).push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+size_t ThreadPool::PendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() + lowQueue_.size();
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty() || !lowQueue_.empty(); });
+            if (stopping_) return;
+            std::deque<std::function<void()>>& source = queue_.empty() ? lowQueue_ : queue_;
+            task = std::move(source.front());
+            source.pop_front();
+        }
+        task();
+    }
+}
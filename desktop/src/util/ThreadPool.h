@@ -0,0 +1,34 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Einfacher Thread-Pool mit FIFO-Queues (portabel, ohne Win32).
+// LOW-Tasks (z.B. Vorausladen) starten nur, wenn keine NORMAL-Task wartet.
+class ThreadPool {
+public:
+    enum class Priority { NORMAL, LOW };
+
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();  // Verwirft wartende Tasks und wartet auf laufende
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> task, Priority priority = Priority::NORMAL);
+
+    // Anzahl noch nicht gestarteter Tasks
+    size_t PendingCount() const;
+
+private:
+    void WorkerLoop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    std::deque<std::function<void()>> lowQueue_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+};
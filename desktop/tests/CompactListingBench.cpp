@@ -0,0 +1,98 @@
+// Speicher pro Zeile: std::vector<FileInfo> gegen CompactListing, dazu Zeit für
+// Add (Packen) und Get (Entpacken).
+//   CompactListingBench [--rows=N] [--quick]
+#include "TestSupport.h"
+#include "storage/CompactListing.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using storagedata::FileInfo;
+
+namespace {
+    std::string RandomUuid(std::mt19937& random) {
+        static const char HEX[] = "0123456789abcdef";
+        std::string out;
+        for (int i = 0; i < 36; ++i) out += (i == 8 || i == 13 || i == 18 || i == 23) ? '-' : HEX[random() % 16];
+        return out;
+    }
+
+    // Zeilen wie von PostgREST (Projection::FULL): wenige Absender, jede Nachricht ein Verzeichnis
+    std::vector<FileInfo> MakeListing(size_t rows) {
+        static const char* TYPES[] = { "image/jpeg", "audio/wav", "audio/midi", "video/mp4", "application/pdf" };
+        std::mt19937 random(11);
+        std::vector<std::string> users;
+        for (int i = 0; i < 40; ++i) users.push_back(RandomUuid(random));
+
+        std::vector<FileInfo> out(rows);
+        int64_t micros = 1714566645123456LL;
+        for (size_t i = 0; i < rows; ++i) {
+            FileInfo& info = out[i];
+            const std::string& user = users[random() % users.size()];
+            std::string dir = user + "/" + RandomUuid(random) + "/";
+            info.id = RandomUuid(random);
+            micros -= 1 + random() % 60000000;
+            info.createdAt = FormatTimestamp(micros);
+            info.fileName = "Session " + std::to_string(i % 997) + " - Spur " + std::to_string(i % 24) + ".wav";
+            info.fileType = TYPES[i % 5];
+            info.storagePath = dir + info.fileName;
+            info.thumbnailPath = i % 5 == 0 ? dir + "thumb_" + std::to_string(i) + ".jpg" : "";
+            info.fileSize = random() % 200000000;
+            info.senderId = user;
+        }
+        return out;
+    }
+
+    // Heap eines std::string (0, solange der Text im Objekt selbst steht)
+    size_t HeapBytes(const std::string& text) {
+        const char* data = text.data();
+        bool inline_ = data >= (const char*)&text && data < (const char*)(&text + 1);
+        return inline_ ? 0 : text.capacity() + 1;
+    }
+
+    size_t VectorBytes(const std::vector<FileInfo>& infos) {
+        size_t bytes = infos.capacity() * sizeof(FileInfo);
+        for (const auto& info : infos) {
+            bytes += HeapBytes(info.id) + HeapBytes(info.fileName) + HeapBytes(info.fileType) + HeapBytes(info.storagePath) +
+                     HeapBytes(info.thumbnailPath) + HeapBytes(info.createdAt) + HeapBytes(info.senderId);
+        }
+        return bytes;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool quick = test::HasFlag(argc, argv, "--quick");
+    size_t rows = (size_t)test::NumberOption(argc, argv, "--rows", quick ? 20000 : 500000);
+
+    std::vector<FileInfo> infos = MakeListing(rows);
+
+    test::Stopwatch addWatch;
+    CompactListing listing;
+    listing.Reserve(rows);
+    for (const auto& info : infos) listing.Add(info);
+    double addSeconds = addWatch.Seconds();
+
+    test::Stopwatch getWatch;
+    size_t checked = 0;
+    for (size_t row = 0; row < listing.Size(); ++row) {
+        FileInfo info = listing.Get(row);
+        checked += info.storagePath == infos[row].storagePath && info.createdAt == infos[row].createdAt && info.id == infos[row].id;
+    }
+    double getSeconds = getWatch.Seconds();
+    CHECK(checked == rows);
+
+    listing.Compact();
+    CompactListing::MemoryUsage usage = listing.GetMemoryUsage();
+    size_t vectorBytes = VectorBytes(infos);
+    CHECK(usage.Total() < vectorBytes);
+
+    printf("%zu Zeilen\n", rows);
+    printf("std::vector<FileInfo>  %8.1f MB  %6.1f Byte/Zeile (Heap-Schätzung ohne malloc-Verwaltung)\n",
+           vectorBytes / 1048576.0, (double)vectorBytes / rows);
+    printf("CompactListing         %8.1f MB  %6.1f Byte/Zeile (Zeilen %.1f, Arena %.1f, interniert %.1f)  %.1fx kleiner\n",
+           usage.Total() / 1048576.0, (double)usage.Total() / rows, (double)usage.rowBytes / rows,
+           (double)usage.arenaBytes / rows, (double)usage.internedBytes / rows, (double)vectorBytes / usage.Total());
+    printf("Add %.0f ns/Zeile, Get %.0f ns/Zeile\n", addSeconds * 1e9 / rows, getSeconds * 1e9 / rows);
+    return test::Result();
+}
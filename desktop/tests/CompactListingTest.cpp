@@ -0,0 +1,212 @@
+// CompactListing: Get liefert jede FileInfo unverändert zurück (auch Zeilen außerhalb
+// des Schemas), nach Add, Prepend, Merge, Erase, Set, Retain und AddFrom.
+//   CompactListingTest [--rows=N] [--seed=N]
+#include "TestSupport.h"
+#include "storage/CompactListing.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using storagedata::FileInfo;
+
+namespace {
+    std::string RandomUuid(std::mt19937& random, bool upper = false) {
+        const char* hex = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        std::string out;
+        for (int i = 0; i < 36; ++i) out += (i == 8 || i == 13 || i == 18 || i == 23) ? '-' : hex[random() % 16];
+        return out;
+    }
+
+    template <size_t N>
+    const char* Pick(const char* const (&items)[N], std::mt19937& random) {
+        return items[random() % N];
+    }
+
+    // Überwiegend Zeilen wie von PostgREST, dazu alle Sonderfälle, die Pack als Text behält
+    FileInfo RandomInfo(std::mt19937& random, const std::vector<std::string>& users) {
+        static const char* const TYPES[] = { "image/jpeg", "image/png", "audio/wav", "audio/midi", "audio/x-midi",
+                                             "video/mp4", "application/pdf", "", "unknown" };
+        static const char* const ZONES[] = { "+00:00", "+00:00", "+00:00", "Z", "+02:00", "" };
+        FileInfo info;
+        int kind = random() % 10;
+
+        switch (random() % 12) {
+            case 0: info.id = RandomUuid(random, true); break;
+            case 1: info.id = "legacy-" + std::to_string(random() % 1000); break;
+            case 2: info.id = ""; break;
+            default: info.id = RandomUuid(random); break;
+        }
+
+        if (random() % 15 == 0) {
+            info.createdAt = random() % 2 ? "gestern" : "";
+        } else {
+            char text[48];
+            snprintf(text, sizeof(text), "%04u-%02u-%02u%c%02u:%02u:%02u", 1960 + (unsigned)random() % 80, 1 + (unsigned)random() % 12,
+                     1 + (unsigned)random() % 28, random() % 10 ? 'T' : ' ', (unsigned)random() % 24, (unsigned)random() % 60,
+                     (unsigned)random() % 60);
+            info.createdAt = text;
+            int digits = random() % 8;   // 7: mehr als Mikrosekunden
+            if (digits > 0) {
+                info.createdAt += '.';
+                for (int i = 0; i < digits; ++i) info.createdAt += (char)('0' + random() % 10);
+            }
+            info.createdAt += Pick(ZONES, random);
+        }
+
+        const std::string& owner = users[random() % users.size()];
+        std::string message = kind == 0 ? RandomUuid(random, true) : RandomUuid(random);
+        std::string leaf = "Take " + std::to_string(random() % 100) + (random() % 2 ? ".wav" : ".jpg");
+        switch (kind) {
+            case 1: info.storagePath = leaf; break;
+            case 2: info.storagePath = ""; break;
+            case 3: info.storagePath = "/" + message + "/" + leaf; break;
+            case 4: info.storagePath = owner + "/" + message + "/sub/" + leaf; break;
+            default: info.storagePath = owner + "/" + message + "/" + leaf; break;
+        }
+        std::string dir = info.storagePath.substr(0, info.storagePath.rfind('/') + 1);
+        switch (random() % 5) {
+            case 0: info.thumbnailPath = ""; break;
+            case 1: info.thumbnailPath = owner + "/" + RandomUuid(random) + "/thumb.jpg"; break;
+            case 2: info.thumbnailPath = dir + "thumbs/" + leaf + ".jpg"; break;
+            default: info.thumbnailPath = dir + "thumb_" + leaf + ".jpg"; break;
+        }
+        info.fileName = random() % 4 ? leaf : (random() % 2 ? "Anderer Name.wav" : "");
+        info.fileType = Pick(TYPES, random);
+        info.fileSize = random() % 10 ? (long long)(random() % 300000000) : 0;
+        info.senderId = random() % 6 ? users[random() % users.size()] : "";
+        return info;
+    }
+
+    bool Same(const FileInfo& a, const FileInfo& b) {
+        return a.id == b.id && a.fileName == b.fileName && a.fileType == b.fileType && a.storagePath == b.storagePath &&
+               a.thumbnailPath == b.thumbnailPath && a.fileSize == b.fileSize && a.createdAt == b.createdAt && a.senderId == b.senderId;
+    }
+
+    std::string Describe(const FileInfo& info) {
+        return "{" + info.id + ", " + info.createdAt + ", " + info.storagePath + ", " + info.thumbnailPath + ", " + info.fileName + "}";
+    }
+
+    void CheckContent(const CompactListing& listing, const std::vector<FileInfo>& expected, const char* step) {
+        CHECK_MSG(listing.Size() == expected.size(), "%s: %zu statt %zu Zeilen", step, listing.Size(), expected.size());
+        for (size_t row = 0; row < std::min(listing.Size(), expected.size()); ++row) {
+            FileInfo info = listing.Get(row);
+            if (!Same(info, expected[row])) {
+                CHECK_MSG(false, "%s, Zeile %zu: %s statt %s", step, row, Describe(info).c_str(), Describe(expected[row]).c_str());
+                return;
+            }
+        }
+    }
+
+    // Wie CompactListing::Newer für lesbare Zeitstempel; sonst nur Text-Reihenfolge der id
+    bool NewerInfo(const CompactListing& listing, size_t a, size_t b) {
+        int64_t ta = listing.CreatedAtMicros(a), tb = listing.CreatedAtMicros(b);
+        if (ta != tb) return ta > tb;
+        return listing.Id(a) > listing.Id(b);
+    }
+
+    void CheckKnownFormats() {
+        CHECK(FormatTimestamp(0) == "1970-01-01T00:00:00+00:00");
+        CHECK(FormatTimestamp(-1) == "1969-12-31T23:59:59.999999+00:00");
+        CHECK(FormatTimestamp(1714566645120000LL, "Z") == "2024-05-01T12:30:45.12Z");
+
+        Uuid uuid;
+        CHECK(Uuid::Parse("0123ABCD-ef45-6789-abcd-0123456789ef", uuid));
+        CHECK(uuid.ToString() == "0123abcd-ef45-6789-abcd-0123456789ef");
+        CHECK(CategoryOfMime("audio/x-midi") == MimeCategory::MIDI && CategoryOfMime("audio/wav") == MimeCategory::AUDIO);
+
+        IdSet ids;
+        CHECK(ids.Insert("0123abcd-ef45-6789-abcd-0123456789ef"));
+        CHECK(!ids.Insert(uuid));
+        CHECK(ids.Insert("legacy-1") && ids.Contains("legacy-1"));
+        ids.Erase(uuid);
+        CHECK(!ids.Contains("0123abcd-ef45-6789-abcd-0123456789ef"));
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t rows = (size_t)test::NumberOption(argc, argv, "--rows", 20000);
+    std::mt19937 random((unsigned)test::NumberOption(argc, argv, "--seed", 5));
+
+    CheckKnownFormats();
+
+    std::vector<std::string> users;
+    for (int i = 0; i < 50; ++i) users.push_back(RandomUuid(random));
+
+    // Add/Get
+    std::vector<FileInfo> expected;
+    CompactListing listing;
+    listing.Reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        expected.push_back(RandomInfo(random, users));
+        listing.Add(expected.back());
+    }
+    CheckContent(listing, expected, "Add");
+
+    std::vector<FileInfo> all;
+    listing.ToFileInfos(all);
+    CHECK(all.size() == expected.size() && std::equal(all.begin(), all.end(), expected.begin(), Same));
+
+    // Prepend
+    std::vector<FileInfo> front;
+    for (int i = 0; i < 100; ++i) front.push_back(RandomInfo(random, users));
+    listing.Prepend(front);
+    expected.insert(expected.begin(), front.begin(), front.end());
+    CheckContent(listing, expected, "Prepend");
+
+    // Set
+    for (int i = 0; i < 200; ++i) {
+        size_t row = random() % expected.size();
+        expected[row] = RandomInfo(random, users);
+        listing.Set(row, expected[row]);
+    }
+    CheckContent(listing, expected, "Set");
+
+    // Erase jeder dritten Zeile, dann Compact (räumt die Arena auf)
+    std::vector<size_t> erased;
+    std::vector<FileInfo> remaining;
+    for (size_t row = 0; row < expected.size(); ++row) {
+        if (row % 3 == 1) erased.push_back(row);
+        else remaining.push_back(expected[row]);
+    }
+    listing.Erase(erased);
+    expected = remaining;
+    CheckContent(listing, expected, "Erase");
+    size_t arenaBefore = listing.GetMemoryUsage().arenaBytes;
+    listing.Compact();
+    CheckContent(listing, expected, "Compact");
+    CHECK(listing.GetMemoryUsage().arenaBytes <= arenaBefore);
+
+    // Retain und AddFrom übernehmen Zeilen zwischen Listings ohne Verlust
+    CompactListing copy;
+    for (size_t row = 0; row < listing.Size(); row += 2) copy.AddFrom(listing, row);
+    std::vector<FileInfo> everySecond;
+    for (size_t row = 0; row < expected.size(); row += 2) everySecond.push_back(expected[row]);
+    CheckContent(copy, everySecond, "AddFrom");
+    listing.Retain([](size_t row) { return row % 2 == 0; });
+    CheckContent(listing, everySecond, "Retain");
+
+    // Merge: sortiert einmischen; neue Zeilen an den gemeldeten Positionen
+    CompactListing sorted;
+    std::vector<FileInfo> batch;
+    for (int round = 0; round < 5; ++round) {
+        batch.clear();
+        for (int i = 0; i < 400; ++i) batch.push_back(RandomInfo(random, users));
+        std::vector<size_t> inserted;
+        sorted.Merge(batch, &inserted);
+        CHECK(inserted.size() == batch.size());
+        CHECK(std::is_sorted(inserted.begin(), inserted.end()));
+        std::vector<FileInfo> atInserted;
+        for (size_t row : inserted) atInserted.push_back(sorted.Get(row));
+        for (const auto& info : batch) {
+            bool found = std::any_of(atInserted.begin(), atInserted.end(), [&](const FileInfo& other) { return Same(info, other); });
+            CHECK_MSG(found, "Merge: %s fehlt", Describe(info).c_str());
+        }
+    }
+    for (size_t row = 1; row < sorted.Size(); ++row) {
+        CHECK_MSG(!NewerInfo(sorted, row, row - 1), "Merge: Zeile %zu steht vor einer älteren", row);
+    }
+    CHECK(sorted.Size() == 2000);
+
+    return test::Result();
+}
@@ -0,0 +1,139 @@
+// FileDownloader gegen LocalHttpServer: der Speicher bleibt flach, egal wie groß
+// die Datei ist (Body läuft über den FileSink-Pufferring direkt in die Datei),
+// als einzelner Stream und segmentiert. Danach wird der Inhalt geprüft.
+//   DownloadMemoryTest [--size=N[K|M|G]] [--dir=Zielordner] [--limit=MB]
+#include "TestSupport.h"
+#ifdef _WIN32
+int main() {
+    printf("Übersprungen: LocalHttpServer gibt es nur mit POSIX-Sockets\n");
+    return test::SKIPPED;
+}
+#else
+#include "LocalHttpServer.h"
+#include "storage/FileDownloader.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    uint64_t ParseSize(const std::string& text, uint64_t fallback) {
+        if (text.empty()) return fallback;
+        char* end = nullptr;
+        uint64_t value = std::strtoull(text.c_str(), &end, 10);
+        switch (end ? *end : '\0') {
+            case 'G': case 'g': return value << 30;
+            case 'M': case 'm': return value << 20;
+            case 'K': case 'k': return value << 10;
+            default: return value;
+        }
+    }
+
+    // Höchster VmRSS, solange das Objekt lebt (Abtastung alle 5 ms)
+    class PeakSampler {
+    public:
+        PeakSampler() : thread_([this] {
+            while (!stop_) {
+                size_t rss = test::ResidentBytes();
+                if (rss > peak_) peak_ = rss;
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }) {}
+        ~PeakSampler() { Stop(); }
+
+        size_t Stop() {
+            if (thread_.joinable()) {
+                stop_ = true;
+                thread_.join();
+            }
+            return peak_;
+        }
+
+    private:
+        std::atomic<bool> stop_{false};
+        std::atomic<size_t> peak_{0};
+        std::thread thread_;
+    };
+
+    // Vergleicht die Datei blockweise mit dem erzeugten Inhalt
+    bool SameContent(const fs::path& path, uint64_t size) {
+        std::error_code error;
+        if (fs::file_size(path, error) != size || error) return false;
+        std::ifstream file(path, std::ios::binary);
+        std::vector<unsigned char> actual(1 << 20), expected(1 << 20);
+        for (uint64_t offset = 0; offset < size;) {
+            size_t count = (size_t)std::min<uint64_t>(actual.size(), size - offset);
+            if (!file.read((char*)actual.data(), (std::streamsize)count)) return false;
+            test::LocalHttpServer::FillContent(offset, expected.data(), count);
+            if (memcmp(actual.data(), expected.data(), count) != 0) return false;
+            offset += count;
+        }
+        return true;
+    }
+
+    void Run(const char* mode, test::LocalHttpServer& server, const fs::path& dir, uint64_t size, int maxSegments, size_t limit) {
+        fs::path target = dir / (std::string("download-") + mode + ".bin");
+        FileDownloader::DiscardPartial(target);
+        std::error_code error;
+        fs::remove(target, error);
+
+        FileDownloader::Options options;
+        options.maxSegments = maxSegments;
+        options.retryDelay = std::chrono::milliseconds(10);
+        uint64_t progressCalls = 0;
+        options.onProgress = [&](uint64_t, int64_t) { ++progressCalls; return true; };
+
+        size_t baseline = test::ResidentBytes();
+        uint64_t sentBefore = server.BytesSent();
+        std::string err;
+        test::Stopwatch stopwatch;
+        PeakSampler sampler;
+        bool ok = FileDownloader::Download(server.Url("/file/big"), target, options, &err);
+        size_t peak = sampler.Stop();
+        double seconds = stopwatch.Seconds();
+
+        CHECK_MSG(ok, "%s: %s", mode, err.c_str());
+        CHECK(!FileDownloader::HasPartial(target));
+        CHECK(progressCalls > 0);
+        uint64_t sent = server.BytesSent() - sentBefore;
+        CHECK_MSG(sent >= size && sent < size + size / 100 + 65536, "%s: %llu Bytes gesendet", mode, (unsigned long long)sent);
+
+        size_t growth = peak > baseline ? peak - baseline : 0;
+        if (baseline > 0) {
+            CHECK_MSG(growth < limit, "%s: RSS um %.1f MB gewachsen (Grenze %.1f MB)", mode, growth / 1048576.0, limit / 1048576.0);
+        }
+        CHECK_MSG(ok && SameContent(target, size), "%s: Inhalt weicht ab", mode);
+        printf("%-11s %7.1f MB in %6.2f s (%6.1f MB/s), RSS %6.1f -> max %6.1f MB (+%.1f MB)\n", mode, size / 1048576.0,
+               seconds, size / 1048576.0 / seconds, baseline / 1048576.0, peak / 1048576.0, growth / 1048576.0);
+        fs::remove(target, error);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint64_t size = ParseSize(test::Option(argc, argv, "--size"), 256ULL << 20);
+    size_t limit = (size_t)test::NumberOption(argc, argv, "--limit", 48) << 20;
+    fs::path dir = test::Option(argc, argv, "--dir", (fs::temp_directory_path() / ("DownloadMemoryTest-" + std::to_string(getpid()))).string());
+    std::error_code error;
+    fs::create_directories(dir, error);
+
+    test::LocalHttpServer server;
+    server.AddFile("big", size);
+    if (!server.Start()) {
+        printf("Übersprungen: kein lokaler Port\n");
+        return test::SKIPPED;
+    }
+    if (test::ResidentBytes() == 0) printf("VmRSS nicht lesbar: nur Inhalt wird geprüft\n");
+
+    // Grenze für das Wachstum: unabhängig von size (Pufferringe, Threads, Verbindungen)
+    Run("ein Stream", server, dir, size, 1, limit);
+    Run("segmentiert", server, dir, size, 6, limit);
+
+    server.Stop();
+    fs::remove_all(dir, error);
+    return test::Result();
+}
+#endif
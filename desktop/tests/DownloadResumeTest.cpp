@@ -0,0 +1,216 @@
+// FileDownloader: Fortsetzen nach Abbruch. Ein Download wird per onProgress
+// abgebrochen, .part.meta muss den Stand tragen; ein zweiter Download (neuer
+// Server, andere URL wie bei neu signierten URLs) holt per Range/If-Range nur
+// den Rest. Geänderter ETag oder ein Server ohne Range-Unterstützung (200)
+// erzwingen einen Neubeginn, die MD5 im ETag wird am Ende geprüft.
+//   DownloadResumeTest [--size=MB]
+#include "TestSupport.h"
+#ifdef _WIN32
+int main() {
+    printf("Übersprungen: LocalHttpServer gibt es nur mit POSIX-Sockets\n");
+    return test::SKIPPED;
+}
+#else
+#include "LocalHttpServer.h"
+#include "storage/FileDownloader.h"
+#include "util/Md5.h"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Header, Abbruch-Nachlauf: so viel darf über den fehlenden Rest hinaus gesendet werden
+    const uint64_t SLACK = 256 * 1024;
+
+    bool SameContent(const fs::path& path, uint64_t size) {
+        std::error_code error;
+        if (fs::file_size(path, error) != size || error) return false;
+        std::ifstream file(path, std::ios::binary);
+        std::vector<unsigned char> actual(1 << 20), expected(1 << 20);
+        for (uint64_t offset = 0; offset < size;) {
+            size_t count = (size_t)std::min<uint64_t>(actual.size(), size - offset);
+            if (!file.read((char*)actual.data(), (std::streamsize)count)) return false;
+            test::LocalHttpServer::FillContent(offset, expected.data(), count);
+            if (memcmp(actual.data(), expected.data(), count) != 0) return false;
+            offset += count;
+        }
+        return true;
+    }
+
+    // ETag wie bei Supabase Storage: MD5 des Inhalts in Anführungszeichen
+    std::string ContentEtag(uint64_t size) {
+        Md5 md5;
+        std::vector<unsigned char> chunk(1 << 20);
+        for (uint64_t offset = 0; offset < size; offset += chunk.size()) {
+            size_t count = (size_t)std::min<uint64_t>(chunk.size(), size - offset);
+            test::LocalHttpServer::FillContent(offset, chunk.data(), count);
+            md5.Update(chunk.data(), count);
+        }
+        return "\"" + md5.HexDigest() + "\"";
+    }
+
+    // Gespeicherter Stand aus <Ziel>.part.meta
+    struct Meta {
+        bool found = false;
+        std::string etag;
+        int64_t size = -1;
+        uint64_t received = 0;
+        uint64_t doneBytes = 0;     // Segmentiert: fertige Bereiche hinter received
+    };
+
+    Meta ReadMeta(const fs::path& target) {
+        Meta meta;
+        fs::path path = target;
+        path += ".part.meta";
+        std::ifstream file(path);
+        std::string line;
+        if (!std::getline(file, line)) return meta;
+        meta.found = true;
+        while (std::getline(file, line)) {
+            size_t space = line.find(' ');
+            if (space == std::string::npos) continue;
+            std::string key = line.substr(0, space), value = line.substr(space + 1);
+            if (key == "etag") meta.etag = value;
+            else if (key == "size") meta.size = std::strtoll(value.c_str(), nullptr, 10);
+            else if (key == "received") meta.received = std::strtoull(value.c_str(), nullptr, 10);
+            else if (key == "done") {
+                char* end = nullptr;
+                uint64_t start = std::strtoull(value.c_str(), &end, 10);
+                meta.doneBytes += std::strtoull(end, nullptr, 10) - start;
+            }
+        }
+        return meta;
+    }
+
+    std::unique_ptr<test::LocalHttpServer> StartServer(uint64_t size, const std::string& etag, bool ranges = true,
+                                                       uint64_t bytesPerSecond = 0) {
+        test::LocalHttpServer::Options options;
+        options.ranges = ranges;
+        options.bytesPerSecond = bytesPerSecond;
+        auto server = std::make_unique<test::LocalHttpServer>(options);
+        server->AddFile("stem.wav", size, etag);
+        if (!server->Start()) return nullptr;
+        return server;
+    }
+
+    FileDownloader::Options DownloadOptions(int maxSegments) {
+        FileDownloader::Options options;
+        options.maxSegments = maxSegments;
+        options.retryDelay = std::chrono::milliseconds(10);
+        // Segmentiert auch bei der kleinen Testdatei
+        options.segmentThreshold = 4ULL << 20;
+        options.segmentSize = 1ULL << 20;
+        return options;
+    }
+
+    // Bricht ab, sobald ein Drittel empfangen ist; danach muss ein fortsetzbarer Stand liegen
+    Meta Interrupt(const char* mode, const fs::path& target, uint64_t size, const std::string& etag, int maxSegments) {
+        // Gedrosselt: segmentiert fragt der Downloader onProgress nur alle 250 ms ab
+        auto server = StartServer(size, etag, true, 32ULL << 20);
+        if (!server) {
+            CHECK_MSG(false, "%s: Server startet nicht", mode);
+            return Meta();
+        }
+        FileDownloader::Options options = DownloadOptions(maxSegments);
+        options.onProgress = [size](uint64_t received, int64_t) { return received < size / 3; };
+        std::string err;
+        CHECK_MSG(!FileDownloader::Download(server->Url("/file/stem.wav"), target, options, &err), "%s: nicht abgebrochen", mode);
+        server->Stop();
+
+        CHECK_MSG(FileDownloader::HasPartial(target), "%s: kein Teil-Download nach Abbruch (%s)", mode, err.c_str());
+        CHECK(!fs::exists(target));
+        Meta meta = ReadMeta(target);
+        uint64_t complete = meta.received + meta.doneBytes;
+        CHECK_MSG(meta.found && meta.etag == etag && meta.size == (int64_t)size, "%s: .part.meta passt nicht (etag %s, size %lld)",
+                  mode, meta.etag.c_str(), (long long)meta.size);
+        CHECK_MSG(complete > 0 && complete < size, "%s: %llu von %llu Bytes gesichert", mode, (unsigned long long)complete,
+                  (unsigned long long)size);
+        fs::path part = target;
+        part += ".part";
+        std::error_code error;
+        CHECK(fs::file_size(part, error) >= meta.received && !error);
+        return meta;
+    }
+
+    // Zweiter Download gegen einen neuen Server; liefert die gesendeten Bytes
+    uint64_t Finish(const char* mode, const fs::path& target, uint64_t size, const std::string& etag, int maxSegments,
+                    bool ranges = true) {
+        auto server = StartServer(size, etag, ranges);
+        if (!server) {
+            CHECK_MSG(false, "%s: Server startet nicht", mode);
+            return 0;
+        }
+        std::string err;
+        bool ok = FileDownloader::Download(server->Url("/file/stem.wav"), target, DownloadOptions(maxSegments), &err);
+        uint64_t sent = server->BytesSent();
+        server->Stop();
+        CHECK_MSG(ok, "%s: %s", mode, err.c_str());
+        CHECK_MSG(!FileDownloader::HasPartial(target), "%s: Teil-Download nicht aufgeräumt", mode);
+        CHECK_MSG(ok && SameContent(target, size), "%s: Inhalt weicht ab", mode);
+        return sent;
+    }
+
+    void CheckResume(const char* mode, const fs::path& target, uint64_t size, const std::string& etag, int maxSegments) {
+        Meta meta = Interrupt(mode, target, size, etag, maxSegments);
+        uint64_t missing = size - (meta.received + meta.doneBytes);
+        uint64_t sent = Finish(mode, target, size, etag, maxSegments);
+        CHECK_MSG(sent >= missing && sent < missing + SLACK, "%s: %llu Bytes gesendet, fehlend waren %llu", mode,
+                  (unsigned long long)sent, (unsigned long long)missing);
+        printf("%-22s fortgesetzt bei %5.1f MB, %5.1f MB nachgeladen\n", mode, (size - missing) / 1048576.0, sent / 1048576.0);
+        std::error_code error;
+        fs::remove(target, error);
+    }
+
+    // Server passt nicht mehr zum Stand: alles neu laden, Ergebnis trotzdem identisch
+    void CheckRestart(const char* mode, const fs::path& target, uint64_t size, const std::string& etag,
+                      const std::string& newEtag, bool ranges) {
+        Interrupt(mode, target, size, etag, 1);
+        uint64_t sent = Finish(mode, target, size, newEtag, 1, ranges);
+        CHECK_MSG(sent >= size && sent < size + SLACK, "%s: %llu Bytes gesendet statt der ganzen Datei", mode, (unsigned long long)sent);
+        printf("%-22s neu begonnen, %5.1f MB geladen\n", mode, sent / 1048576.0);
+        std::error_code error;
+        fs::remove(target, error);
+    }
+
+    // ETag ist eine MD5, der Inhalt passt nicht dazu: Fehler, nichts bleibt liegen
+    void CheckChecksum(const fs::path& target, uint64_t size) {
+        auto server = StartServer(size, "\"00000000000000000000000000000000\"");
+        if (!server) {
+            CHECK_MSG(false, "Prüfsumme: Server startet nicht");
+            return;
+        }
+        std::string err;
+        bool ok = FileDownloader::Download(server->Url("/file/stem.wav"), target, DownloadOptions(1), &err);
+        server->Stop();
+        CHECK_MSG(!ok && err.find("Prüfsumme") != std::string::npos, "Prüfsumme: %s", ok ? "nicht erkannt" : err.c_str());
+        CHECK(!fs::exists(target) && !FileDownloader::HasPartial(target));
+    }
+}
+
+int main(int argc, char** argv) {
+    uint64_t size = (uint64_t)test::NumberOption(argc, argv, "--size", 24) << 20;
+    fs::path dir = fs::temp_directory_path() / ("DownloadResumeTest-" + std::to_string(getpid()));
+    std::error_code error;
+    fs::create_directories(dir, error);
+    fs::path target = dir / "stem.wav";
+    std::string etag = ContentEtag(size);
+
+    CheckResume("ein Stream", target, size, etag, 1);
+    CheckResume("segmentiert", target, size, etag, 6);
+    CheckRestart("ETag geändert", target, size, etag, "\"v2\"", true);
+    CheckRestart("200 statt 206", target, size, etag, etag, false);
+    CheckChecksum(target, size);
+
+    // Nein beim Fortsetzen: DiscardPartial räumt .part und .part.meta weg
+    Interrupt("verwerfen", target, size, etag, 1);
+    FileDownloader::DiscardPartial(target);
+    CHECK(!FileDownloader::HasPartial(target) && !fs::exists(dir / "stem.wav.part") && !fs::exists(dir / "stem.wav.part.meta"));
+
+    fs::remove_all(dir, error);
+    return test::Result();
+}
+#endif
@@ -0,0 +1,143 @@
+// FastParse: SSE2-Varianten gegen die *Scalar-Referenz (Ergebnis und Wert) für
+// gültige, mutierte und zufällige UUIDs/Zeitstempel; Kalenderumrechnung.
+//   FastParseTest [--iterations=N] [--seed=N]
+#include "TestSupport.h"
+#include "util/FastParse.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // Zeichen nahe den Grenzen der Ziffern-/Hex-Prüfung, dazu Trenner und Bytes >= 0x80
+    const char TRICKY[] = "/0189:@AFGZ`afgz-T .+Z\x7f\x80\xc1\xe6\xff";
+
+    char RandomChar(std::mt19937& random) {
+        if (random() % 2) return TRICKY[random() % (sizeof(TRICKY) - 1)];
+        return (char)(random() % 256);
+    }
+
+    // Ändert, löscht oder ergänzt einzelne Zeichen
+    std::string Mutate(std::string text, std::mt19937& random) {
+        int changes = 1 + random() % 3;
+        for (int i = 0; i < changes; ++i) {
+            size_t pos = text.empty() ? 0 : random() % text.size();
+            switch (random() % 4) {
+                case 0: if (!text.empty()) text.erase(pos, 1); break;
+                case 1: text.insert(text.begin() + pos, RandomChar(random)); break;
+                default: if (!text.empty()) text[pos] = RandomChar(random); break;
+            }
+        }
+        return text;
+    }
+
+    std::string RandomUuid(std::mt19937& random) {
+        static const char HEX[] = "0123456789abcdefABCDEF";
+        std::string out;
+        for (int i = 0; i < 36; ++i) {
+            out += (i == 8 || i == 13 || i == 18 || i == 23) ? '-' : HEX[random() % 22];
+        }
+        return out;
+    }
+
+    std::string RandomTimestamp(std::mt19937& random) {
+        char text[80];
+        snprintf(text, sizeof(text), "%04u-%02u-%02u%c%02u:%02u:%02u", (unsigned)random() % 10000, (unsigned)random() % 14,
+                 (unsigned)random() % 33, random() % 4 ? 'T' : ' ', (unsigned)random() % 25, (unsigned)random() % 61,
+                 (unsigned)random() % 62);
+        std::string out = text;
+        if (random() % 5) {
+            out += '.';
+            int digits = random() % 11;  // 0 (ungültig) bis 10 Stellen
+            for (int i = 0; i < digits; ++i) out += (char)('0' + random() % 10);
+        }
+        static const char* ZONES[] = { "", "Z", "+00:00", "+00", "+0000", "-05:30", "+14:00", "-00:00", "+01", "+1", "z", "Z ", "+00:00:00" };
+        out += ZONES[random() % (sizeof(ZONES) / sizeof(ZONES[0]))];
+        return out;
+    }
+
+    // Exakt große Kopie, damit die Parser nur length Bytes sehen
+    void CheckUuid(const std::string& text) {
+        std::vector<char> buffer(text.begin(), text.end());
+        uint64_t hi = 1, lo = 2, refHi = 1, refLo = 2;
+        bool ok = FastParse::ParseUuid(buffer.data(), buffer.size(), hi, lo);
+        bool refOk = FastParse::ParseUuidScalar(buffer.data(), buffer.size(), refHi, refLo);
+        CHECK_MSG(ok == refOk, "ParseUuid(\"%s\"): %d statt %d", text.c_str(), ok, refOk);
+        if (ok && refOk) CHECK_MSG(hi == refHi && lo == refLo, "ParseUuid(\"%s\"): anderer Wert", text.c_str());
+    }
+
+    void CheckTimestamp(const std::string& text) {
+        std::vector<char> buffer(text.begin(), text.end());
+        int64_t micros = 1, refMicros = 2;
+        bool ok = FastParse::ParseTimestamp(buffer.data(), buffer.size(), micros);
+        bool refOk = FastParse::ParseTimestampScalar(buffer.data(), buffer.size(), refMicros);
+        CHECK_MSG(ok == refOk, "ParseTimestamp(\"%s\"): %d statt %d", text.c_str(), ok, refOk);
+        if (ok && refOk) {
+            CHECK_MSG(micros == refMicros, "ParseTimestamp(\"%s\"): %lld statt %lld", text.c_str(), (long long)micros, (long long)refMicros);
+        }
+    }
+
+    void CheckKnownValues() {
+        uint64_t hi = 0, lo = 0;
+        CHECK(FastParse::ParseUuid("0123abcd-EF45-6789-aBcD-0123456789ef", 36, hi, lo));
+        CHECK(hi == 0x0123abcdef456789ULL && lo == 0xabcd0123456789efULL);
+        CHECK(!FastParse::ParseUuid("0123abcd-ef45-6789-abcd-0123456789eg", 36, hi, lo));
+        CHECK(!FastParse::ParseUuid("0123abcd0ef45-6789-abcd-0123456789ef", 36, hi, lo));
+
+        int64_t micros = 0;
+        CHECK(FastParse::ParseTimestamp("1970-01-01T00:00:00Z", 20, micros) && micros == 0);
+        CHECK(FastParse::ParseTimestamp("2024-05-01T12:30:45.123456+00:00", 32, micros) && micros == 1714566645123456LL);
+        CHECK(FastParse::ParseTimestamp("2024-05-01 14:30:45.1+02:00", 27, micros) && micros == 1714566645100000LL);
+        CHECK(FastParse::ParseTimestamp("2024-05-01T12:30:45.1234569", 27, micros) && micros == 1714566645123456LL);
+        CHECK(FastParse::ParseTimestamp("1969-12-31T23:59:59.999999", 26, micros) && micros == -1);
+        CHECK(FastParse::DayOf(-1) == -1 && FastParse::DayOf(0) == 0 && FastParse::DayOf(86400LL * 1000000 - 1) == 0);
+        CHECK(!FastParse::ParseTimestamp("2024-13-01T00:00:00", 19, micros));
+        CHECK(!FastParse::ParseTimestamp("2024-05-01T00:00:00.", 20, micros));
+    }
+
+    // DaysFromCivil/CivilFromDays sind zueinander invers (auch vor 1970 und vor Jahr 0)
+    void CheckCalendar() {
+        int64_t previous = FastParse::DaysFromCivil(-1, 12, 31);
+        for (int64_t days = FastParse::DaysFromCivil(0, 1, 1); days < FastParse::DaysFromCivil(10000, 1, 1); ++days) {
+            int year;
+            unsigned month, day;
+            FastParse::CivilFromDays(days, year, month, day);
+            if (FastParse::DaysFromCivil(year, month, day) != days || days != previous + 1) {
+                CHECK_MSG(false, "Tag %lld -> %04d-%02u-%02u", (long long)days, year, month, day);
+                return;
+            }
+            previous = days;
+        }
+        CHECK(FastParse::DaysFromCivil(1970, 1, 1) == 0);
+        CHECK(FastParse::DaysFromCivil(2000, 3, 1) == 11017);
+    }
+}
+
+int main(int argc, char** argv) {
+    long long iterations = test::NumberOption(argc, argv, "--iterations", 300000);
+    std::mt19937 random((unsigned)test::NumberOption(argc, argv, "--seed", 12));
+
+    CheckKnownValues();
+    CheckCalendar();
+
+    // Gleich viele gültige, mutierte und völlig zufällige Eingaben
+    for (long long i = 0; i < iterations; ++i) {
+        std::string uuid = RandomUuid(random);
+        std::string timestamp = RandomTimestamp(random);
+        switch (i % 3) {
+            case 0: break;
+            case 1: uuid = Mutate(uuid, random); timestamp = Mutate(timestamp, random); break;
+            default: {
+                size_t length = random() % 40;
+                uuid.clear();
+                timestamp = timestamp.substr(0, 19);
+                for (size_t j = 0; j < length; ++j) uuid += RandomChar(random);
+                for (size_t j = 0; j < length % 18; ++j) timestamp += RandomChar(random);
+                break;
+            }
+        }
+        CheckUuid(uuid);
+        CheckTimestamp(timestamp);
+        if (test::Failures() > 20) break;
+    }
+    return test::Result();
+}
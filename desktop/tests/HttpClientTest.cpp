@@ -0,0 +1,205 @@
+// HttpClient (Socket-Backend) gegen LocalHttpServer: Keep-Alive-Wiederverwendung,
+// Obergrenzen pro Host, vom Server geschlossene Verbindungen; Requests/s mit und
+// ohne Pool.
+//   HttpClientTest [--requests=N]
+#include "TestSupport.h"
+#ifdef _WIN32
+int main() {
+    printf("Übersprungen: LocalHttpServer gibt es nur mit POSIX-Sockets\n");
+    return test::SKIPPED;
+}
+#else
+#include "LocalHttpServer.h"
+#include "net/HttpClient.h"
+#include <thread>
+#include <vector>
+
+namespace {
+    const uint64_t SMALL_SIZE = 1500;
+
+    bool Get(net::HttpClient& client, const std::string& url, net::HttpResponse& response, std::string* error = nullptr) {
+        net::HttpRequest request;
+        request.url = url;
+        return client.Send(request, response, error);
+    }
+
+    bool SameContent(const std::string& body, uint64_t offset = 0) {
+        for (size_t i = 0; i < body.size(); ++i) {
+            if ((unsigned char)body[i] != test::LocalHttpServer::ContentByte(offset + i)) return false;
+        }
+        return true;
+    }
+
+    // Nacheinander: eine einzige Verbindung für alle Requests
+    void CheckSequentialReuse() {
+        test::LocalHttpServer server;
+        server.AddFile("small", SMALL_SIZE);
+        CHECK(server.Start());
+        net::HttpClient client;
+
+        const int REQUESTS = 20;
+        for (int i = 0; i < REQUESTS; ++i) {
+            net::HttpResponse response;
+            std::string error;
+            CHECK_MSG(Get(client, server.Url("/file/small"), response, &error), "%s", error.c_str());
+            CHECK(response.status == 200 && response.body.size() == SMALL_SIZE && SameContent(response.body));
+        }
+        // Auch Requests mit Body, 404 und HEAD lassen die Verbindung im Pool
+        net::HttpRequest post;
+        post.method = "POST";
+        post.url = server.Url("/file/small");
+        post.body = "{\"expiresIn\":3600}";
+        net::HttpResponse response;
+        CHECK(client.Send(post, response) && response.status == 200);
+        CHECK(Get(client, server.Url("/file/missing"), response) && response.status == 404);
+        net::HttpRequest head;
+        head.method = "HEAD";
+        head.url = server.Url("/file/small");
+        CHECK(client.Send(head, response) && response.status == 200 && response.body.empty());
+
+        net::HttpClient::Stats stats = client.GetStats();
+        CHECK(stats.requests == REQUESTS + 3);
+        CHECK(stats.connectionsOpened == 1);
+        CHECK(stats.connectionsReused == REQUESTS + 2);
+        CHECK(server.ConnectionsAccepted() == 1);
+    }
+
+    // Parallel: höchstens so viele Verbindungen wie Threads, danach nur Wiederverwendung
+    void CheckConcurrentReuse() {
+        test::LocalHttpServer::Options options;
+        options.latency = std::chrono::milliseconds(2);
+        test::LocalHttpServer server(options);
+        server.AddFile("small", SMALL_SIZE);
+        CHECK(server.Start());
+        net::HttpClient client;
+
+        const int THREADS = 4, REQUESTS = 25;
+        std::atomic<int> failures{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < REQUESTS; ++i) {
+                    net::HttpResponse response;
+                    if (!Get(client, server.Url("/file/small"), response) || response.status != 200 || !SameContent(response.body)) ++failures;
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        net::HttpClient::Stats stats = client.GetStats();
+        CHECK(failures == 0);
+        CHECK(stats.connectionsOpened >= 1 && stats.connectionsOpened <= THREADS);
+        CHECK(stats.connectionsOpened + stats.connectionsReused == THREADS * REQUESTS);
+        CHECK(server.ConnectionsAccepted() == stats.connectionsOpened);
+    }
+
+    // SetMaxConnectionsPerHost: weitere Requests warten auf eine freie Verbindung
+    void CheckConnectionLimit() {
+        test::LocalHttpServer::Options options;
+        options.latency = std::chrono::milliseconds(5);
+        test::LocalHttpServer server(options);
+        server.AddFile("small", SMALL_SIZE);
+        CHECK(server.Start());
+        net::HttpClient client;
+        client.SetMaxConnectionsPerHost(2);
+
+        std::atomic<int> failures{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 6; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 5; ++i) {
+                    net::HttpResponse response;
+                    if (!Get(client, server.Url("/file/small"), response) || response.status != 200) ++failures;
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        CHECK(failures == 0);
+        CHECK(server.MaxOpenConnections() <= 2);
+        CHECK(client.GetStats().connectionsOpened <= 2);
+    }
+
+    // Server schließt: angekündigt ("Connection: close") und still nach Idle-Timeout
+    void CheckServerClose() {
+        {
+            test::LocalHttpServer::Options options;
+            options.requestsPerConnection = 3;
+            test::LocalHttpServer server(options);
+            server.AddFile("small", SMALL_SIZE);
+            CHECK(server.Start());
+            net::HttpClient client;
+            for (int i = 0; i < 9; ++i) {
+                net::HttpResponse response;
+                CHECK(Get(client, server.Url("/file/small"), response) && response.status == 200);
+            }
+            CHECK(client.GetStats().connectionsOpened == 3);
+            CHECK(server.ConnectionsAccepted() == 3);
+        }
+        {
+            test::LocalHttpServer::Options options;
+            options.idleTimeout = std::chrono::milliseconds(50);
+            test::LocalHttpServer server(options);
+            server.AddFile("small", SMALL_SIZE);
+            CHECK(server.Start());
+            net::HttpClient client;
+            net::HttpResponse response;
+            CHECK(Get(client, server.Url("/file/small"), response) && response.status == 200);
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            // Die Pool-Verbindung ist tot: einmal mit neuer Verbindung wiederholen
+            std::string error;
+            CHECK_MSG(Get(client, server.Url("/file/small"), response, &error) && response.status == 200, "%s", error.c_str());
+            CHECK(SameContent(response.body));
+            CHECK(client.GetStats().connectionsOpened == 2);
+            CHECK(client.GetStats().connectionsReused == 0);
+        }
+    }
+
+    // CloseIdleConnections und SetMaxIdlePerHost(0) verhindern die Wiederverwendung
+    void CheckIdleControl() {
+        test::LocalHttpServer server;
+        server.AddFile("small", SMALL_SIZE);
+        CHECK(server.Start());
+        net::HttpClient client;
+        net::HttpResponse response;
+        CHECK(Get(client, server.Url("/file/small"), response));
+        client.CloseIdleConnections();
+        CHECK(Get(client, server.Url("/file/small"), response));
+        CHECK(client.GetStats().connectionsOpened == 2);
+
+        // Die schon im Pool liegende Verbindung wird noch benutzt, danach nicht mehr abgelegt
+        client.SetMaxIdlePerHost(0);
+        for (int i = 0; i < 3; ++i) CHECK(Get(client, server.Url("/file/small"), response));
+        CHECK(client.GetStats().connectionsOpened == 4);
+        CHECK(client.GetStats().connectionsReused == 1);
+        CHECK(server.ConnectionsAccepted() == 4);
+    }
+
+    // Requests pro Sekunde mit Pool gegen je eine neue Verbindung
+    void ReportThroughput(int requests) {
+        test::LocalHttpServer server;
+        server.AddFile("small", SMALL_SIZE);
+        if (!server.Start()) return;
+        double seconds[2];
+        for (int pooled = 0; pooled < 2; ++pooled) {
+            net::HttpClient client;
+            client.SetMaxIdlePerHost(pooled ? 4 : 0);
+            test::Stopwatch stopwatch;
+            net::HttpResponse response;
+            for (int i = 0; i < requests; ++i) CHECK(Get(client, server.Url("/file/small"), response));
+            seconds[pooled] = stopwatch.Seconds();
+        }
+        printf("%d Requests: neue Verbindung je Request %.0f/s, Keep-Alive-Pool %.0f/s\n", requests,
+               requests / seconds[0], requests / seconds[1]);
+    }
+}
+
+int main(int argc, char** argv) {
+    CheckSequentialReuse();
+    CheckConcurrentReuse();
+    CheckConnectionLimit();
+    CheckServerClose();
+    CheckIdleControl();
+    ReportThroughput((int)test::NumberOption(argc, argv, "--requests", 500));
+    return test::Result();
+}
+#endif
@@ -0,0 +1,75 @@
+// Durchsatz von ImageResample::Resize (SIMD) gegen ResizeScalar für typische
+// Vorschau-Fälle: Kamerafoto bzw. Thumbnail ins Vorschau-Panel einpassen.
+// --quick: kleine Bilder, wenige Wiederholungen (für ctest).
+#include "util/ImageResample.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using ImageResample::Filter;
+
+struct Case {
+    const char* name;
+    int srcWidth, srcHeight;
+    int boxWidth, boxHeight;
+};
+
+static double MegapixelsPerSecond(bool simd, const std::vector<uint8_t>& src, const Case& c, int dstWidth, int dstHeight,
+                                  Filter filter, int repeats) {
+    std::vector<uint8_t> dst((size_t)dstWidth * dstHeight * 4);
+    auto resize = simd ? ImageResample::Resize : ImageResample::ResizeScalar;
+    test::Stopwatch watch;
+    for (int i = 0; i < repeats; ++i) {
+        resize(src.data(), c.srcWidth, c.srcHeight, (ptrdiff_t)c.srcWidth * 4, dst.data(), dstWidth, dstHeight,
+               (ptrdiff_t)dstWidth * 4, filter);
+    }
+    double seconds = watch.Seconds();
+    // Größeres von Quelle und Ziel zählt (beim Vergrößern dominiert das Ziel)
+    double pixels = std::max((double)c.srcWidth * c.srcHeight, (double)dstWidth * dstHeight);
+    return pixels * repeats / 1e6 / seconds;
+}
+
+int main(int argc, char** argv) {
+#ifdef REQUIRE_AVX2
+    if (!test::CpuHasAvx2()) {
+        printf("CPU ohne AVX2, übersprungen\n");
+        return test::SKIPPED;
+    }
+    const char* kernel = "AVX2";
+#else
+    const char* kernel = "SSE2";
+#endif
+    bool quick = test::HasFlag(argc, argv, "--quick");
+    const Case cases[] = {
+        { "Foto 12 MP -> Panel", 4000, 3000, 380, 430 },
+        { "Foto 2 MP -> Panel", 1920, 1080, 380, 430 },
+        { "Thumbnail -> Panel (vergrößern)", 200, 150, 380, 430 },
+    };
+    const Filter filters[] = { Filter::Box, Filter::Bilinear, Filter::CatmullRom, Filter::Lanczos3 };
+    const char* filterNames[] = { "Box", "Bilinear", "CatmullRom", "Lanczos3" };
+
+    printf("%-34s %-11s %12s %12s %8s\n", "Fall", "Filter", "skalar MP/s", (std::string(kernel) + " MP/s").c_str(), "Faktor");
+    std::mt19937 random(1);
+    for (Case c : cases) {
+        if (quick) {
+            c.srcWidth = c.srcWidth / 4 + 1;
+            c.srcHeight = c.srcHeight / 4 + 1;
+        }
+        std::vector<uint8_t> src((size_t)c.srcWidth * c.srcHeight * 4);
+        for (auto& byte : src) byte = (uint8_t)random();
+        for (size_t i = 3; i < src.size(); i += 4) src[i] = 255;  // Deckend (vormultipliziert)
+
+        int dstWidth, dstHeight;
+        ImageResample::FitSize(c.srcWidth, c.srcHeight, c.boxWidth, c.boxHeight, dstWidth, dstHeight);
+        // Etwa 0,2 s je Messung (quick: ein Bruchteil)
+        int repeats = std::max(1, (int)((quick ? 2e6 : 2e8) / ((double)c.srcWidth * c.srcHeight + (double)dstWidth * dstHeight)));
+        for (int f = 0; f < 4; ++f) {
+            double scalar = MegapixelsPerSecond(false, src, c, dstWidth, dstHeight, filters[f], repeats);
+            double simd = MegapixelsPerSecond(true, src, c, dstWidth, dstHeight, filters[f], repeats);
+            printf("%-34s %-11s %12.1f %12.1f %7.2fx\n", c.name, filterNames[f], scalar, simd, simd / scalar);
+        }
+    }
+    return 0;
+}
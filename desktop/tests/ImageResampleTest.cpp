@@ -0,0 +1,138 @@
+// ImageResample: die SIMD-Kernel (SSE2 bzw. mit REQUIRE_AVX2 die AVX2-Kernel)
+// müssen bitgleich zu ResizeScalar rechnen. Zufällige Größen (Vergrößern und
+// Verkleinern), alle Filter, Zeilenabstände mit Polster und negative Strides
+// (Bottom-up). Dazu Flat-Field: eine einfarbige Fläche bleibt exakt einfarbig.
+#include "util/ImageResample.h"
+#include "TestSupport.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using ImageResample::Filter;
+
+static const Filter FILTERS[] = { Filter::Box, Filter::Bilinear, Filter::CatmullRom, Filter::Lanczos3 };
+static const char* FILTER_NAMES[] = { "Box", "Bilinear", "CatmullRom", "Lanczos3" };
+static const uint8_t PADDING = 0xA5;
+
+// Bild in einem Puffer mit Polster hinter jeder Zeile; bottomUp: erste Zeile
+// liegt am Pufferende, Stride negativ (wie eine DIB)
+struct Image {
+    int width = 0;
+    int height = 0;
+    ptrdiff_t rowBytes = 0;
+    bool bottomUp = false;
+    std::vector<uint8_t> buffer;
+
+    Image(int w, int h, int paddingBytes, bool flip)
+        : width(w), height(h), rowBytes((ptrdiff_t)w * 4 + paddingBytes), bottomUp(flip),
+          buffer((size_t)rowBytes * h, PADDING) {}
+
+    uint8_t* Origin() { return bottomUp ? buffer.data() + rowBytes * (height - 1) : buffer.data(); }
+    ptrdiff_t Stride() const { return bottomUp ? -rowBytes : rowBytes; }
+    uint8_t* Pixel(int x, int y) { return Origin() + Stride() * y + x * 4; }
+};
+
+// Vormultipliziert: Farbe <= Alpha (teils deckend, teils transparent)
+static void FillRandom(Image& image, std::mt19937& random) {
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (int y = 0; y < image.height; ++y) {
+        for (int x = 0; x < image.width; ++x) {
+            uint8_t* pixel = image.Pixel(x, y);
+            int alpha = byte(random) < 96 ? 255 : byte(random);
+            for (int c = 0; c < 3; ++c) pixel[c] = (uint8_t)(byte(random) * alpha / 255);
+            pixel[3] = (uint8_t)alpha;
+        }
+    }
+}
+
+static bool PaddingIntact(Image& image) {
+    for (int y = 0; y < image.height; ++y) {
+        const uint8_t* row = image.Pixel(0, y);
+        for (ptrdiff_t i = (ptrdiff_t)image.width * 4; i < image.rowBytes; ++i) {
+            if (row[i] != PADDING) return false;
+        }
+    }
+    return true;
+}
+
+static void FuzzAgainstScalar(int iterations) {
+    std::mt19937 random(20240611);
+    std::uniform_int_distribution<int> size(1, 160);
+    std::uniform_int_distribution<int> padding(0, 3);
+    std::uniform_int_distribution<int> coin(0, 1);
+
+    for (int i = 0; i < iterations; ++i) {
+        int filterIndex = i % 4;
+        int srcWidth = size(random), srcHeight = size(random);
+        int dstWidth = size(random), dstHeight = size(random);
+        // Jeder 8. Fall: starke Verkleinerung (breite Filterträger)
+        if (i % 8 == 7) {
+            srcWidth *= 8;
+            srcHeight = srcHeight * 4 + 1;
+        }
+        Image src(srcWidth, srcHeight, padding(random) * 4, coin(random) == 1);
+        FillRandom(src, random);
+        bool dstFlip = coin(random) == 1;
+        int dstPadding = padding(random) * 4;
+        Image simd(dstWidth, dstHeight, dstPadding, dstFlip);
+        Image scalar(dstWidth, dstHeight, dstPadding, dstFlip);
+
+        bool okSimd = ImageResample::Resize(src.Origin(), srcWidth, srcHeight, src.Stride(),
+                                            simd.Origin(), dstWidth, dstHeight, simd.Stride(), FILTERS[filterIndex]);
+        bool okScalar = ImageResample::ResizeScalar(src.Origin(), srcWidth, srcHeight, src.Stride(),
+                                                    scalar.Origin(), dstWidth, dstHeight, scalar.Stride(), FILTERS[filterIndex]);
+        CHECK(okSimd && okScalar);
+        CHECK_MSG(simd.buffer == scalar.buffer, "Fall %d: %s %dx%d%s -> %dx%d%s", i, FILTER_NAMES[filterIndex], srcWidth, srcHeight,
+                  src.bottomUp ? " (bottom-up)" : "", dstWidth, dstHeight, dstFlip ? " (bottom-up)" : "");
+        CHECK_MSG(PaddingIntact(simd), "Fall %d: Polster hinter den Zeilen überschrieben", i);
+        if (test::Failures() > 20) return;
+    }
+}
+
+// Einfarbige Fläche: Gewichte summieren sich zu genau 1, auch mit negativen
+// Keulen (Catmull-Rom, Lanczos), also bleibt jedes Pixel unverändert
+static void FlatField() {
+    const uint8_t colors[][4] = { { 0, 0, 0, 0 }, { 255, 255, 255, 255 }, { 17, 128, 200, 255 }, { 40, 10, 90, 128 } };
+    const int sizes[][4] = { { 64, 48, 17, 13 }, { 13, 17, 64, 48 }, { 300, 7, 31, 29 }, { 1, 1, 9, 5 }, { 97, 61, 97, 61 } };
+    for (const auto& color : colors) {
+        for (const auto& s : sizes) {
+            for (int f = 0; f < 4; ++f) {
+                Image src(s[0], s[1], 0, false);
+                for (int y = 0; y < src.height; ++y) {
+                    for (int x = 0; x < src.width; ++x) memcpy(src.Pixel(x, y), color, 4);
+                }
+                for (int scalar = 0; scalar < 2; ++scalar) {
+                    Image dst(s[2], s[3], 0, false);
+                    auto resize = scalar ? ImageResample::ResizeScalar : ImageResample::Resize;
+                    CHECK(resize(src.Origin(), s[0], s[1], src.Stride(), dst.Origin(), s[2], s[3], dst.Stride(), FILTERS[f]));
+                    bool flat = true;
+                    for (int y = 0; y < dst.height && flat; ++y) {
+                        for (int x = 0; x < dst.width && flat; ++x) flat = memcmp(dst.Pixel(x, y), color, 4) == 0;
+                    }
+                    CHECK_MSG(flat, "%s%s %dx%d -> %dx%d, Farbe %d/%d/%d/%d", FILTER_NAMES[f], scalar ? " (skalar)" : "",
+                              s[0], s[1], s[2], s[3], color[0], color[1], color[2], color[3]);
+                }
+            }
+        }
+    }
+}
+
+static void InvalidSizes() {
+    uint8_t pixel[4] = {};
+    CHECK(!ImageResample::Resize(pixel, 0, 1, 4, pixel, 1, 1, 4));
+    CHECK(!ImageResample::Resize(pixel, 1, 1, 4, pixel, 1, -1, 4));
+}
+
+int main(int argc, char** argv) {
+#ifdef REQUIRE_AVX2
+    if (!test::CpuHasAvx2()) {
+        printf("CPU ohne AVX2, übersprungen\n");
+        return test::SKIPPED;
+    }
+#endif
+    int iterations = (int)test::NumberOption(argc, argv, "--iterations", 1500);
+    FuzzAgainstScalar(iterations);
+    FlatField();
+    InvalidSizes();
+    return test::Result();
+}
@@ -0,0 +1,126 @@
+// Listing-Antwort in FileInfo umwandeln: AttachmentJsonParser (Push, 16-KB-Stücke
+// wie vom Socket) gegen den früheren Weg über das nlohmann-DOM.
+//   JsonPushParserBench [--rows=N] [--quick]
+#include "TestSupport.h"
+#include "storage/AttachmentJsonParser.h"
+#include "util/json.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using storagedata::FileInfo;
+
+namespace {
+    // PostgREST-Antwort mit rows Zeilen (Projection::FULL inkl. messages-Join)
+    std::string MakeResponse(size_t rows) {
+        std::mt19937 random(7);
+        auto uuid = [&random]() {
+            char text[40];
+            snprintf(text, sizeof(text), "%08x-%04x-4%03x-8%03x-%08x%04x", (unsigned)random(), (unsigned)random() & 0xFFFF,
+                     (unsigned)random() & 0xFFF, (unsigned)random() & 0xFFF, (unsigned)random(), (unsigned)random() & 0xFFFF);
+            return std::string(text);
+        };
+        static const char* TYPES[] = { "image/jpeg", "audio/wav", "audio/midi", "video/mp4", "application/pdf" };
+
+        std::string out = "[";
+        for (size_t i = 0; i < rows; ++i) {
+            std::string id = uuid(), user = uuid(), message = uuid();
+            char createdAt[40];
+            snprintf(createdAt, sizeof(createdAt), "2024-%02u-%02uT%02u:%02u:%02u.%06u+00:00", 1 + (unsigned)(i % 12),
+                     1 + (unsigned)(i % 28), (unsigned)(i % 24), (unsigned)(i % 60), (unsigned)(i * 7 % 60), (unsigned)random() % 1000000);
+            std::string file = "Aufnahme " + std::to_string(i) + " (Mix \\u00e4).wav";
+            std::string path = user + "/" + message + "/" + std::to_string(i) + ".bin";
+            const char* type = TYPES[i % 5];
+
+            if (i > 0) out += ",";
+            out += "{\"id\":\"" + id + "\",\"created_at\":\"" + createdAt + "\",\"file_name\":\"" + file +
+                   "\",\"file_type\":\"" + type + "\",\"file_size\":" + std::to_string(random() % 200000000) +
+                   ",\"file_url\":\"https://abc.supabase.co/storage/v1/object/public/chat-attachments/" + path + "\"" +
+                   ",\"thumbnail_url\":" +
+                   (i % 5 == 0 ? "\"https://abc.supabase.co/storage/v1/object/public/chat-attachments/" + path + ".thumb.jpg\"" : std::string("null")) +
+                   ",\"messages\":{\"sender_id\":\"" + user + "\"}}";
+        }
+        return out + "]";
+    }
+
+    // Bis zum Umbau in FetchPage: ganze Antwort puffern, DOM bauen, Zeilen umwandeln
+    bool ParseDom(const std::string& response, std::vector<FileInfo>& outFiles) {
+        auto pathOf = [](const std::string& url) { return AttachmentJsonParser::StoragePathFromUrl(url); };
+        try {
+            auto j = nlohmann::json::parse(response);
+            if (!j.is_array()) return false;
+            for (const auto& entry : j) {
+                if (!entry.contains("file_name") || !entry["file_name"].is_string()) continue;
+                FileInfo info;
+                info.id = (entry.contains("id") && !entry["id"].is_null()) ? entry["id"].get<std::string>() : "";
+                info.fileName = entry["file_name"].get<std::string>();
+                info.fileType = (entry.contains("file_type") && !entry["file_type"].is_null()) ? entry["file_type"].get<std::string>() : "unknown";
+                if (entry.contains("file_url") && entry["file_url"].is_string()) info.storagePath = pathOf(entry["file_url"].get<std::string>());
+                if (entry.contains("thumbnail_url") && !entry["thumbnail_url"].is_null()) info.thumbnailPath = pathOf(entry["thumbnail_url"].get<std::string>());
+                info.fileSize = (entry.contains("file_size") && !entry["file_size"].is_null()) ? entry["file_size"].get<long long>() : 0LL;
+                info.createdAt = (entry.contains("created_at") && !entry["created_at"].is_null()) ? entry["created_at"].get<std::string>() : "";
+                if (entry.contains("messages") && entry["messages"].is_object()) {
+                    const auto& message = entry["messages"];
+                    if (message.contains("sender_id") && message["sender_id"].is_string()) info.senderId = message["sender_id"].get<std::string>();
+                }
+                outFiles.push_back(info);
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+        return true;
+    }
+
+    bool ParsePush(const std::string& response, std::vector<FileInfo>& outFiles) {
+        const size_t CHUNK = 16 * 1024;
+        AttachmentJsonParser parser(false, outFiles);
+        for (size_t offset = 0; offset < response.size(); offset += CHUNK) {
+            if (!parser.Feed(response.data() + offset, std::min(CHUNK, response.size() - offset))) return false;
+        }
+        return parser.Finish();
+    }
+
+    bool Same(const FileInfo& a, const FileInfo& b) {
+        return a.id == b.id && a.fileName == b.fileName && a.fileType == b.fileType && a.storagePath == b.storagePath &&
+               a.thumbnailPath == b.thumbnailPath && a.fileSize == b.fileSize && a.createdAt == b.createdAt && a.senderId == b.senderId;
+    }
+
+    // Beste von runs Messungen in Sekunden
+    template <typename Parse>
+    double Measure(const std::string& response, int runs, Parse parse, std::vector<FileInfo>& outFiles) {
+        double best = 1e30;
+        for (int i = 0; i < runs; ++i) {
+            outFiles.clear();
+            test::Stopwatch stopwatch;
+            bool ok = parse(response, outFiles);
+            best = std::min(best, stopwatch.Seconds());
+            CHECK(ok);
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool quick = test::HasFlag(argc, argv, "--quick");
+    size_t rows = (size_t)test::NumberOption(argc, argv, "--rows", quick ? 2000 : 50000);
+    int runs = quick ? 2 : 5;
+
+    std::string response = MakeResponse(rows);
+    std::vector<FileInfo> dom, push;
+    double domSeconds = Measure(response, runs, ParseDom, dom);
+    double pushSeconds = Measure(response, runs, ParsePush, push);
+
+    // Beide Wege liefern dieselben Zeilen
+    CHECK(dom.size() == rows);
+    CHECK(push.size() == dom.size());
+    for (size_t i = 0; i < std::min(dom.size(), push.size()); ++i) {
+        CHECK_MSG(Same(dom[i], push[i]), "Zeile %zu", i);
+    }
+
+    double megabytes = response.size() / (1024.0 * 1024.0);
+    printf("%zu Zeilen, %.1f MB\n", rows, megabytes);
+    printf("DOM (nlohmann::json::parse)   %8.2f ms  %7.1f MB/s\n", domSeconds * 1000, megabytes / domSeconds);
+    printf("Push (AttachmentJsonParser)   %8.2f ms  %7.1f MB/s  (%.2fx)\n", pushSeconds * 1000, megabytes / pushSeconds, domSeconds / pushSeconds);
+    return test::Result();
+}
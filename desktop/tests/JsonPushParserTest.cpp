@@ -0,0 +1,231 @@
+// JsonPushParser gegen nlohmann::json::sax_parse: gleiche Events bei jeder
+// Aufteilung der Eingabe (am Stück, Byte für Byte, zufällig), gleiche Fehler.
+//   JsonPushParserTest [--iterations=N] [--seed=N]
+#include "TestSupport.h"
+#include "util/JsonPushParser.h"
+#include "util/json.hpp"
+#include <climits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string FormatFloat(double value) {
+        char text[64];
+        snprintf(text, sizeof(text), "f:%.17g", value);
+        return text;
+    }
+
+    // Events als Text, damit sich beide Parser direkt vergleichen lassen
+    class PushRecorder : public JsonPushParser::Handler {
+    public:
+        std::vector<std::string> events;
+
+        bool StartObject() override { events.push_back("{"); return true; }
+        bool EndObject() override { events.push_back("}"); return true; }
+        bool StartArray() override { events.push_back("["); return true; }
+        bool EndArray() override { events.push_back("]"); return true; }
+        bool Key(std::string& key) override { events.push_back("k:" + key); return true; }
+        bool String(std::string& value) override { events.push_back("s:" + value); return true; }
+        bool Integer(long long value) override { events.push_back("i:" + std::to_string(value)); return true; }
+        bool Float(double value) override { events.push_back(FormatFloat(value)); return true; }
+        bool Bool(bool value) override { events.push_back(value ? "b:1" : "b:0"); return true; }
+        bool Null() override { events.push_back("n"); return true; }
+    };
+
+    class DomRecorder : public nlohmann::json_sax<nlohmann::json> {
+    public:
+        std::vector<std::string> events;
+
+        bool null() override { events.push_back("n"); return true; }
+        bool boolean(bool value) override { events.push_back(value ? "b:1" : "b:0"); return true; }
+        bool number_integer(number_integer_t value) override { events.push_back("i:" + std::to_string(value)); return true; }
+        bool number_unsigned(number_unsigned_t value) override {
+            // JsonPushParser liefert über LLONG_MAX eine Gleitkommazahl
+            if (value <= (number_unsigned_t)LLONG_MAX) events.push_back("i:" + std::to_string(value));
+            else events.push_back(FormatFloat((double)value));
+            return true;
+        }
+        bool number_float(number_float_t value, const string_t&) override { events.push_back(FormatFloat(value)); return true; }
+        bool string(string_t& value) override { events.push_back("s:" + value); return true; }
+        bool binary(binary_t&) override { return false; }
+        bool start_object(std::size_t) override { events.push_back("{"); return true; }
+        bool key(string_t& value) override { events.push_back("k:" + value); return true; }
+        bool end_object() override { events.push_back("}"); return true; }
+        bool start_array(std::size_t) override { events.push_back("["); return true; }
+        bool end_array() override { events.push_back("]"); return true; }
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override { return false; }
+    };
+
+    // Referenz: false bei Syntaxfehler
+    bool ParseReference(const std::string& json, std::vector<std::string>& events) {
+        DomRecorder recorder;
+        bool ok = nlohmann::json::sax_parse(json, &recorder);
+        events = std::move(recorder.events);
+        return ok;
+    }
+
+    // Feed in Stücken der Längen aus cuts (zyklisch), dann Finish
+    bool ParsePush(const std::string& json, const std::vector<size_t>& cuts, std::vector<std::string>& events) {
+        PushRecorder recorder;
+        JsonPushParser parser(recorder);
+        bool ok = true;
+        size_t offset = 0;
+        for (size_t i = 0; ok && offset < json.size(); ++i) {
+            size_t length = cuts.empty() ? json.size() : cuts[i % cuts.size()];
+            if (length > json.size() - offset) length = json.size() - offset;
+            ok = parser.Feed(json.data() + offset, length);
+            offset += length;
+        }
+        ok = ok && parser.Finish();
+        events = std::move(recorder.events);
+        return ok;
+    }
+
+    // Vergleicht alle Aufteilungen mit der Referenz; Events nur bei gültiger Eingabe
+    void CheckSame(const std::string& json, std::mt19937& random) {
+        std::vector<std::string> expected;
+        bool expectedOk = ParseReference(json, expected);
+
+        std::vector<size_t> randomCuts;
+        for (int i = 0; i < 8; ++i) randomCuts.push_back(1 + random() % 7);
+        const std::vector<size_t> splits[] = { {}, { 1 }, randomCuts };
+        const char* names[] = { "am Stück", "1 Byte", "zufällig" };
+
+        for (int s = 0; s < 3; ++s) {
+            std::vector<std::string> events;
+            bool ok = ParsePush(json, splits[s], events);
+            CHECK_MSG(ok == expectedOk, "%s: %s erwartet bei %s", names[s], expectedOk ? "gültig" : "Fehler", json.c_str());
+            if (ok && expectedOk) {
+                CHECK_MSG(events == expected, "%s: andere Events bei %s", names[s], json.c_str());
+            }
+        }
+    }
+
+    void AppendUtf8(std::string& out, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            out += (char)codePoint;
+        } else if (codePoint < 0x800) {
+            out += (char)(0xC0 | (codePoint >> 6));
+            out += (char)(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            out += (char)(0xE0 | (codePoint >> 12));
+            out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            out += (char)(0x80 | (codePoint & 0x3F));
+        } else {
+            out += (char)(0xF0 | (codePoint >> 18));
+            out += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+            out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            out += (char)(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    std::string RandomString(std::mt19937& random) {
+        static const char* ESCAPES[] = { "\\\"", "\\\\", "\\/", "\\b", "\\f", "\\n", "\\r", "\\t", "\\u0000", "\\u00e4", "\\u20AC", "\\ud83d\\ude00" };
+        std::string out = "\"";
+        int length = random() % 12;
+        for (int i = 0; i < length; ++i) {
+            switch (random() % 4) {
+                case 0: out += ESCAPES[random() % (sizeof(ESCAPES) / sizeof(ESCAPES[0]))]; break;
+                case 1: AppendUtf8(out, 0xA0 + random() % 0x1F000); break;
+                default: out += (char)('a' + random() % 26); break;
+            }
+        }
+        // Surrogat-Bereich ist in UTF-8 ungültig
+        for (size_t i = 0; i + 2 < out.size(); ++i) {
+            if ((unsigned char)out[i] == 0xED && (unsigned char)out[i + 1] >= 0xA0) out[i + 1] = (char)0x9F;
+        }
+        return out + "\"";
+    }
+
+    std::string RandomNumber(std::mt19937& random) {
+        static const char* SPECIAL[] = { "0", "-0", "9223372036854775807", "-9223372036854775808", "9223372036854775808",
+                                         "18446744073709551615", "18446744073709551616", "-9223372036854775809",
+                                         "1e308", "2.2250738585072014e-308", "0.1", "-0.0", "1E+2", "1e-2" };
+        if (random() % 4 == 0) return SPECIAL[random() % (sizeof(SPECIAL) / sizeof(SPECIAL[0]))];
+
+        std::string out;
+        if (random() % 2) out += '-';
+        int digits = 1 + random() % 19;
+        out += random() % 5 == 0 ? '0' : (char)('1' + random() % 9);
+        if (out.back() != '0') {
+            for (int i = 1; i < digits; ++i) out += (char)('0' + random() % 10);
+        }
+        if (random() % 3 == 0) {
+            out += '.';
+            int fraction = 1 + random() % 10;
+            for (int i = 0; i < fraction; ++i) out += (char)('0' + random() % 10);
+        }
+        if (random() % 4 == 0) {
+            out += random() % 2 ? 'e' : 'E';
+            if (random() % 2) out += random() % 2 ? '+' : '-';
+            out += std::to_string(random() % 300);
+        }
+        return out;
+    }
+
+    std::string Whitespace(std::mt19937& random) {
+        static const char* SPACES[] = { "", "", "", " ", "\n", "\t", "\r\n  " };
+        return SPACES[random() % (sizeof(SPACES) / sizeof(SPACES[0]))];
+    }
+
+    std::string RandomValue(std::mt19937& random, int depth) {
+        int kind = random() % (depth < 5 ? 8 : 6);
+        switch (kind) {
+            case 0: return "null";
+            case 1: return random() % 2 ? "true" : "false";
+            case 2: case 3: return RandomNumber(random);
+            case 4: case 5: return RandomString(random);
+            case 6: {
+                std::string out = "[" + Whitespace(random);
+                int count = random() % 5;
+                for (int i = 0; i < count; ++i) {
+                    if (i > 0) out += "," + Whitespace(random);
+                    out += RandomValue(random, depth + 1) + Whitespace(random);
+                }
+                return out + "]";
+            }
+            default: {
+                std::string out = "{" + Whitespace(random);
+                int count = random() % 5;
+                for (int i = 0; i < count; ++i) {
+                    if (i > 0) out += "," + Whitespace(random);
+                    out += RandomString(random) + Whitespace(random) + ":" + Whitespace(random);
+                    out += RandomValue(random, depth + 1) + Whitespace(random);
+                }
+                return out + "}";
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    long long iterations = test::NumberOption(argc, argv, "--iterations", 20000);
+    std::mt19937 random((unsigned)test::NumberOption(argc, argv, "--seed", 2024));
+
+    // Feste Dokumente, u.a. eine PostgREST-Antwort wie von FetchPage
+    const char* documents[] = {
+        "[]", "{}", "0", "-12", "3.5e-3", "\"x\"", "true", "null", " [ 1 , [ ] , { } ] ",
+        "{\"a\":{\"b\":[1,2,{\"c\":null}]},\"d\":\"\\u00fc\\ud834\\udd1e\"}",
+        "[{\"id\":\"0b7c6d2e-4f9e-4a8e-9c55-1f2a3b4c5d6e\",\"created_at\":\"2024-05-01T12:30:45.123456+00:00\","
+        "\"file_name\":\"Take 3 (final).wav\",\"file_type\":\"audio/wav\",\"file_size\":48211234,"
+        "\"file_url\":\"https://x.supabase.co/storage/v1/object/public/chat-attachments/u/m/take3.wav\","
+        "\"thumbnail_url\":null,\"messages\":{\"sender_id\":\"9f8e7d6c-0000-4000-8000-123456789abc\"}}]",
+    };
+    for (const char* document : documents) CheckSame(document, random);
+
+    // Zahlen außerhalb der JSON-Grammatik lehnen beide ab, auch als Teil eines Arrays
+    const char* invalid[] = {
+        "01", "-01", "00", "1.", "-", "1e", "1e+", "+1", ".5", "1.e5", "-.5", "0x10", "1..2", "1e5.0", "--1",
+        "[01]", "[1.]", "[-]", "{\"a\":1.}", "[1,]", "{\"a\" 1}", "[1 2]", "\"abc", "tru", "[1]]", "", "1e400", "[-1e400]",
+    };
+    for (const char* json : invalid) {
+        std::vector<std::string> events;
+        CHECK_MSG(!ParseReference(json, events), "Referenz akzeptiert %s", json);
+        CHECK_MSG(!ParsePush(json, {}, events), "akzeptiert %s", json);
+        CHECK_MSG(!ParsePush(json, { 1 }, events), "akzeptiert %s (1 Byte)", json);
+    }
+
+    for (long long i = 0; i < iterations; ++i) CheckSame(RandomValue(random, 0), random);
+    return test::Result();
+}
@@ -0,0 +1,311 @@
+#pragma once
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// HTTP/1.1-Server im Testprozess (127.0.0.1, freier Port) für die Tests des
+// Socket-Backends und des FileDownloader. Liefert unter /file/<Name> erzeugte
+// Inhalte beliebiger Größe (nichts davon liegt im Speicher) mit ETag, Range
+// und If-Range. Ein Thread pro Verbindung, Keep-Alive wie ein echter Server.
+namespace test {
+    class LocalHttpServer {
+    public:
+        struct Options {
+            std::chrono::milliseconds latency{0};   // Wartezeit vor jeder Antwort (simuliert die Round-Trip-Zeit)
+            uint64_t bytesPerSecond = 0;            // Obergrenze je Verbindung, 0 = unbegrenzt
+            std::chrono::milliseconds idleTimeout{0}; // Keep-Alive-Verbindung danach still schließen, 0 = nie
+            int requestsPerConnection = 0;          // Danach "Connection: close", 0 = unbegrenzt
+            bool ranges = true;                     // false: Range-Header ignorieren (immer 200)
+        };
+
+        // Byte an Position offset jedes erzeugten Inhalts (pseudozufällig, aber reproduzierbar)
+        static unsigned char ContentByte(uint64_t offset) {
+            uint64_t word = Mix(offset >> 3);
+            return (unsigned char)(word >> ((offset & 7) * 8));
+        }
+
+        // Inhalt ab offset (count Bytes), ein Mix pro 8 Byte
+        static void FillContent(uint64_t offset, unsigned char* out, size_t count) {
+            size_t i = 0;
+            for (; i < count && ((offset + i) & 7) != 0; ++i) out[i] = ContentByte(offset + i);
+            for (; i + 8 <= count; i += 8) {
+                uint64_t word = Mix((offset + i) >> 3);
+                for (int b = 0; b < 8; ++b) out[i + b] = (unsigned char)(word >> (b * 8));
+            }
+            for (; i < count; ++i) out[i] = ContentByte(offset + i);
+        }
+
+        LocalHttpServer() {}
+        explicit LocalHttpServer(const Options& options) : options_(options) {}
+        ~LocalHttpServer() { Stop(); }
+        LocalHttpServer(const LocalHttpServer&) = delete;
+        LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+
+        // Inhalt unter /file/<name> mit size Bytes; etag leer = ohne ETag (kein If-Range möglich)
+        void AddFile(const std::string& name, uint64_t size, const std::string& etag = "\"test-etag\"") {
+            std::lock_guard<std::mutex> lock(mutex_);
+            files_[name] = File{ size, etag };
+        }
+
+        bool Start() {
+            listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+            if (listenFd_ < 0) return false;
+            int one = 1;
+            setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = 0;
+            socklen_t length = sizeof(address);
+            if (bind(listenFd_, (sockaddr*)&address, sizeof(address)) != 0 || listen(listenFd_, 64) != 0 ||
+                getsockname(listenFd_, (sockaddr*)&address, &length) != 0) {
+                close(listenFd_);
+                listenFd_ = -1;
+                return false;
+            }
+            port_ = ntohs(address.sin_port);
+            acceptThread_ = std::thread([this] { AcceptLoop(); });
+            return true;
+        }
+
+        void Stop() {
+            if (listenFd_ < 0) return;
+            stop_ = true;
+            acceptThread_.join();
+            close(listenFd_);
+            listenFd_ = -1;
+            {
+                // Blockierte send/recv der Verbindungs-Threads aufwecken
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (int fd : openFds_) shutdown(fd, SHUT_RDWR);
+            }
+            for (auto& thread : connectionThreads_) thread.join();
+            connectionThreads_.clear();
+        }
+
+        std::string Url(const std::string& path) const {
+            return "http://127.0.0.1:" + std::to_string(port_) + path;
+        }
+
+        // Schließt alle Keep-Alive-Verbindungen serverseitig (wie ein Server-Neustart)
+        void DropConnections() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int fd : openFds_) shutdown(fd, SHUT_RDWR);
+        }
+
+        size_t ConnectionsAccepted() const { return accepted_; }
+        size_t Requests() const { return requests_; }
+        size_t MaxOpenConnections() const { return maxOpen_; }
+        uint64_t BytesSent() const { return bytesSent_; }
+
+    private:
+        struct File {
+            uint64_t size = 0;
+            std::string etag;
+        };
+
+        static uint64_t Mix(uint64_t x) {
+            x += 0x9E3779B97F4A7C15ULL;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            return x ^ (x >> 31);
+        }
+
+        void AcceptLoop() {
+            while (!stop_) {
+                pollfd pending = {};
+                pending.fd = listenFd_;
+                pending.events = POLLIN;
+                if (poll(&pending, 1, 50) != 1) continue;
+                int fd = accept(listenFd_, nullptr, nullptr);
+                if (fd < 0) continue;
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                ++accepted_;
+                std::lock_guard<std::mutex> lock(mutex_);
+                openFds_.insert(fd);
+                maxOpen_ = std::max(maxOpen_.load(), openFds_.size());
+                connectionThreads_.emplace_back([this, fd] { Serve(fd); });
+            }
+        }
+
+        void Serve(int fd) {
+            std::string buffer;
+            int served = 0;
+            while (!stop_) {
+                size_t headEnd;
+                while ((headEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                    if (options_.idleTimeout.count() > 0 && buffer.empty()) {
+                        pollfd pending = {};
+                        pending.fd = fd;
+                        pending.events = POLLIN;
+                        if (poll(&pending, 1, (int)options_.idleTimeout.count()) != 1) break;
+                    }
+                    char chunk[4096];
+                    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                    if (n <= 0) break;
+                    buffer.append(chunk, (size_t)n);
+                }
+                if (headEnd == std::string::npos) break;
+
+                std::string head = buffer.substr(0, headEnd);
+                buffer.erase(0, headEnd + 4);
+                // Request-Body (falls vorhanden) lesen und verwerfen
+                size_t bodyLength = (size_t)std::strtoull(Header(head, "content-length").c_str(), nullptr, 10);
+                while (buffer.size() < bodyLength) {
+                    char chunk[4096];
+                    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                    if (n <= 0) break;
+                    buffer.append(chunk, (size_t)n);
+                }
+                if (buffer.size() < bodyLength) break;
+                buffer.erase(0, bodyLength);
+
+                ++requests_;
+                ++served;
+                bool close = (options_.requestsPerConnection > 0 && served >= options_.requestsPerConnection) ||
+                             Lower(Header(head, "connection")) == "close";
+                if (options_.latency.count() > 0) std::this_thread::sleep_for(options_.latency);
+                if (!Respond(fd, head, close) || close) break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                openFds_.erase(fd);
+            }
+            ::close(fd);
+        }
+
+        bool Respond(int fd, const std::string& head, bool close) {
+            std::string method = head.substr(0, head.find(' '));
+            size_t pathStart = head.find(' ') + 1;
+            std::string path = head.substr(pathStart, head.find(' ', pathStart) - pathStart);
+            path = path.substr(0, path.find('?'));
+
+            File file;
+            bool found = false;
+            if (path.compare(0, 6, "/file/") == 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = files_.find(path.substr(6));
+                if (it != files_.end()) {
+                    file = it->second;
+                    found = true;
+                }
+            }
+            std::string connection = close ? "Connection: close\r\n" : "";
+            if (!found) {
+                return SendAll(fd, "HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n" + connection + "\r\nnot found");
+            }
+
+            uint64_t start = 0, end = file.size;   // [start, end)
+            bool partial = false;
+            std::string range = Header(head, "range");
+            std::string ifRange = Header(head, "if-range");
+            if (options_.ranges && range.compare(0, 6, "bytes=") == 0 && (ifRange.empty() || ifRange == file.etag)) {
+                char* rest = nullptr;
+                start = std::strtoull(range.c_str() + 6, &rest, 10);
+                if (rest && *rest == '-' && rest[1] != '\0') end = std::min<uint64_t>(std::strtoull(rest + 1, nullptr, 10) + 1, file.size);
+                if (start >= file.size || start >= end) {
+                    return SendAll(fd, "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */" + std::to_string(file.size) +
+                                       "\r\nContent-Length: 0\r\n" + connection + "\r\n");
+                }
+                partial = true;
+            }
+
+            std::string response = partial ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+            response += "Content-Type: application/octet-stream\r\n";
+            response += "Content-Length: " + std::to_string(end - start) + "\r\n";
+            if (partial) {
+                response += "Content-Range: bytes " + std::to_string(start) + "-" + std::to_string(end - 1) + "/" + std::to_string(file.size) + "\r\n";
+            }
+            if (!file.etag.empty()) response += "ETag: " + file.etag + "\r\n";
+            if (options_.ranges) response += "Accept-Ranges: bytes\r\n";
+            response += connection + "\r\n";
+            if (!SendAll(fd, response)) return false;
+            if (method == "HEAD") return true;
+
+            // Body in Stücken erzeugen; mit bytesPerSecond gedrosselt
+            unsigned char chunk[65536];
+            auto begin = std::chrono::steady_clock::now();
+            uint64_t sent = 0;
+            for (uint64_t offset = start; offset < end;) {
+                size_t count = (size_t)std::min<uint64_t>(sizeof(chunk), end - offset);
+                FillContent(offset, chunk, count);
+                if (!SendAll(fd, (const char*)chunk, count)) return false;
+                offset += count;
+                sent += count;
+                if (options_.bytesPerSecond > 0) {
+                    auto due = begin + std::chrono::microseconds(sent * 1000000 / options_.bytesPerSecond);
+                    std::this_thread::sleep_until(due);
+                }
+            }
+            return true;
+        }
+
+        bool SendAll(int fd, const std::string& data) { return SendAll(fd, data.data(), data.size()); }
+
+        bool SendAll(int fd, const char* data, size_t size) {
+            size_t sent = 0;
+            while (sent < size) {
+                ssize_t n = send(fd, data + sent, size - sent, MSG_NOSIGNAL);
+                if (n <= 0) return false;
+                sent += (size_t)n;
+                bytesSent_ += (uint64_t)n;
+            }
+            return true;
+        }
+
+        static std::string Lower(std::string text) {
+            for (char& c : text) c = (char)std::tolower((unsigned char)c);
+            return text;
+        }
+
+        // Wert des Headers name (klein geschrieben) aus dem Request-Kopf, sonst ""
+        static std::string Header(const std::string& head, const std::string& name) {
+            size_t pos = head.find("\r\n");
+            while (pos != std::string::npos) {
+                size_t lineStart = pos + 2;
+                size_t lineEnd = head.find("\r\n", lineStart);
+                std::string line = head.substr(lineStart, lineEnd == std::string::npos ? std::string::npos : lineEnd - lineStart);
+                size_t colon = line.find(':');
+                if (colon != std::string::npos && Lower(line.substr(0, colon)) == name) {
+                    size_t valueStart = line.find_first_not_of(" \t", colon + 1);
+                    return valueStart == std::string::npos ? "" : line.substr(valueStart);
+                }
+                pos = lineEnd;
+            }
+            return "";
+        }
+
+        Options options_;
+        int listenFd_ = -1;
+        uint16_t port_ = 0;
+        std::atomic<bool> stop_{false};
+        std::thread acceptThread_;
+        std::vector<std::thread> connectionThreads_;   // Nur der Accept-Thread fügt hinzu
+        std::mutex mutex_;
+        std::map<std::string, File> files_;
+        std::set<int> openFds_;
+        std::atomic<size_t> accepted_{0};
+        std::atomic<size_t> requests_{0};
+        std::atomic<size_t> maxOpen_{0};
+        std::atomic<uint64_t> bytesSent_{0};
+    };
+}
+#endif
@@ -0,0 +1,115 @@
+// FileDownloader segmentiert gegen einen Stream, über eine simulierte langsame
+// Strecke: LocalHttpServer wartet vor jeder Antwort (Round-Trip) und drosselt
+// jede Verbindung (wie ein einzelner TCP-Stream mit hoher Latenz). Mehrere
+// HTTP/1.1-Verbindungen holen dann die Stücke parallel.
+//   SegmentedDownloadBench [--size=MB] [--latency=ms] [--rate=MB/s je Verbindung] [--quick]
+#include "TestSupport.h"
+#ifdef _WIN32
+int main() {
+    printf("Übersprungen: LocalHttpServer gibt es nur mit POSIX-Sockets\n");
+    return test::SKIPPED;
+}
+#else
+#include "LocalHttpServer.h"
+#include "net/HttpClient.h"
+#include "storage/FileDownloader.h"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    bool SameContent(const fs::path& path, uint64_t size) {
+        std::error_code error;
+        if (fs::file_size(path, error) != size || error) return false;
+        std::ifstream file(path, std::ios::binary);
+        std::vector<unsigned char> actual(1 << 20), expected(1 << 20);
+        for (uint64_t offset = 0; offset < size;) {
+            size_t count = (size_t)std::min<uint64_t>(actual.size(), size - offset);
+            if (!file.read((char*)actual.data(), (std::streamsize)count)) return false;
+            test::LocalHttpServer::FillContent(offset, expected.data(), count);
+            if (memcmp(actual.data(), expected.data(), count) != 0) return false;
+            offset += count;
+        }
+        return true;
+    }
+
+    struct Result {
+        double seconds = 0;
+        size_t connections = 0;
+        size_t requests = 0;
+    };
+
+    // Eigener Server je Lauf, damit Verbindungen und Requests nur diesen Download zählen
+    Result Run(const test::LocalHttpServer::Options& serverOptions, uint64_t size, const FileDownloader::Options& options,
+               const fs::path& target) {
+        test::LocalHttpServer server(serverOptions);
+        server.AddFile("take.wav", size);
+        Result result;
+        if (!server.Start()) {
+            CHECK_MSG(false, "Server startet nicht");
+            return result;
+        }
+        std::error_code error;
+        fs::remove(target, error);
+        std::string err;
+        test::Stopwatch stopwatch;
+        bool ok = FileDownloader::Download(server.Url("/file/take.wav"), target, options, &err);
+        result.seconds = stopwatch.Seconds();
+        CHECK_MSG(ok, "%s", err.c_str());
+        CHECK_MSG(ok && SameContent(target, size), "Inhalt weicht ab (%d Segmente)", options.maxSegments);
+        // Ohne Wettlauf mit dem Client nachzählen (er hat die Verbindungen noch im Pool)
+        result.connections = server.ConnectionsAccepted();
+        result.requests = server.Requests();
+        fs::remove(target, error);
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool quick = test::HasFlag(argc, argv, "--quick");
+    uint64_t size = (uint64_t)test::NumberOption(argc, argv, "--size", quick ? 24 : 96) << 20;
+    test::LocalHttpServer::Options serverOptions;
+    serverOptions.latency = std::chrono::milliseconds(test::NumberOption(argc, argv, "--latency", 40));
+    serverOptions.bytesPerSecond = (uint64_t)test::NumberOption(argc, argv, "--rate", quick ? 8 : 12) << 20;
+
+    FileDownloader::Options options;
+    options.retryDelay = std::chrono::milliseconds(10);
+    if (quick) {
+        // Kleinere Stücke, damit auch die kurze Datei genug Bereiche zum Verteilen hat
+        options.segmentThreshold = 4ULL << 20;
+        options.segmentSize = 1ULL << 20;
+    }
+
+    // Die Verbindungen gehen an den gemeinsamen Client; frisch starten
+    net::HttpClient::Instance().CloseIdleConnections();
+    fs::path target = fs::temp_directory_path() / ("SegmentedDownloadBench-" + std::to_string(getpid()) + ".bin");
+
+    FileDownloader::Options single = options;
+    single.maxSegments = 1;
+    Result one = Run(serverOptions, size, single, target);
+    net::HttpClient::Instance().CloseIdleConnections();
+    Result many = Run(serverOptions, size, options, target);
+    net::HttpClient::Instance().CloseIdleConnections();
+
+    // Ein Stream: eine Verbindung. Segmentiert: höchstens maxSegments Verbindungen
+    // (+1 für den ersten Bereich), jede holt über Keep-Alive mehrere Stücke.
+    CHECK(one.connections == 1 && one.requests == 1);
+    CHECK(many.connections >= 2 && many.connections <= (size_t)options.maxSegments + 1);
+    CHECK(many.requests > many.connections);
+    // Gedrosselt pro Verbindung muss die Parallelität den Download deutlich beschleunigen;
+    // die Verbindungen kommen erst nach und nach dazu (ADAPT_INTERVAL), daher kein Faktor 6
+    CHECK_MSG(one.seconds > many.seconds * 1.3, "ein Stream %.2f s, segmentiert %.2f s", one.seconds, many.seconds);
+
+    double megabytes = size / 1048576.0;
+    printf("%.0f MB, Latenz %lld ms, %.1f MB/s je Verbindung\n", megabytes, (long long)serverOptions.latency.count(),
+           serverOptions.bytesPerSecond / 1048576.0);
+    printf("ein Stream   %6.2f s  %6.1f MB/s  %zu Verbindung, %zu Request\n", one.seconds, megabytes / one.seconds,
+           one.connections, one.requests);
+    printf("segmentiert  %6.2f s  %6.1f MB/s  %zu Verbindungen, %zu Requests  (%.1fx)\n", many.seconds,
+           megabytes / many.seconds, many.connections, many.requests, one.seconds / many.seconds);
+    return test::Result();
+}
+#endif
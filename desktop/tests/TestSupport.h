@@ -0,0 +1,113 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+// Minimale Hilfen für Tests und Benchmarks unter tests/ (ohne Framework).
+// CHECK zählt Fehler und läuft weiter; main endet mit "return test::Result();".
+namespace test {
+    const int SKIPPED = 77;  // Exit-Code für ctest (SKIP_RETURN_CODE)
+
+    inline int& Failures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline int Result() {
+        if (Failures() == 0) {
+            printf("OK\n");
+            return 0;
+        }
+        fprintf(stderr, "%d Fehler\n", Failures());
+        return 1;
+    }
+
+    // "--name" gesetzt?
+    inline bool HasFlag(int argc, char** argv, const char* name) {
+        for (int i = 1; i < argc; ++i) {
+            if (strcmp(argv[i], name) == 0) return true;
+        }
+        return false;
+    }
+
+    // Wert von "--name=wert", sonst fallback
+    inline std::string Option(int argc, char** argv, const char* name, const std::string& fallback = "") {
+        size_t length = strlen(name);
+        for (int i = 1; i < argc; ++i) {
+            if (strncmp(argv[i], name, length) == 0 && argv[i][length] == '=') return argv[i] + length + 1;
+        }
+        return fallback;
+    }
+
+    inline long long NumberOption(int argc, char** argv, const char* name, long long fallback) {
+        std::string value = Option(argc, argv, name);
+        return value.empty() ? fallback : std::strtoll(value.c_str(), nullptr, 10);
+    }
+
+    // Unterstützt CPU und Betriebssystem AVX2? (Tests der -mavx2-Varianten überspringen sonst)
+    inline bool CpuHasAvx2() {
+#if defined(__GNUC__)
+        return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        bool osSaves = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return osSaves && (info[1] & (1 << 5));
+#else
+        return false;
+#endif
+    }
+
+    // Belegter physischer Speicher des Prozesses (VmRSS), 0 = unbekannt (nur Linux)
+    inline size_t ResidentBytes() {
+        size_t bytes = 0;
+#if defined(__linux__)
+        if (FILE* file = fopen("/proc/self/status", "r")) {
+            char line[256];
+            while (fgets(line, sizeof(line), file)) {
+                if (strncmp(line, "VmRSS:", 6) == 0) {
+                    bytes = (size_t)std::strtoull(line + 6, nullptr, 10) * 1024;
+                    break;
+                }
+            }
+            fclose(file);
+        }
+#endif
+        return bytes;
+    }
+
+    class Stopwatch {
+    public:
+        Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+        double Seconds() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count(); }
+
+    private:
+        std::chrono::steady_clock::time_point start_;
+    };
+}
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            ++test::Failures();                                                           \
+            fprintf(stderr, "%s:%d: CHECK(%s) fehlgeschlagen\n", __FILE__, __LINE__, #condition); \
+        }                                                                                 \
+    } while (0)
+
+// Wie CHECK, mit printf-Meldung zum Fall (z.B. Eingabe des Fuzz-Durchlaufs)
+#define CHECK_MSG(condition, ...)                                                         \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            ++test::Failures();                                                           \
+            fprintf(stderr, "%s:%d: CHECK(%s) fehlgeschlagen: ", __FILE__, __LINE__, #condition); \
+            fprintf(stderr, __VA_ARGS__);                                                 \
+            fprintf(stderr, "\n");                                                        \
+        }                                                                                 \
+    } while (0)